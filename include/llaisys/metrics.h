@@ -0,0 +1,64 @@
+#ifndef LLAISYS_METRICS_H
+#define LLAISYS_METRICS_H
+
+#include "../llaisys.h"
+
+__C {
+    // Ops, as counted by the metrics
+    typedef enum {
+        LLAISYS_OP_ADD = 0,
+        LLAISYS_OP_ARGMAX = 1,
+        LLAISYS_OP_EMBEDDING = 2,
+        LLAISYS_OP_LINEAR = 3,
+        LLAISYS_OP_LINEAR_ARGMAX = 4,
+        LLAISYS_OP_PAGED_ATTENTION = 5,
+        LLAISYS_OP_REARRANGE = 6,
+        LLAISYS_OP_RMS_NORM = 7,
+        LLAISYS_OP_ROPE = 8,
+        LLAISYS_OP_SAMPLE = 9,
+        LLAISYS_OP_SELECT_ROWS = 10,
+        LLAISYS_OP_SELF_ATTENTION = 11,
+        LLAISYS_OP_SWIGLU = 12,
+        LLAISYS_OP_COUNT
+    } llaisysOpType_t;
+
+#define LLAISYS_LATENCY_BUCKETS 28
+#define LLAISYS_METRICS_MAX_LAYERS 128
+
+    // Durations of bucket i: up to 1 us for i = 0, then (2^(i-1), 2^i] us, with the last
+    // bucket holding everything longer.
+    struct LlaisysLatencyHistogram {
+        uint64_t count;
+        uint64_t sum_ns;
+        uint64_t buckets[LLAISYS_LATENCY_BUCKETS];
+    };
+
+    // Process-wide performance metrics. They are always collected, with a few atomic
+    // additions per op call, layer and token.
+    struct LlaisysMetrics {
+        struct LlaisysLatencyHistogram ops[LLAISYS_OP_COUNT];
+        // Decoder layer i of every forward pass (deeper layers are counted under the last).
+        struct LlaisysLatencyHistogram layers[LLAISYS_METRICS_MAX_LAYERS];
+        // Forward passes: decode passes bring one token per sequence, prefill passes
+        // (including batches mixing both) more. Their tokens are counted accordingly.
+        struct LlaisysLatencyHistogram prefill;
+        struct LlaisysLatencyHistogram decode;
+        uint64_t prefill_tokens;
+        uint64_t decode_tokens;
+        // Requests of generate calls and schedulers: time from the call or submission to
+        // the first token, and between the following tokens.
+        uint64_t requests;
+        struct LlaisysLatencyHistogram time_to_first_token;
+        struct LlaisysLatencyHistogram inter_token;
+        // Current totals over all schedulers.
+        uint64_t queue_depth; // waiting requests, including preempted ones
+        uint64_t running;     // sequences in the batch set
+    };
+
+    __export void llaisysGetMetrics(struct LlaisysMetrics *metrics);
+
+    // Zero all histograms and counters (not the current totals).
+    __export void llaisysResetMetrics();
+}
+
+#endif // LLAISYS_METRICS_H
@@ -0,0 +1,39 @@
+#ifndef LLAISYS_MODELS_MEMORY_PLANNER_H
+#define LLAISYS_MODELS_MEMORY_PLANNER_H
+
+#include "../tensor.h"
+
+__C {
+    // Activation memory planner used by the models: buffers declared with the range of steps
+    // during which they are live are placed into one arena, sharing memory when their ranges
+    // do not overlap. Exposed to inspect and test placements.
+    struct LlaisysMemoryPlanner;
+
+    __export struct LlaisysMemoryPlanner *llaisysMemoryPlannerCreate();
+
+    __export void llaisysMemoryPlannerDestroy(struct LlaisysMemoryPlanner * planner);
+
+    // Declare a buffer live from step `first` to step `last` (inclusive) and return its id.
+    __export size_t llaisysMemoryPlannerRequest(
+        struct LlaisysMemoryPlanner * planner,
+        size_t * shape,
+        size_t ndim,
+        llaisysDataType_t dtype,
+        size_t first,
+        size_t last);
+
+    // Assign the offsets and allocate the arena. No buffers can be added afterwards.
+    __export void llaisysMemoryPlannerPlan(struct LlaisysMemoryPlanner * planner, llaisysDeviceType_t device_type, int device_id);
+
+    // Byte offset of buffer `id` in the arena, after planning.
+    __export size_t llaisysMemoryPlannerOffset(struct LlaisysMemoryPlanner * planner, size_t id);
+
+    // Size of buffer `id` in the arena, rounded up to the placement alignment.
+    __export size_t llaisysMemoryPlannerBytes(struct LlaisysMemoryPlanner * planner, size_t id);
+
+    // Arena size (0 before planning), and the sum of the buffer sizes.
+    __export size_t llaisysMemoryPlannerArenaBytes(struct LlaisysMemoryPlanner * planner);
+
+    __export size_t llaisysMemoryPlannerTotalBytes(struct LlaisysMemoryPlanner * planner);
+}
+#endif // LLAISYS_MODELS_MEMORY_PLANNER_H
@@ -29,7 +29,44 @@ __C {
         llaisysTensor_t *mlp_down_w;
     };
 
+    struct LlaisysQwen2SamplingParams {
+        int top_k;         // <= 0 disables top-k filtering, 1 means greedy
+        float top_p;       // >= 1 disables top-p filtering
+        float temperature; // <= 0 means greedy
+        uint64_t seed;
+    };
+
+    // Called once per generated token. Return non-zero to cancel generation.
+    typedef int (*llaisysQwen2TokenCallback)(int64_t token, void *userdata);
+
+    typedef enum {
+        LLAISYS_QWEN2_REQUEST_RUNNING = 0, // queued, generating, or tokens left to poll
+        LLAISYS_QWEN2_REQUEST_FINISHED = 1,
+        LLAISYS_QWEN2_REQUEST_FAILED = 2,
+    } llaisysQwen2RequestStatus_t;
+
+    typedef enum {
+        LLAISYS_QWEN2_PREEMPT_RECOMPUTE = 0, // drop the KV and prefill prompt + generated tokens again on resume
+        LLAISYS_QWEN2_PREEMPT_SWAP = 1,      // copy the valid KV to host memory and restore it on resume
+    } llaisysQwen2PreemptionMode_t;
+
+    struct LlaisysQwen2SchedulerStats {
+        size_t waiting;             // queued requests, including preempted ones
+        size_t running;             // sequences in the current batch set
+        size_t swapped;             // preempted sequences whose KV is held in host memory
+        size_t kv_block_size;       // tokens per KV block
+        size_t kv_blocks_total;
+        size_t kv_blocks_used;
+        size_t kv_bytes_used;       // KV memory held by running sequences
+        size_t swap_bytes;          // host memory held by swapped sequences
+        uint64_t preemptions;
+        uint64_t swap_outs;
+        uint64_t recomputed_tokens; // tokens prefilled again after recompute preemptions
+    };
+
     struct LlaisysQwen2Model;
+    struct LlaisysQwen2Scheduler;
+    struct LlaisysQwen2Sequence;
 
     __export struct LlaisysQwen2Model *llaisysQwen2ModelCreate(const LlaisysQwen2Meta *meta, llaisysDeviceType_t device, int *device_ids, int ndevice);
 
@@ -37,6 +74,153 @@ __C {
 
     __export struct LlaisysQwen2Weights *llaisysQwen2ModelWeights(struct LlaisysQwen2Model * model);
 
+    // Load the weights from `npath` Hugging Face safetensors files and return the number of
+    // tensors loaded. On CPU, weights stored in the model dtype point into the memory-mapped
+    // files instead of being copied; others are converted. Without lm_head.weight the output
+    // projection shares the input embedding.
+    __export size_t llaisysQwen2ModelLoadSafetensors(struct LlaisysQwen2Model * model, const char **paths, size_t npath);
+
+    // Write the weights in their in-memory layout, together with the model metadata, to a
+    // LLAISYS model image at `path`. Loading an image needs no parsing or conversion.
+    __export void llaisysQwen2ModelSaveImage(struct LlaisysQwen2Model * model, const char *path);
+
+    // Read the metadata stored in the model image at `path`.
+    __export void llaisysQwen2ImageMeta(const char *path, struct LlaisysQwen2Meta *meta);
+
+    // Use the weights of the model image at `path` (mapped in place on CPU) and return the
+    // number of tensors loaded. The image must match the model's architecture and dtype.
+    __export size_t llaisysQwen2ModelLoadImage(struct LlaisysQwen2Model * model, const char *path);
+
+    // Keep at most `max_resident_bytes` of layer weights in memory for hosts that cannot hold the
+    // whole model: layers are read from their mapped files `prefetch_layers` layers ahead of the
+    // forward pass on a background thread, and the least recently used ones are dropped beyond the
+    // limit. Needs CPU weights used in place from a model image or safetensors files, without
+    // locking. 0 bytes keeps all weights resident (the default).
+    __export void llaisysQwen2ModelSetWeightResidency(struct LlaisysQwen2Model * model, size_t max_resident_bytes, size_t prefetch_layers);
+
+    // Layer weight bytes currently resident or being read under the residency limit; 0 if disabled.
+    __export size_t llaisysQwen2ModelResidentWeightBytes(struct LlaisysQwen2Model * model);
+
+    // Record the kernel launches of the first single-token forward pass (a decode step of one
+    // sequence) with their resolved buffers and replay them for the following ones, so that
+    // decode steps skip per-op validation and dispatch. On by default; weights, workspace and
+    // KV pool changes drop the recording.
+    __export void llaisysQwen2ModelSetOpCapture(struct LlaisysQwen2Model * model, int enable);
+
+    // Kernel launches recorded for single-token passes; 0 before the first one or when disabled.
+    __export size_t llaisysQwen2ModelCapturedOps(struct LlaisysQwen2Model * model);
+
+    // Run the projections of a layer that do not depend on each other (q/k/v, gate/up) at the
+    // same time, splitting the CPU threads between them, when a pass has few rows. On by default;
+    // off runs them one after another with all threads each.
+    __export void llaisysQwen2ModelSetOpConcurrency(struct LlaisysQwen2Model * model, int enable);
+
+    // Drop the KV cache so that the next Infer call starts a new sequence.
+    __export void llaisysQwen2ModelReset(struct LlaisysQwen2Model * model);
+
+    // Replace the KV cache with a pool of `block_size`-token blocks holding `max_tokens` tokens in
+    // total, shared by all sequences of the model (default: 16-token blocks, `meta.maxseq` tokens).
+    // Resets the current sequence; fails while a scheduler holds KV blocks.
+    __export void llaisysQwen2ModelConfigureKVCache(struct LlaisysQwen2Model * model, size_t block_size, size_t max_tokens);
+
+    // KV blocks of the pool held by any sequence; a block shared by forked sequences counts once.
+    __export size_t llaisysQwen2ModelKVBlocksUsed(struct LlaisysQwen2Model * model);
+
+    // Set the maximum number of tokens processed per forward pass (default: min(maxseq, 512)).
+    // Activation buffers are sized by this value, so it bounds peak activation memory.
+    __export void llaisysQwen2ModelSetPrefillChunk(struct LlaisysQwen2Model * model, size_t chunk);
+
+    // Append `ntoken` tokens to the current sequence chunk by chunk without computing logits.
+    __export void llaisysQwen2ModelPrefill(struct LlaisysQwen2Model * model, int64_t * token_ids, size_t ntoken);
+
+    // Append `ntoken` tokens to the current sequence and return the greedy next token.
     __export int64_t llaisysQwen2ModelInfer(struct LlaisysQwen2Model * model, int64_t * token_ids, size_t ntoken);
+
+    // Run prefill and the whole decode loop natively for a new sequence. Generation stops
+    // at `meta.end_token`, after `max_new_tokens` tokens, when the KV cache is full, or when
+    // `callback` returns non-zero. `params` may be NULL for greedy decoding, `callback` may be
+    // NULL, and `out_tokens` (if not NULL) must hold `max_new_tokens` entries.
+    // Returns the number of generated tokens.
+    __export size_t llaisysQwen2ModelGenerate(
+        struct LlaisysQwen2Model * model,
+        int64_t * token_ids,
+        size_t ntoken,
+        size_t max_new_tokens,
+        const struct LlaisysQwen2SamplingParams *params,
+        llaisysQwen2TokenCallback callback,
+        void *userdata,
+        int64_t *out_tokens);
+
+    // Sequence handles for n-best sampling and beam search. A sequence holds its own KV in the
+    // model's block pool and its own random state seeded with `seed`. A fork starts with the
+    // parent's tokens and shares its KV blocks: a shared block is only copied when one of the
+    // sequences writes into it, so a common prompt is stored and computed once.
+    // Free all sequences before destroying the model.
+    __export struct LlaisysQwen2Sequence *llaisysQwen2SequenceCreate(struct LlaisysQwen2Model * model, uint64_t seed);
+
+    __export struct LlaisysQwen2Sequence *llaisysQwen2SequenceFork(struct LlaisysQwen2Sequence * sequence, uint64_t seed);
+
+    __export void llaisysQwen2SequenceFree(struct LlaisysQwen2Sequence * sequence);
+
+    // Number of tokens held by the sequence.
+    __export size_t llaisysQwen2SequenceLength(struct LlaisysQwen2Sequence * sequence);
+
+    // Append `ntoken` tokens to `sequence` and return the next token, greedy if `params` is NULL.
+    // If `logits` is not NULL it receives the `meta.voc` float logits of that position, e.g. to
+    // score beams. Fails if the KV block pool is exhausted.
+    __export int64_t llaisysQwen2ModelInferSequence(
+        struct LlaisysQwen2Model * model,
+        struct LlaisysQwen2Sequence * sequence,
+        int64_t * token_ids,
+        size_t ntoken,
+        const struct LlaisysQwen2SamplingParams *params,
+        float *logits);
+
+    // Continuous-batching scheduler serving many sequences from one model. A worker thread
+    // runs one batched forward per iteration over up to `max_batch_seqs` sequences, mixing
+    // decode tokens and prefill chunks (bounded by the prefill chunk). Sequences take their KV
+    // from the model's block pool: requests are admitted when their context fits into the free
+    // blocks, and sequences of the lowest priority are preempted when the pool runs out.
+    // The model must not be used through the calls above while a scheduler exists.
+    __export struct LlaisysQwen2Scheduler *llaisysQwen2SchedulerCreate(struct LlaisysQwen2Model * model, size_t max_batch_seqs);
+
+    // Stop the worker. Requests that did not complete are reported as failed.
+    __export void llaisysQwen2SchedulerDestroy(struct LlaisysQwen2Scheduler * scheduler);
+
+    // Queue a new sequence; thread-safe. Stopping conditions, `params` and `callback` are as for
+    // llaisysQwen2ModelGenerate, except that `callback` runs on the worker thread. Requests with
+    // a higher `priority` are admitted first and preempted last. Returns the request id.
+    __export uint64_t llaisysQwen2SchedulerSubmit(
+        struct LlaisysQwen2Scheduler * scheduler,
+        int64_t * token_ids,
+        size_t ntoken,
+        size_t max_new_tokens,
+        int priority,
+        const struct LlaisysQwen2SamplingParams *params,
+        llaisysQwen2TokenCallback callback,
+        void *userdata);
+
+    // Copy up to `capacity` tokens generated since the last poll into `out_tokens` and return
+    // their number; thread-safe. If `block` is non-zero, wait until a token is available or the
+    // request ends. Once `status` reports FINISHED or FAILED the id is released.
+    __export size_t llaisysQwen2SchedulerPoll(
+        struct LlaisysQwen2Scheduler * scheduler,
+        uint64_t request_id,
+        int64_t * out_tokens,
+        size_t capacity,
+        int block,
+        llaisysQwen2RequestStatus_t *status);
+
+    // Stop generating for a request; its status becomes FINISHED. Thread-safe.
+    __export void llaisysQwen2SchedulerCancel(struct LlaisysQwen2Scheduler * scheduler, uint64_t request_id);
+
+    // Number of requests that are queued or running.
+    __export size_t llaisysQwen2SchedulerPending(struct LlaisysQwen2Scheduler * scheduler);
+
+    // Choose what happens to the KV of preempted sequences (default: RECOMPUTE).
+    __export void llaisysQwen2SchedulerSetPreemptionMode(struct LlaisysQwen2Scheduler * scheduler, llaisysQwen2PreemptionMode_t mode);
+
+    // Snapshot of the scheduler counters, refreshed once per scheduler iteration.
+    __export void llaisysQwen2SchedulerGetStats(struct LlaisysQwen2Scheduler * scheduler, struct LlaisysQwen2SchedulerStats * stats);
 }
 #endif // LLAISYS_MODELS_QWEN2_H
@@ -8,11 +8,29 @@ __C {
     __export void llaisysArgmax(llaisysTensor_t max_idx, llaisysTensor_t max_val, llaisysTensor_t vals);
     __export void llaisysEmbedding(llaisysTensor_t out, llaisysTensor_t index, llaisysTensor_t weight);
     __export void llaisysLinear(llaisysTensor_t out, llaisysTensor_t in, llaisysTensor_t weight, llaisysTensor_t bias);
+    __export void llaisysLinearArgmax(llaisysTensor_t max_idx, llaisysTensor_t max_val, llaisysTensor_t in, llaisysTensor_t weight, llaisysTensor_t bias);
+    __export void llaisysPagedAttention(llaisysTensor_t attn_val, llaisysTensor_t q, llaisysTensor_t k_blocks, llaisysTensor_t v_blocks, llaisysTensor_t block_table, size_t total_len, float scale);
     __export void llaisysRearrange(llaisysTensor_t out, llaisysTensor_t in);
     __export void llaisysRmsNorm(llaisysTensor_t out, llaisysTensor_t in, llaisysTensor_t weight, float eps);
     __export void llaisysROPE(llaisysTensor_t out, llaisysTensor_t in, llaisysTensor_t pos_ids, float theta);
+    __export void llaisysSample(llaisysTensor_t out_idx, llaisysTensor_t logits, float temperature, int top_k, float top_p, float random_val);
+    __export void llaisysSelectRows(llaisysTensor_t out, llaisysTensor_t in, llaisysTensor_t index);
     __export void llaisysSelfAttention(llaisysTensor_t attn_val, llaisysTensor_t q, llaisysTensor_t k, llaisysTensor_t v, float scale);
     __export void llaisysSwiGLU(llaisysTensor_t out, llaisysTensor_t gate, llaisysTensor_t up);
+
+    // Op tracing (off by default). While enabled, every op call is recorded with its
+    // name, tensor dtypes and shapes, thread and duration; each thread keeps its last
+    // 32768 events, in a buffer the next thread to record reuses once it exits. Dump
+    // writes them to `path` as Chrome trace JSON and returns how many were written;
+    // call it while no op is running.
+    __export void llaisysOpTraceEnable(int enabled);
+    __export void llaisysOpTraceClear();
+    __export size_t llaisysOpTraceDump(const char *path);
+
+    // Run `nbranch` empty branches side by side the way a model runs independent ops, and store
+    // in `threads` how many threads the kernels of each branch would get. Returns the number
+    // of threads of the calling thread. For checking how the CPU threads are split.
+    __export int llaisysOpConcurrentThreads(size_t nbranch, int *threads);
 }
 
 #endif
@@ -9,7 +9,8 @@ __C {
     typedef int (*get_device_count_api)();
     typedef void (*set_device_api)(int);
     typedef void (*device_synchronize_api)();
-    // Stream
+    // Stream. On CPU a stream orders asynchronous copies, host functions and events on a worker
+    // thread of its own; operators always run synchronously on the calling thread.
     typedef llaisysStream_t (*create_stream_api)();
     typedef void (*destroy_stream_api)(llaisysStream_t);
     typedef void (*stream_synchronize_api)(llaisysStream_t);
@@ -21,6 +22,18 @@ __C {
     // Memory copy
     typedef void (*memcpy_sync_api)(void *, const void *, size_t, llaisysMemcpyKind_t);
     typedef void (*memcpy_async_api)(void *, const void *, size_t, llaisysMemcpyKind_t, llaisysStream_t);
+    // Host work ordered with the work of a stream
+    typedef void (*llaisysHostFunc_t)(void *);
+    typedef void (*launch_host_func_api)(llaisysStream_t, llaisysHostFunc_t, void *);
+    // Event. record marks the current end of a stream's work; stream_wait_event makes later work
+    // on a stream wait for the last record; elapsed_time is the time between two completed
+    // records, in milliseconds. Waiting on an event that was never recorded returns at once.
+    typedef llaisysEvent_t (*create_event_api)();
+    typedef void (*destroy_event_api)(llaisysEvent_t);
+    typedef void (*event_record_api)(llaisysEvent_t, llaisysStream_t);
+    typedef void (*stream_wait_event_api)(llaisysStream_t, llaisysEvent_t);
+    typedef void (*event_synchronize_api)(llaisysEvent_t);
+    typedef float (*event_elapsed_time_api)(llaisysEvent_t, llaisysEvent_t);
 
     struct LlaisysRuntimeAPI {
         get_device_count_api get_device_count;
@@ -35,6 +48,60 @@ __C {
         free_host_api free_host;
         memcpy_sync_api memcpy_sync;
         memcpy_async_api memcpy_async;
+        launch_host_func_api launch_host_func;
+        create_event_api create_event;
+        destroy_event_api destroy_event;
+        event_record_api event_record;
+        stream_wait_event_api stream_wait_event;
+        event_synchronize_api event_synchronize;
+        event_elapsed_time_api event_elapsed_time;
+    };
+
+    // Device memory allocators
+    typedef enum {
+        LLAISYS_ALLOCATOR_NAIVE = 0,   // every storage is a malloc_device / free_device pair
+        LLAISYS_ALLOCATOR_CACHING = 1, // freed memory is kept in size-class bins and reused (default)
+    } llaisysAllocatorType_t;
+
+    // NUMA placement of large CPU buffers
+    typedef enum {
+        LLAISYS_CPU_NUMA_DEFAULT = 0,    // first touch
+        LLAISYS_CPU_NUMA_INTERLEAVE = 1, // pages spread round-robin over all nodes
+        LLAISYS_CPU_NUMA_PARTITION = 2,  // one contiguous part per node, sized by its share of CPUs
+    } llaisysCpuNumaPolicy_t;
+
+    // CPU memory. Every CPU buffer is 64-byte aligned. With `huge_pages` set, buffers of at least
+    // `huge_page_threshold` bytes are mapped on 2 MiB boundaries and advised for transparent huge
+    // pages; with `lock` also set they are locked into RAM (e.g. set it while loading weights), and
+    // they are placed on NUMA nodes according to `numa_policy`.
+    struct LlaisysCpuMemoryConfig {
+        int huge_pages;             // default: 1
+        size_t huge_page_threshold; // default: 2 MiB
+        int lock;                   // default: 0
+        llaisysCpuNumaPolicy_t numa_policy; // default: DEFAULT
+    };
+
+    // Memory telemetry. Every storage is counted under the category that was active on the
+    // allocating thread, and under size class i: sizes up to 1 KiB for i = 0, then
+    // (2^(9+i), 2^(10+i)] bytes, with the last class holding everything larger.
+    typedef enum {
+        LLAISYS_MEMORY_OTHER = 0,
+        LLAISYS_MEMORY_WEIGHTS = 1,
+        LLAISYS_MEMORY_KV_CACHE = 2,
+        LLAISYS_MEMORY_ACTIVATIONS = 3,
+        LLAISYS_MEMORY_CATEGORY_COUNT
+    } llaisysMemoryCategory_t;
+
+#define LLAISYS_MEMORY_SIZE_CLASSES 24
+
+    struct LlaisysMemoryStats {
+        size_t live_bytes[LLAISYS_MEMORY_CATEGORY_COUNT];
+        size_t peak_bytes[LLAISYS_MEMORY_CATEGORY_COUNT];
+        uint64_t allocations[LLAISYS_MEMORY_CATEGORY_COUNT];
+        uint64_t frees[LLAISYS_MEMORY_CATEGORY_COUNT];
+        uint64_t size_classes[LLAISYS_MEMORY_CATEGORY_COUNT][LLAISYS_MEMORY_SIZE_CLASSES];
+        size_t total_live_bytes;
+        size_t total_peak_bytes;
     };
 
     // Llaisys API for getting the runtime APIs
@@ -42,6 +109,40 @@ __C {
 
     // Llaisys API for switching device context
     __export void llaisysSetContextRuntime(llaisysDeviceType_t, int);
+
+    // Share one runtime per device, with its allocator, among all threads of the process
+    // (disabled by default: every thread has runtimes of its own). The selected device stays
+    // per thread; a thread moves to the shared or its own runtimes on its next device switch.
+    // Storages of shared runtimes may be freed from any thread.
+    __export void llaisysSetSharedRuntime(int shared);
+
+    // Select the device memory allocator of the current runtime of the calling thread (of every
+    // thread, if the runtime is shared). Fails while the runtime has device storages alive.
+    __export void llaisysSetContextAllocator(llaisysAllocatorType_t);
+
+    // Return device memory cached by the current runtime's allocator to the device.
+    __export void llaisysContextEmptyCache();
+
+    // Memory counters of a device, summed over all threads. Host (pinned) storages are
+    // counted under the CPU.
+    __export void llaisysGetMemoryStats(llaisysDeviceType_t device_type, int device_id, struct LlaisysMemoryStats *stats);
+
+    // Restart peak tracking from the current live bytes.
+    __export void llaisysResetPeakMemoryStats(llaisysDeviceType_t device_type, int device_id);
+
+    // Category under which storages allocated by the calling thread are counted from now on.
+    __export void llaisysSetMemoryCategory(llaisysMemoryCategory_t category);
+
+    // Configure how CPU memory is allocated from now on (process-wide).
+    __export void llaisysSetCpuMemoryConfig(const struct LlaisysCpuMemoryConfig *config);
+    __export void llaisysGetCpuMemoryConfig(struct LlaisysCpuMemoryConfig *config);
+
+    // Number of online NUMA nodes (1 without NUMA information).
+    __export int llaisysCpuNumaNodeCount();
+
+    // Pin the CPU worker threads to NUMA nodes in proportion to their CPUs, so that with the
+    // PARTITION policy each thread's rows of a weight matrix are node-local.
+    __export void llaisysCpuBindThreads();
 }
 
 #endif // LLAISYS_RUNTIME_H
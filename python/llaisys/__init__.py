@@ -1,20 +1,40 @@
-from .runtime import RuntimeAPI
+from .runtime import RuntimeAPI, set_allocator, set_shared_runtime, empty_cache, set_memory_category
+from .runtime import set_cpu_memory_config, cpu_numa_node_count, bind_cpu_threads
 from .libllaisys import DeviceType
 from .libllaisys import DataType
 from .libllaisys import MemcpyKind
+from .libllaisys import AllocatorType
+from .libllaisys import CpuNumaPolicy
+from .libllaisys import MemoryCategory
+from .libllaisys import OpType
 from .libllaisys import llaisysStream_t as Stream
 from .tensor import Tensor
 from .ops import Ops
+from .metrics import metrics, reset_metrics, LATENCY_BUCKET_BOUNDS
 from . import models
 from .models import *
 
 __all__ = [
     "RuntimeAPI",
+    "set_allocator",
+    "set_shared_runtime",
+    "empty_cache",
+    "set_memory_category",
+    "set_cpu_memory_config",
+    "cpu_numa_node_count",
+    "bind_cpu_threads",
     "DeviceType",
     "DataType",
     "MemcpyKind",
+    "AllocatorType",
+    "CpuNumaPolicy",
+    "MemoryCategory",
+    "OpType",
     "Stream",
     "Tensor",
     "Ops",
+    "metrics",
+    "reset_metrics",
+    "LATENCY_BUCKET_BOUNDS",
     "models",
 ]
@@ -4,14 +4,27 @@ import ctypes
 from pathlib import Path
 
 from .runtime import load_runtime
-from .runtime import LlaisysRuntimeAPI
+from .runtime import LlaisysRuntimeAPI, LlaisysCpuMemoryConfig, LlaisysMemoryStats
 from .llaisys_types import llaisysDeviceType_t, DeviceType
 from .llaisys_types import llaisysDataType_t, DataType
 from .llaisys_types import llaisysMemcpyKind_t, MemcpyKind
-from .llaisys_types import llaisysStream_t
+from .llaisys_types import llaisysAllocatorType_t, AllocatorType
+from .llaisys_types import llaisysCpuNumaPolicy_t, CpuNumaPolicy
+from .llaisys_types import llaisysMemoryCategory_t, MemoryCategory
+from .llaisys_types import llaisysOpType_t, OpType
+from .llaisys_types import llaisysStream_t, llaisysEvent_t
 from .tensor import llaisysTensor_t
 from .tensor import load_tensor
 from .ops import load_ops
+from .metrics import load_metrics
+from .metrics import LlaisysLatencyHistogram, LlaisysMetrics
+from .models import load_qwen2
+from .models import LlaisysQwen2Meta, LlaisysQwen2Weights, llaisysQwen2Model_t
+from .models import LlaisysQwen2SamplingParams, llaisysQwen2TokenCallback
+from .models import Qwen2RequestStatus, llaisysQwen2RequestStatus_t, llaisysQwen2Scheduler_t
+from .models import llaisysQwen2Sequence_t
+from .models import Qwen2PreemptionMode, llaisysQwen2PreemptionMode_t, LlaisysQwen2SchedulerStats
+from .models import load_memory_planner, llaisysMemoryPlanner_t
 
 
 def load_shared_library():
@@ -38,12 +51,18 @@ LIB_LLAISYS = load_shared_library()
 load_runtime(LIB_LLAISYS)
 load_tensor(LIB_LLAISYS)
 load_ops(LIB_LLAISYS)
+load_metrics(LIB_LLAISYS)
+load_qwen2(LIB_LLAISYS)
+load_memory_planner(LIB_LLAISYS)
 
 
 __all__ = [
     "LIB_LLAISYS",
     "LlaisysRuntimeAPI",
+    "LlaisysCpuMemoryConfig",
+    "LlaisysMemoryStats",
     "llaisysStream_t",
+    "llaisysEvent_t",
     "llaisysTensor_t",
     "llaisysDataType_t",
     "DataType",
@@ -51,5 +70,28 @@ __all__ = [
     "DeviceType",
     "llaisysMemcpyKind_t",
     "MemcpyKind",
+    "llaisysAllocatorType_t",
+    "AllocatorType",
+    "llaisysCpuNumaPolicy_t",
+    "CpuNumaPolicy",
+    "llaisysMemoryCategory_t",
+    "MemoryCategory",
+    "llaisysOpType_t",
+    "OpType",
+    "LlaisysLatencyHistogram",
+    "LlaisysMetrics",
     "llaisysStream_t",
+    "LlaisysQwen2Meta",
+    "LlaisysQwen2Weights",
+    "llaisysQwen2Model_t",
+    "LlaisysQwen2SamplingParams",
+    "llaisysQwen2TokenCallback",
+    "Qwen2RequestStatus",
+    "llaisysQwen2RequestStatus_t",
+    "llaisysQwen2Scheduler_t",
+    "llaisysQwen2Sequence_t",
+    "Qwen2PreemptionMode",
+    "llaisysQwen2PreemptionMode_t",
+    "LlaisysQwen2SchedulerStats",
+    "llaisysMemoryPlanner_t",
 ]
@@ -49,8 +49,58 @@ class MemcpyKind(IntEnum):
 
 llaisysMemcpyKind_t = ctypes.c_int
 
+# Device memory allocator enum
+class AllocatorType(IntEnum):
+    NAIVE = 0
+    CACHING = 1
+
+
+llaisysAllocatorType_t = ctypes.c_int
+
+# NUMA placement of large CPU buffers
+class CpuNumaPolicy(IntEnum):
+    DEFAULT = 0
+    INTERLEAVE = 1
+    PARTITION = 2
+
+
+llaisysCpuNumaPolicy_t = ctypes.c_int
+
+# Memory telemetry category enum
+class MemoryCategory(IntEnum):
+    OTHER = 0
+    WEIGHTS = 1
+    KV_CACHE = 2
+    ACTIVATIONS = 3
+    COUNT = 4
+
+
+llaisysMemoryCategory_t = ctypes.c_int
+
+
+class OpType(IntEnum):
+    ADD = 0
+    ARGMAX = 1
+    EMBEDDING = 2
+    LINEAR = 3
+    LINEAR_ARGMAX = 4
+    PAGED_ATTENTION = 5
+    REARRANGE = 6
+    RMS_NORM = 7
+    ROPE = 8
+    SAMPLE = 9
+    SELECT_ROWS = 10
+    SELF_ATTENTION = 11
+    SWIGLU = 12
+    COUNT = 13
+
+
+llaisysOpType_t = ctypes.c_int
+
 # Stream type (opaque pointer)
 llaisysStream_t = ctypes.c_void_p
+# Event type (opaque pointer)
+llaisysEvent_t = ctypes.c_void_p
 
 __all__ = [
     "llaisysDeviceType_t",
@@ -59,5 +109,14 @@ __all__ = [
     "DataType",
     "llaisysMemcpyKind_t",
     "MemcpyKind",
+    "llaisysAllocatorType_t",
+    "AllocatorType",
+    "llaisysCpuNumaPolicy_t",
+    "CpuNumaPolicy",
+    "llaisysMemoryCategory_t",
+    "MemoryCategory",
+    "llaisysOpType_t",
+    "OpType",
     "llaisysStream_t",
+    "llaisysEvent_t",
 ]
@@ -0,0 +1,37 @@
+from ctypes import c_uint64, Structure, POINTER
+from .llaisys_types import OpType
+
+LLAISYS_LATENCY_BUCKETS = 28
+LLAISYS_METRICS_MAX_LAYERS = 128
+
+
+class LlaisysLatencyHistogram(Structure):
+    _fields_ = [
+        ("count", c_uint64),
+        ("sum_ns", c_uint64),
+        ("buckets", c_uint64 * LLAISYS_LATENCY_BUCKETS),
+    ]
+
+
+class LlaisysMetrics(Structure):
+    _fields_ = [
+        ("ops", LlaisysLatencyHistogram * OpType.COUNT),
+        ("layers", LlaisysLatencyHistogram * LLAISYS_METRICS_MAX_LAYERS),
+        ("prefill", LlaisysLatencyHistogram),
+        ("decode", LlaisysLatencyHistogram),
+        ("prefill_tokens", c_uint64),
+        ("decode_tokens", c_uint64),
+        ("requests", c_uint64),
+        ("time_to_first_token", LlaisysLatencyHistogram),
+        ("inter_token", LlaisysLatencyHistogram),
+        ("queue_depth", c_uint64),
+        ("running", c_uint64),
+    ]
+
+
+def load_metrics(lib):
+    lib.llaisysGetMetrics.argtypes = [POINTER(LlaisysMetrics)]
+    lib.llaisysGetMetrics.restype = None
+
+    lib.llaisysResetMetrics.argtypes = []
+    lib.llaisysResetMetrics.restype = None
@@ -0,0 +1,25 @@
+from .qwen2 import load_qwen2
+from .qwen2 import LlaisysQwen2Meta, LlaisysQwen2Weights, llaisysQwen2Model_t
+from .qwen2 import LlaisysQwen2SamplingParams, llaisysQwen2TokenCallback
+from .qwen2 import Qwen2RequestStatus, llaisysQwen2RequestStatus_t, llaisysQwen2Scheduler_t
+from .qwen2 import llaisysQwen2Sequence_t
+from .qwen2 import Qwen2PreemptionMode, llaisysQwen2PreemptionMode_t, LlaisysQwen2SchedulerStats
+from .memory_planner import load_memory_planner, llaisysMemoryPlanner_t
+
+__all__ = [
+    "load_qwen2",
+    "LlaisysQwen2Meta",
+    "LlaisysQwen2Weights",
+    "llaisysQwen2Model_t",
+    "LlaisysQwen2SamplingParams",
+    "llaisysQwen2TokenCallback",
+    "Qwen2RequestStatus",
+    "llaisysQwen2RequestStatus_t",
+    "llaisysQwen2Scheduler_t",
+    "llaisysQwen2Sequence_t",
+    "Qwen2PreemptionMode",
+    "llaisysQwen2PreemptionMode_t",
+    "LlaisysQwen2SchedulerStats",
+    "load_memory_planner",
+    "llaisysMemoryPlanner_t",
+]
@@ -0,0 +1,41 @@
+from ctypes import POINTER, c_int, c_size_t, c_void_p
+from ..llaisys_types import llaisysDataType_t, llaisysDeviceType_t
+
+llaisysMemoryPlanner_t = c_void_p
+
+
+def load_memory_planner(lib):
+    lib.llaisysMemoryPlannerCreate.argtypes = []
+    lib.llaisysMemoryPlannerCreate.restype = llaisysMemoryPlanner_t
+
+    lib.llaisysMemoryPlannerDestroy.argtypes = [llaisysMemoryPlanner_t]
+    lib.llaisysMemoryPlannerDestroy.restype = None
+
+    lib.llaisysMemoryPlannerRequest.argtypes = [
+        llaisysMemoryPlanner_t,  # planner
+        POINTER(c_size_t),  # shape
+        c_size_t,  # ndim
+        llaisysDataType_t,  # dtype
+        c_size_t,  # first
+        c_size_t,  # last
+    ]
+    lib.llaisysMemoryPlannerRequest.restype = c_size_t
+
+    lib.llaisysMemoryPlannerPlan.argtypes = [
+        llaisysMemoryPlanner_t,  # planner
+        llaisysDeviceType_t,  # device_type
+        c_int,  # device_id
+    ]
+    lib.llaisysMemoryPlannerPlan.restype = None
+
+    lib.llaisysMemoryPlannerOffset.argtypes = [llaisysMemoryPlanner_t, c_size_t]
+    lib.llaisysMemoryPlannerOffset.restype = c_size_t
+
+    lib.llaisysMemoryPlannerBytes.argtypes = [llaisysMemoryPlanner_t, c_size_t]
+    lib.llaisysMemoryPlannerBytes.restype = c_size_t
+
+    lib.llaisysMemoryPlannerArenaBytes.argtypes = [llaisysMemoryPlanner_t]
+    lib.llaisysMemoryPlannerArenaBytes.restype = c_size_t
+
+    lib.llaisysMemoryPlannerTotalBytes.argtypes = [llaisysMemoryPlanner_t]
+    lib.llaisysMemoryPlannerTotalBytes.restype = c_size_t
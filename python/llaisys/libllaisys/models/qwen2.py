@@ -0,0 +1,253 @@
+from ctypes import CFUNCTYPE, POINTER, Structure, c_char_p, c_float, c_int, c_int64, c_size_t, c_uint64, c_void_p
+from ..llaisys_types import llaisysDataType_t, llaisysDeviceType_t
+from ..tensor import llaisysTensor_t
+from enum import IntEnum
+
+
+class LlaisysQwen2Meta(Structure):
+    _fields_ = [
+        ("dtype", llaisysDataType_t),
+        ("nlayer", c_size_t),
+        ("hs", c_size_t),
+        ("nh", c_size_t),
+        ("nkvh", c_size_t),
+        ("dh", c_size_t),
+        ("di", c_size_t),
+        ("maxseq", c_size_t),
+        ("voc", c_size_t),
+        ("epsilon", c_float),
+        ("theta", c_float),
+        ("end_token", c_int64),
+    ]
+
+
+class LlaisysQwen2Weights(Structure):
+    _fields_ = [
+        ("in_embed", llaisysTensor_t),
+        ("out_embed", llaisysTensor_t),
+        ("out_norm_w", llaisysTensor_t),
+        ("attn_norm_w", POINTER(llaisysTensor_t)),
+        ("attn_q_w", POINTER(llaisysTensor_t)),
+        ("attn_q_b", POINTER(llaisysTensor_t)),
+        ("attn_k_w", POINTER(llaisysTensor_t)),
+        ("attn_k_b", POINTER(llaisysTensor_t)),
+        ("attn_v_w", POINTER(llaisysTensor_t)),
+        ("attn_v_b", POINTER(llaisysTensor_t)),
+        ("attn_o_w", POINTER(llaisysTensor_t)),
+        ("mlp_norm_w", POINTER(llaisysTensor_t)),
+        ("mlp_gate_w", POINTER(llaisysTensor_t)),
+        ("mlp_up_w", POINTER(llaisysTensor_t)),
+        ("mlp_down_w", POINTER(llaisysTensor_t)),
+    ]
+
+
+class LlaisysQwen2SamplingParams(Structure):
+    _fields_ = [
+        ("top_k", c_int),
+        ("top_p", c_float),
+        ("temperature", c_float),
+        ("seed", c_uint64),
+    ]
+
+
+# Per-token callback: (token, userdata) -> non-zero to cancel
+llaisysQwen2TokenCallback = CFUNCTYPE(c_int, c_int64, c_void_p)
+
+class Qwen2RequestStatus(IntEnum):
+    RUNNING = 0
+    FINISHED = 1
+    FAILED = 2
+
+
+llaisysQwen2RequestStatus_t = c_int
+
+
+class Qwen2PreemptionMode(IntEnum):
+    RECOMPUTE = 0
+    SWAP = 1
+
+
+llaisysQwen2PreemptionMode_t = c_int
+
+
+class LlaisysQwen2SchedulerStats(Structure):
+    _fields_ = [
+        ("waiting", c_size_t),
+        ("running", c_size_t),
+        ("swapped", c_size_t),
+        ("kv_block_size", c_size_t),
+        ("kv_blocks_total", c_size_t),
+        ("kv_blocks_used", c_size_t),
+        ("kv_bytes_used", c_size_t),
+        ("swap_bytes", c_size_t),
+        ("preemptions", c_uint64),
+        ("swap_outs", c_uint64),
+        ("recomputed_tokens", c_uint64),
+    ]
+
+
+# Handle types
+llaisysQwen2Model_t = c_void_p
+llaisysQwen2Scheduler_t = c_void_p
+llaisysQwen2Sequence_t = c_void_p
+
+
+def load_qwen2(lib):
+    lib.llaisysQwen2ModelCreate.argtypes = [
+        POINTER(LlaisysQwen2Meta),  # meta
+        llaisysDeviceType_t,  # device
+        POINTER(c_int),  # device_ids
+        c_int,  # ndevice
+    ]
+    lib.llaisysQwen2ModelCreate.restype = llaisysQwen2Model_t
+
+    lib.llaisysQwen2ModelDestroy.argtypes = [llaisysQwen2Model_t]
+    lib.llaisysQwen2ModelDestroy.restype = None
+
+    lib.llaisysQwen2ModelWeights.argtypes = [llaisysQwen2Model_t]
+    lib.llaisysQwen2ModelWeights.restype = POINTER(LlaisysQwen2Weights)
+
+    lib.llaisysQwen2ModelLoadSafetensors.argtypes = [
+        llaisysQwen2Model_t,  # model
+        POINTER(c_char_p),  # paths
+        c_size_t,  # npath
+    ]
+    lib.llaisysQwen2ModelLoadSafetensors.restype = c_size_t
+
+    lib.llaisysQwen2ModelSaveImage.argtypes = [llaisysQwen2Model_t, c_char_p]
+    lib.llaisysQwen2ModelSaveImage.restype = None
+
+    lib.llaisysQwen2ImageMeta.argtypes = [c_char_p, POINTER(LlaisysQwen2Meta)]
+    lib.llaisysQwen2ImageMeta.restype = None
+
+    lib.llaisysQwen2ModelLoadImage.argtypes = [llaisysQwen2Model_t, c_char_p]
+    lib.llaisysQwen2ModelLoadImage.restype = c_size_t
+
+    lib.llaisysQwen2ModelSetWeightResidency.argtypes = [
+        llaisysQwen2Model_t,  # model
+        c_size_t,  # max_resident_bytes
+        c_size_t,  # prefetch_layers
+    ]
+    lib.llaisysQwen2ModelSetWeightResidency.restype = None
+
+    lib.llaisysQwen2ModelResidentWeightBytes.argtypes = [llaisysQwen2Model_t]
+    lib.llaisysQwen2ModelResidentWeightBytes.restype = c_size_t
+
+    lib.llaisysQwen2ModelSetOpCapture.argtypes = [llaisysQwen2Model_t, c_int]
+    lib.llaisysQwen2ModelSetOpCapture.restype = None
+
+    lib.llaisysQwen2ModelCapturedOps.argtypes = [llaisysQwen2Model_t]
+    lib.llaisysQwen2ModelCapturedOps.restype = c_size_t
+
+    lib.llaisysQwen2ModelSetOpConcurrency.argtypes = [llaisysQwen2Model_t, c_int]
+    lib.llaisysQwen2ModelSetOpConcurrency.restype = None
+
+    lib.llaisysQwen2ModelReset.argtypes = [llaisysQwen2Model_t]
+    lib.llaisysQwen2ModelReset.restype = None
+
+    lib.llaisysQwen2ModelConfigureKVCache.argtypes = [
+        llaisysQwen2Model_t,  # model
+        c_size_t,  # block_size
+        c_size_t,  # max_tokens
+    ]
+    lib.llaisysQwen2ModelConfigureKVCache.restype = None
+
+    lib.llaisysQwen2ModelKVBlocksUsed.argtypes = [llaisysQwen2Model_t]
+    lib.llaisysQwen2ModelKVBlocksUsed.restype = c_size_t
+
+    lib.llaisysQwen2ModelSetPrefillChunk.argtypes = [llaisysQwen2Model_t, c_size_t]
+    lib.llaisysQwen2ModelSetPrefillChunk.restype = None
+
+    lib.llaisysQwen2ModelPrefill.argtypes = [
+        llaisysQwen2Model_t,  # model
+        POINTER(c_int64),  # token_ids
+        c_size_t,  # ntoken
+    ]
+    lib.llaisysQwen2ModelPrefill.restype = None
+
+    lib.llaisysQwen2ModelInfer.argtypes = [
+        llaisysQwen2Model_t,  # model
+        POINTER(c_int64),  # token_ids
+        c_size_t,  # ntoken
+    ]
+    lib.llaisysQwen2ModelInfer.restype = c_int64
+
+    lib.llaisysQwen2ModelGenerate.argtypes = [
+        llaisysQwen2Model_t,  # model
+        POINTER(c_int64),  # token_ids
+        c_size_t,  # ntoken
+        c_size_t,  # max_new_tokens
+        POINTER(LlaisysQwen2SamplingParams),  # params
+        llaisysQwen2TokenCallback,  # callback
+        c_void_p,  # userdata
+        POINTER(c_int64),  # out_tokens
+    ]
+    lib.llaisysQwen2ModelGenerate.restype = c_size_t
+
+    lib.llaisysQwen2SequenceCreate.argtypes = [llaisysQwen2Model_t, c_uint64]
+    lib.llaisysQwen2SequenceCreate.restype = llaisysQwen2Sequence_t
+
+    lib.llaisysQwen2SequenceFork.argtypes = [llaisysQwen2Sequence_t, c_uint64]
+    lib.llaisysQwen2SequenceFork.restype = llaisysQwen2Sequence_t
+
+    lib.llaisysQwen2SequenceFree.argtypes = [llaisysQwen2Sequence_t]
+    lib.llaisysQwen2SequenceFree.restype = None
+
+    lib.llaisysQwen2SequenceLength.argtypes = [llaisysQwen2Sequence_t]
+    lib.llaisysQwen2SequenceLength.restype = c_size_t
+
+    lib.llaisysQwen2ModelInferSequence.argtypes = [
+        llaisysQwen2Model_t,  # model
+        llaisysQwen2Sequence_t,  # sequence
+        POINTER(c_int64),  # token_ids
+        c_size_t,  # ntoken
+        POINTER(LlaisysQwen2SamplingParams),  # params
+        POINTER(c_float),  # logits
+    ]
+    lib.llaisysQwen2ModelInferSequence.restype = c_int64
+
+    lib.llaisysQwen2SchedulerCreate.argtypes = [llaisysQwen2Model_t, c_size_t]
+    lib.llaisysQwen2SchedulerCreate.restype = llaisysQwen2Scheduler_t
+
+    lib.llaisysQwen2SchedulerDestroy.argtypes = [llaisysQwen2Scheduler_t]
+    lib.llaisysQwen2SchedulerDestroy.restype = None
+
+    lib.llaisysQwen2SchedulerSubmit.argtypes = [
+        llaisysQwen2Scheduler_t,  # scheduler
+        POINTER(c_int64),  # token_ids
+        c_size_t,  # ntoken
+        c_size_t,  # max_new_tokens
+        c_int,  # priority
+        POINTER(LlaisysQwen2SamplingParams),  # params
+        llaisysQwen2TokenCallback,  # callback
+        c_void_p,  # userdata
+    ]
+    lib.llaisysQwen2SchedulerSubmit.restype = c_uint64
+
+    lib.llaisysQwen2SchedulerPoll.argtypes = [
+        llaisysQwen2Scheduler_t,  # scheduler
+        c_uint64,  # request_id
+        POINTER(c_int64),  # out_tokens
+        c_size_t,  # capacity
+        c_int,  # block
+        POINTER(llaisysQwen2RequestStatus_t),  # status
+    ]
+    lib.llaisysQwen2SchedulerPoll.restype = c_size_t
+
+    lib.llaisysQwen2SchedulerCancel.argtypes = [llaisysQwen2Scheduler_t, c_uint64]
+    lib.llaisysQwen2SchedulerCancel.restype = None
+
+    lib.llaisysQwen2SchedulerPending.argtypes = [llaisysQwen2Scheduler_t]
+    lib.llaisysQwen2SchedulerPending.restype = c_size_t
+
+    lib.llaisysQwen2SchedulerSetPreemptionMode.argtypes = [
+        llaisysQwen2Scheduler_t,
+        llaisysQwen2PreemptionMode_t,
+    ]
+    lib.llaisysQwen2SchedulerSetPreemptionMode.restype = None
+
+    lib.llaisysQwen2SchedulerGetStats.argtypes = [
+        llaisysQwen2Scheduler_t,
+        POINTER(LlaisysQwen2SchedulerStats),
+    ]
+    lib.llaisysQwen2SchedulerGetStats.restype = None
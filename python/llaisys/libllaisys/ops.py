@@ -1,5 +1,5 @@
 from .tensor import llaisysTensor_t
-from ctypes import c_float
+from ctypes import POINTER, c_char_p, c_float, c_int, c_size_t
 
 def load_ops(lib):
     lib.llaisysAdd.argtypes = [llaisysTensor_t, llaisysTensor_t, llaisysTensor_t]
@@ -14,6 +14,26 @@ def load_ops(lib):
     lib.llaisysLinear.argtypes = [llaisysTensor_t, llaisysTensor_t, llaisysTensor_t, llaisysTensor_t]
     lib.llaisysLinear.restype = None
 
+    lib.llaisysLinearArgmax.argtypes = [
+        llaisysTensor_t,  # max_idx
+        llaisysTensor_t,  # max_val
+        llaisysTensor_t,  # in
+        llaisysTensor_t,  # weight
+        llaisysTensor_t,  # bias
+    ]
+    lib.llaisysLinearArgmax.restype = None
+
+    lib.llaisysPagedAttention.argtypes = [
+        llaisysTensor_t,  # attn_val
+        llaisysTensor_t,  # q
+        llaisysTensor_t,  # k_blocks
+        llaisysTensor_t,  # v_blocks
+        llaisysTensor_t,  # block_table
+        c_size_t,  # total_len
+        c_float,  # scale
+    ]
+    lib.llaisysPagedAttention.restype = None
+
     lib.llaisysRearrange.argtypes = [llaisysTensor_t, llaisysTensor_t]
     lib.llaisysRearrange.restype = None
 
@@ -23,6 +43,19 @@ def load_ops(lib):
     lib.llaisysROPE.argtypes = [llaisysTensor_t, llaisysTensor_t, llaisysTensor_t, c_float]
     lib.llaisysROPE.restype = None
 
+    lib.llaisysSample.argtypes = [
+        llaisysTensor_t,  # out_idx
+        llaisysTensor_t,  # logits
+        c_float,  # temperature
+        c_int,  # top_k
+        c_float,  # top_p
+        c_float,  # random_val
+    ]
+    lib.llaisysSample.restype = None
+
+    lib.llaisysSelectRows.argtypes = [llaisysTensor_t, llaisysTensor_t, llaisysTensor_t]
+    lib.llaisysSelectRows.restype = None
+
     lib.llaisysSelfAttention.argtypes = [
         llaisysTensor_t,  # attn_val
         llaisysTensor_t,  # q
@@ -34,3 +67,15 @@ def load_ops(lib):
 
     lib.llaisysSwiGLU.argtypes = [llaisysTensor_t, llaisysTensor_t, llaisysTensor_t]
     lib.llaisysSwiGLU.restype = None
+
+    lib.llaisysOpTraceEnable.argtypes = [c_int]
+    lib.llaisysOpTraceEnable.restype = None
+
+    lib.llaisysOpTraceClear.argtypes = []
+    lib.llaisysOpTraceClear.restype = None
+
+    lib.llaisysOpTraceDump.argtypes = [c_char_p]
+    lib.llaisysOpTraceDump.restype = c_size_t
+
+    lib.llaisysOpConcurrentThreads.argtypes = [c_size_t, POINTER(c_int)]
+    lib.llaisysOpConcurrentThreads.restype = c_int
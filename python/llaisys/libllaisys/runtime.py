@@ -1,5 +1,5 @@
 import ctypes
-from ctypes import c_void_p, c_size_t, c_int, Structure, CFUNCTYPE
+from ctypes import c_void_p, c_size_t, c_int, c_uint64, c_float, Structure, CFUNCTYPE
 from .llaisys_types import *
 
 # Define function pointer types
@@ -19,6 +19,16 @@ free_host_api = CFUNCTYPE(None, c_void_p)
 memcpy_sync_api = CFUNCTYPE(None, c_void_p, c_void_p, c_size_t, llaisysMemcpyKind_t)
 memcpy_async_api = CFUNCTYPE(None, c_void_p, c_void_p, c_size_t, llaisysMemcpyKind_t, llaisysStream_t)
 
+host_func_t = CFUNCTYPE(None, c_void_p)
+launch_host_func_api = CFUNCTYPE(None, llaisysStream_t, host_func_t, c_void_p)
+
+create_event_api = CFUNCTYPE(llaisysEvent_t)
+destroy_event_api = CFUNCTYPE(None, llaisysEvent_t)
+event_record_api = CFUNCTYPE(None, llaisysEvent_t, llaisysStream_t)
+stream_wait_event_api = CFUNCTYPE(None, llaisysStream_t, llaisysEvent_t)
+event_synchronize_api = CFUNCTYPE(None, llaisysEvent_t)
+event_elapsed_time_api = CFUNCTYPE(c_float, llaisysEvent_t, llaisysEvent_t)
+
 
 # Define the struct matching LlaisysRuntimeAPI
 class LlaisysRuntimeAPI(Structure):
@@ -35,6 +45,38 @@ class LlaisysRuntimeAPI(Structure):
         ("free_host", free_host_api),
         ("memcpy_sync", memcpy_sync_api),
         ("memcpy_async", memcpy_async_api),
+        ("launch_host_func", launch_host_func_api),
+        ("create_event", create_event_api),
+        ("destroy_event", destroy_event_api),
+        ("event_record", event_record_api),
+        ("stream_wait_event", stream_wait_event_api),
+        ("event_synchronize", event_synchronize_api),
+        ("event_elapsed_time", event_elapsed_time_api),
+    ]
+
+
+class LlaisysCpuMemoryConfig(Structure):
+    _fields_ = [
+        ("huge_pages", c_int),
+        ("huge_page_threshold", c_size_t),
+        ("lock", c_int),
+        ("numa_policy", llaisysCpuNumaPolicy_t),
+    ]
+
+
+LLAISYS_MEMORY_SIZE_CLASSES = 24
+_NCATEGORY = MemoryCategory.COUNT
+
+
+class LlaisysMemoryStats(Structure):
+    _fields_ = [
+        ("live_bytes", c_size_t * _NCATEGORY),
+        ("peak_bytes", c_size_t * _NCATEGORY),
+        ("allocations", c_uint64 * _NCATEGORY),
+        ("frees", c_uint64 * _NCATEGORY),
+        ("size_classes", (c_uint64 * LLAISYS_MEMORY_SIZE_CLASSES) * _NCATEGORY),
+        ("total_live_bytes", c_size_t),
+        ("total_peak_bytes", c_size_t),
     ]
 
 
@@ -46,3 +88,37 @@ def load_runtime(lib):
 
     lib.llaisysSetContextRuntime.argtypes = [llaisysDeviceType_t, c_int]
     lib.llaisysSetContextRuntime.restype = None
+
+    lib.llaisysSetSharedRuntime.argtypes = [c_int]
+    lib.llaisysSetSharedRuntime.restype = None
+
+    lib.llaisysSetContextAllocator.argtypes = [llaisysAllocatorType_t]
+    lib.llaisysSetContextAllocator.restype = None
+
+    lib.llaisysContextEmptyCache.argtypes = []
+    lib.llaisysContextEmptyCache.restype = None
+
+    lib.llaisysSetCpuMemoryConfig.argtypes = [ctypes.POINTER(LlaisysCpuMemoryConfig)]
+    lib.llaisysSetCpuMemoryConfig.restype = None
+
+    lib.llaisysGetCpuMemoryConfig.argtypes = [ctypes.POINTER(LlaisysCpuMemoryConfig)]
+    lib.llaisysGetCpuMemoryConfig.restype = None
+
+    lib.llaisysCpuNumaNodeCount.argtypes = []
+    lib.llaisysCpuNumaNodeCount.restype = c_int
+
+    lib.llaisysCpuBindThreads.argtypes = []
+    lib.llaisysCpuBindThreads.restype = None
+
+    lib.llaisysGetMemoryStats.argtypes = [
+        llaisysDeviceType_t,
+        c_int,
+        ctypes.POINTER(LlaisysMemoryStats),
+    ]
+    lib.llaisysGetMemoryStats.restype = None
+
+    lib.llaisysResetPeakMemoryStats.argtypes = [llaisysDeviceType_t, c_int]
+    lib.llaisysResetPeakMemoryStats.restype = None
+
+    lib.llaisysSetMemoryCategory.argtypes = [llaisysMemoryCategory_t]
+    lib.llaisysSetMemoryCategory.restype = None
@@ -0,0 +1,51 @@
+from . import libllaisys
+from .libllaisys import LIB_LLAISYS
+from ctypes import byref
+
+# Upper bound of every latency bucket, in seconds.
+LATENCY_BUCKET_BOUNDS = [1e-6 * 2**i for i in range(libllaisys.metrics.LLAISYS_LATENCY_BUCKETS - 1)] + [
+    float("inf")
+]
+
+
+def _histogram(h) -> dict:
+    return {"count": h.count, "sum_seconds": h.sum_ns / 1e9, "buckets": list(h.buckets)}
+
+
+def _rate(tokens: int, h) -> float:
+    return tokens / (h.sum_ns / 1e9) if h.sum_ns > 0 else 0.0
+
+
+def metrics() -> dict:
+    """Snapshot of the process-wide performance metrics.
+
+    Histograms count durations per bucket of LATENCY_BUCKET_BOUNDS. Layers are listed up
+    to the deepest one that ran; tokens per second are over the time spent in forward passes.
+    """
+    m = libllaisys.LlaisysMetrics()
+    LIB_LLAISYS.llaisysGetMetrics(byref(m))
+    nlayer = max((i + 1 for i, h in enumerate(m.layers) if h.count > 0), default=0)
+    return {
+        "ops": {
+            op.name.lower(): _histogram(m.ops[op])
+            for op in libllaisys.OpType
+            if op != libllaisys.OpType.COUNT
+        },
+        "layers": [_histogram(m.layers[i]) for i in range(nlayer)],
+        "prefill": _histogram(m.prefill),
+        "decode": _histogram(m.decode),
+        "prefill_tokens": m.prefill_tokens,
+        "decode_tokens": m.decode_tokens,
+        "prefill_tokens_per_second": _rate(m.prefill_tokens, m.prefill),
+        "decode_tokens_per_second": _rate(m.decode_tokens, m.decode),
+        "requests": m.requests,
+        "time_to_first_token": _histogram(m.time_to_first_token),
+        "inter_token": _histogram(m.inter_token),
+        "queue_depth": m.queue_depth,
+        "running": m.running,
+    }
+
+
+def reset_metrics() -> None:
+    """Zero all histograms and counters; queue depth and running stay current."""
+    LIB_LLAISYS.llaisysResetMetrics()
@@ -1 +1,3 @@
-from .qwen2 import Qwen2
+from .qwen2 import Qwen2, Qwen2Scheduler, Qwen2Sequence
+from .memory_planner import MemoryPlanner
+from ..libllaisys import Qwen2RequestStatus, Qwen2PreemptionMode
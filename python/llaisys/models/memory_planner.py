@@ -0,0 +1,54 @@
+from typing import Sequence
+from ..libllaisys import LIB_LLAISYS
+from ..libllaisys import DeviceType, DataType
+from ..libllaisys import llaisysDataType_t, llaisysDeviceType_t
+
+from ctypes import c_int, c_size_t
+
+
+class MemoryPlanner:
+    """Activation memory planner of the native models.
+
+    Buffers are declared with the range of steps during which they hold live data;
+    `plan` places them into one arena, letting buffers that are never live at the
+    same time share memory.
+    """
+
+    def __init__(self):
+        self._planner = LIB_LLAISYS.llaisysMemoryPlannerCreate()
+
+    def __del__(self):
+        if hasattr(self, "_planner") and self._planner is not None:
+            LIB_LLAISYS.llaisysMemoryPlannerDestroy(self._planner)
+            self._planner = None
+
+    def request(self, shape: Sequence[int], dtype: DataType, first: int, last: int) -> int:
+        """Declare a buffer live from step `first` to `last` (inclusive) and return its id."""
+        c_shape = (c_size_t * len(shape))(*shape)
+        return LIB_LLAISYS.llaisysMemoryPlannerRequest(
+            self._planner,
+            c_shape,
+            c_size_t(len(shape)),
+            llaisysDataType_t(dtype),
+            c_size_t(first),
+            c_size_t(last),
+        )
+
+    def plan(self, device: DeviceType = DeviceType.CPU, device_id: int = 0):
+        LIB_LLAISYS.llaisysMemoryPlannerPlan(
+            self._planner, llaisysDeviceType_t(device), c_int(device_id)
+        )
+
+    def offset(self, buffer_id: int) -> int:
+        return LIB_LLAISYS.llaisysMemoryPlannerOffset(self._planner, c_size_t(buffer_id))
+
+    def bytes(self, buffer_id: int) -> int:
+        """Size of the buffer in the arena, rounded up to the placement alignment."""
+        return LIB_LLAISYS.llaisysMemoryPlannerBytes(self._planner, c_size_t(buffer_id))
+
+    def arena_bytes(self) -> int:
+        return LIB_LLAISYS.llaisysMemoryPlannerArenaBytes(self._planner)
+
+    def total_bytes(self) -> int:
+        """Memory the buffers would take if allocated separately."""
+        return LIB_LLAISYS.llaisysMemoryPlannerTotalBytes(self._planner)
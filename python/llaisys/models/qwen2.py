@@ -1,23 +1,154 @@
-from typing import Sequence
+from typing import Callable, Optional, Sequence
 from ..libllaisys import LIB_LLAISYS
-from ..libllaisys import DeviceType
+from ..libllaisys import DeviceType, DataType
+from ..libllaisys import llaisysDeviceType_t
+from ..libllaisys import LlaisysQwen2Meta
+from ..libllaisys import LlaisysQwen2SamplingParams, llaisysQwen2TokenCallback
+from ..libllaisys import Qwen2RequestStatus, llaisysQwen2RequestStatus_t
+from ..libllaisys import Qwen2PreemptionMode, LlaisysQwen2SchedulerStats
+from ..runtime import set_cpu_memory_config
 
+from ctypes import byref, c_char_p, c_float, c_int, c_int64, c_size_t, c_uint64, c_void_p
 from pathlib import Path
-import safetensors
+import json
 
 
-class Qwen2:
+_DTYPES = {
+    "float32": DataType.F32,
+    "float16": DataType.F16,
+    "bfloat16": DataType.BF16,
+}
+
 
-    def __init__(self, model_path, device: DeviceType = DeviceType.CPU):
-        # TODO: Implement model constructor
+class Qwen2:
 
+    def __init__(
+        self,
+        model_path,
+        device: DeviceType = DeviceType.CPU,
+        max_seq_len: int = 4096,
+        prefill_chunk: int = 512,
+        kv_cache_tokens: int = None,
+        kv_block_size: int = 16,
+        lock_weights: bool = False,
+        max_resident_weight_bytes: int = 0,
+        prefetch_layers: int = 2,
+    ):
         model_path = Path(model_path)
+        # A file is a model image written by save_image, a directory a Hugging Face checkpoint.
+        is_image = model_path.is_file()
+
+        if is_image:
+            self._meta = LlaisysQwen2Meta()
+            LIB_LLAISYS.llaisysQwen2ImageMeta(str(model_path).encode(), byref(self._meta))
+            self._meta.maxseq = min(self._meta.maxseq, max_seq_len)
+        else:
+            self._meta = self._read_config(model_path, max_seq_len)
+
+        device_ids = (c_int * 1)(0)
+        self._model = LIB_LLAISYS.llaisysQwen2ModelCreate(
+            byref(self._meta), llaisysDeviceType_t(device), device_ids, 1
+        )
+        # The loader maps the weights or allocates them converted; optionally keep them
+        # locked in RAM. The KV cache and workspace allocated above stay pageable.
+        if lock_weights:
+            set_cpu_memory_config(lock=True)
+        try:
+            if is_image:
+                LIB_LLAISYS.llaisysQwen2ModelLoadImage(self._model, str(model_path).encode())
+            else:
+                # The native loader memory-maps the files; weights already in the model dtype
+                # are used in place instead of being copied.
+                files = [str(f).encode() for f in sorted(model_path.glob("*.safetensors"))]
+                paths = (c_char_p * len(files))(*files)
+                LIB_LLAISYS.llaisysQwen2ModelLoadSafetensors(self._model, paths, c_size_t(len(files)))
+        finally:
+            if lock_weights:
+                set_cpu_memory_config(lock=False)
+        self._weights = LIB_LLAISYS.llaisysQwen2ModelWeights(self._model).contents
+        self.set_prefill_chunk(prefill_chunk)
+        # KV memory budget shared by all sequences (one full-length sequence by default);
+        # raise it when serving several sequences through Qwen2Scheduler.
+        if kv_cache_tokens is not None:
+            LIB_LLAISYS.llaisysQwen2ModelConfigureKVCache(
+                self._model, c_size_t(kv_block_size), c_size_t(kv_cache_tokens)
+            )
+        # Bounded weight residency for hosts that cannot hold the whole model in RAM.
+        if max_resident_weight_bytes:
+            self.set_weight_residency(max_resident_weight_bytes, prefetch_layers)
+
+    @staticmethod
+    def _read_config(model_path: Path, max_seq_len: int) -> LlaisysQwen2Meta:
+        with open(model_path / "config.json", "r") as f:
+            config = json.load(f)
+
+        # Newer transformers write `dtype` and nest rope_theta in `rope_parameters`.
+        dtype = _DTYPES[config.get("torch_dtype") or config.get("dtype") or "bfloat16"]
+        rope = config.get("rope_parameters") or {}
+        nh = config["num_attention_heads"]
+        hs = config["hidden_size"]
+        # The KV cache is preallocated for `maxseq` tokens, so do not blindly use
+        # the (very large) context length the model was trained with.
+        maxseq = min(config.get("max_position_embeddings", max_seq_len), max_seq_len)
+        end_token = config.get("eos_token_id", -1)
+        if isinstance(end_token, list):
+            end_token = end_token[0]
+
+        return LlaisysQwen2Meta(
+            dtype=dtype,
+            nlayer=config["num_hidden_layers"],
+            hs=hs,
+            nh=nh,
+            nkvh=config["num_key_value_heads"],
+            dh=config.get("head_dim", hs // nh),
+            di=config["intermediate_size"],
+            maxseq=maxseq,
+            voc=config["vocab_size"],
+            epsilon=config.get("rms_norm_eps", 1e-6),
+            theta=config.get("rope_theta", rope.get("rope_theta", 10000.0)),
+            end_token=end_token,
+        )
+
+    def set_prefill_chunk(self, chunk: int):
+        """Process at most `chunk` tokens per forward pass; bounds activation memory."""
+        LIB_LLAISYS.llaisysQwen2ModelSetPrefillChunk(self._model, c_size_t(chunk))
+
+    def set_weight_residency(self, max_resident_bytes: int, prefetch_layers: int = 2):
+        """Keep at most `max_resident_bytes` of layer weights in RAM (0 for no limit).
+
+        Layers are read back from their mapped files `prefetch_layers` layers ahead of
+        use. Needs CPU weights mapped from an image or a checkpoint in the model dtype.
+        """
+        LIB_LLAISYS.llaisysQwen2ModelSetWeightResidency(
+            self._model, c_size_t(max_resident_bytes), c_size_t(prefetch_layers)
+        )
+
+    def resident_weight_bytes(self) -> int:
+        return LIB_LLAISYS.llaisysQwen2ModelResidentWeightBytes(self._model)
+
+    def set_op_capture(self, enable: bool):
+        """Replay the recorded kernels of the first decode step for the next ones (on by default)."""
+        LIB_LLAISYS.llaisysQwen2ModelSetOpCapture(self._model, int(enable))
 
-        for file in sorted(model_path.glob("*.safetensors")):
-            data_ = safetensors.safe_open(file, framework="numpy", device="cpu")
-            for name_ in data_.keys():
-                ## TODO: load the model weights
-                pass
+    def captured_ops(self) -> int:
+        return LIB_LLAISYS.llaisysQwen2ModelCapturedOps(self._model)
+
+    def set_op_concurrency(self, enable: bool):
+        """Run independent projections of small passes side by side (on by default)."""
+        LIB_LLAISYS.llaisysQwen2ModelSetOpConcurrency(self._model, int(enable))
+
+    def save_image(self, path):
+        """Write the loaded weights to a model image that `Qwen2(path)` maps without conversion.
+
+        The image keeps this model's dtype and metadata; its max_seq_len is an upper
+        bound for models loaded from it.
+        """
+        LIB_LLAISYS.llaisysQwen2ModelSaveImage(self._model, str(path).encode())
+
+    def __del__(self):
+        if hasattr(self, "_model") and self._model is not None:
+            LIB_LLAISYS.llaisysQwen2ModelDestroy(self._model)
+            self._model = None
 
     def generate(
         self,
@@ -26,8 +157,193 @@ class Qwen2:
         top_k: int = 1,
         top_p: float = 0.8,
         temperature: float = 0.8,
+        seed: int = 0,
+        callback: Optional[Callable[[int], Optional[bool]]] = None,
     ):
+        """Generate tokens natively and return `inputs` followed by the new tokens.
+
+        `callback`, if given, is invoked with every token as soon as it is produced;
+        returning True from it cancels generation.
+        """
+        if max_new_tokens is None:
+            max_new_tokens = self._meta.maxseq - len(inputs)
+        max_new_tokens = max(0, min(max_new_tokens, self._meta.maxseq - len(inputs)))
+
+        tokens = (c_int64 * len(inputs))(*inputs)
+        out_tokens = (c_int64 * max(max_new_tokens, 1))()
+        params = LlaisysQwen2SamplingParams(
+            top_k=top_k, top_p=top_p, temperature=temperature, seed=seed
+        )
+        c_callback = llaisysQwen2TokenCallback()  # NULL
+        if callback is not None:
+            # Keep a reference for the duration of the call.
+            c_callback = llaisysQwen2TokenCallback(
+                lambda token, _: 1 if callback(int(token)) else 0
+            )
+
+        ngenerated = LIB_LLAISYS.llaisysQwen2ModelGenerate(
+            self._model,
+            tokens,
+            c_size_t(len(inputs)),
+            c_size_t(max_new_tokens),
+            byref(params),
+            c_callback,
+            None,
+            out_tokens,
+        )
+        return list(inputs) + list(out_tokens[:ngenerated])
+
+    def kv_blocks_used(self) -> int:
+        """KV blocks held by all sequences; blocks shared by forks count once."""
+        return LIB_LLAISYS.llaisysQwen2ModelKVBlocksUsed(self._model)
+
+    def sequence(self, seed: int = 0) -> "Qwen2Sequence":
+        """Create an empty sequence handle, see Qwen2Sequence."""
+        return Qwen2Sequence(self, seed)
+
+
+class Qwen2Sequence:
+    """A sequence with its own KV cache, for n-best sampling and beam search.
+
+    `fork` returns a sequence continuing from the same tokens that shares the
+    KV blocks of the prefix: the prompt is stored and computed only once.
+    """
+
+    def __init__(self, model: Qwen2, seed: int = 0, _handle=None):
+        self._model = model
+        if _handle is None:
+            _handle = LIB_LLAISYS.llaisysQwen2SequenceCreate(model._model, c_uint64(seed))
+        self._sequence = _handle
+
+    def __del__(self):
+        if hasattr(self, "_sequence") and self._sequence is not None:
+            LIB_LLAISYS.llaisysQwen2SequenceFree(self._sequence)
+            self._sequence = None
+
+    def __len__(self):
+        return LIB_LLAISYS.llaisysQwen2SequenceLength(self._sequence)
+
+    def fork(self, seed: int = 0) -> "Qwen2Sequence":
+        handle = LIB_LLAISYS.llaisysQwen2SequenceFork(self._sequence, c_uint64(seed))
+        return Qwen2Sequence(self._model, _handle=handle)
+
+    def infer(
+        self,
+        inputs: Sequence[int],
+        top_k: int = 1,
+        top_p: float = 0.8,
+        temperature: float = 0.8,
+        return_logits: bool = False,
+    ):
+        """Append `inputs` and return the next token (and its logits if `return_logits`)."""
+        tokens = (c_int64 * len(inputs))(*inputs)
+        params = LlaisysQwen2SamplingParams(top_k=top_k, top_p=top_p, temperature=temperature)
+        logits = (c_float * self._model._meta.voc)() if return_logits else None
+        token = LIB_LLAISYS.llaisysQwen2ModelInferSequence(
+            self._model._model,
+            self._sequence,
+            tokens,
+            c_size_t(len(inputs)),
+            byref(params),
+            logits,
+        )
+        return (token, list(logits)) if return_logits else token
+
+
+class Qwen2Scheduler:
+    """Continuous-batching front end serving many sequences from one Qwen2 model.
+
+    Requests can be submitted and read from any thread. A native worker thread
+    batches all running sequences into one forward pass per step. Do not call
+    `Qwen2.generate` on the same model while the scheduler exists.
+    """
+
+    def __init__(self, model: Qwen2, max_batch_seqs: int = 16):
+        self._model = model
+        self._scheduler = LIB_LLAISYS.llaisysQwen2SchedulerCreate(
+            model._model, c_size_t(max_batch_seqs)
+        )
+
+    def __del__(self):
+        if hasattr(self, "_scheduler") and self._scheduler is not None:
+            LIB_LLAISYS.llaisysQwen2SchedulerDestroy(self._scheduler)
+            self._scheduler = None
+
+    def submit(
+        self,
+        inputs: Sequence[int],
+        max_new_tokens: int = None,
+        top_k: int = 1,
+        top_p: float = 0.8,
+        temperature: float = 0.8,
+        seed: int = 0,
+        priority: int = 0,
+    ) -> int:
+        """Queue a prompt and return its request id.
+
+        Requests with a higher `priority` are admitted first and preempted last
+        when the KV cache runs out.
+        """
+        maxseq = self._model._meta.maxseq
+        if max_new_tokens is None:
+            max_new_tokens = maxseq - len(inputs)
+        max_new_tokens = max(0, min(max_new_tokens, maxseq - len(inputs)))
+
+        tokens = (c_int64 * len(inputs))(*inputs)
+        params = LlaisysQwen2SamplingParams(
+            top_k=top_k, top_p=top_p, temperature=temperature, seed=seed
+        )
+        return LIB_LLAISYS.llaisysQwen2SchedulerSubmit(
+            self._scheduler,
+            tokens,
+            c_size_t(len(inputs)),
+            c_size_t(max_new_tokens),
+            c_int(priority),
+            byref(params),
+            llaisysQwen2TokenCallback(),
+            None,
+        )
+
+    def poll(self, request_id: int, block: bool = False, max_tokens: int = 256):
+        """Return the tokens generated since the last poll and the request status.
+
+        Once the status is no longer RUNNING the request id is released.
+        """
+        out_tokens = (c_int64 * max_tokens)()
+        status = llaisysQwen2RequestStatus_t()
+        n = LIB_LLAISYS.llaisysQwen2SchedulerPoll(
+            self._scheduler,
+            c_uint64(request_id),
+            out_tokens,
+            c_size_t(max_tokens),
+            c_int(1 if block else 0),
+            byref(status),
+        )
+        return list(out_tokens[:n]), Qwen2RequestStatus(status.value)
+
+    def stream(self, request_id: int):
+        """Yield the tokens of a request as they are generated."""
+        while True:
+            tokens, status = self.poll(request_id, block=True)
+            yield from tokens
+            if status == Qwen2RequestStatus.FAILED:
+                raise RuntimeError(f"Qwen2 request {request_id} failed")
+            if status != Qwen2RequestStatus.RUNNING:
+                return
+
+    def cancel(self, request_id: int):
+        LIB_LLAISYS.llaisysQwen2SchedulerCancel(self._scheduler, c_uint64(request_id))
+
+    def pending(self) -> int:
+        """Number of requests that are queued or running."""
+        return LIB_LLAISYS.llaisysQwen2SchedulerPending(self._scheduler)
 
-        # TODO: Implement generate function
+    def set_preemption_mode(self, mode: Qwen2PreemptionMode):
+        """Swap preempted KV to host memory, or drop it and recompute on resume."""
+        LIB_LLAISYS.llaisysQwen2SchedulerSetPreemptionMode(self._scheduler, c_int(mode))
 
-        return []
+    def stats(self) -> dict:
+        """Queue, KV memory and preemption counters."""
+        stats = LlaisysQwen2SchedulerStats()
+        LIB_LLAISYS.llaisysQwen2SchedulerGetStats(self._scheduler, byref(stats))
+        return {name: getattr(stats, name) for name, _ in stats._fields_}
@@ -1,6 +1,6 @@
 from .libllaisys import LIB_LLAISYS
 from .tensor import Tensor
-from ctypes import c_float, c_int
+from ctypes import c_float, c_int, c_size_t
 
 
 class Ops:
@@ -24,6 +24,36 @@ class Ops:
             out.lib_tensor(), inp.lib_tensor(), weight.lib_tensor(), bias.lib_tensor()
         )
 
+    @staticmethod
+    def linear_argmax(max_idx: Tensor, max_val: Tensor, inp: Tensor, weight: Tensor, bias: Tensor = None):
+        LIB_LLAISYS.llaisysLinearArgmax(
+            max_idx.lib_tensor(),
+            max_val.lib_tensor(),
+            inp.lib_tensor(),
+            weight.lib_tensor(),
+            bias.lib_tensor() if bias is not None else None,
+        )
+
+    @staticmethod
+    def paged_attention(
+        attn_val: Tensor,
+        q: Tensor,
+        k_blocks: Tensor,
+        v_blocks: Tensor,
+        block_table: Tensor,
+        total_len: int,
+        scale: float,
+    ):
+        LIB_LLAISYS.llaisysPagedAttention(
+            attn_val.lib_tensor(),
+            q.lib_tensor(),
+            k_blocks.lib_tensor(),
+            v_blocks.lib_tensor(),
+            block_table.lib_tensor(),
+            c_size_t(total_len),
+            c_float(scale),
+        )
+
     @staticmethod
     def rearrange(out: Tensor, inp: Tensor):
         LIB_LLAISYS.llaisysRearrange(out.lib_tensor(), inp.lib_tensor())
@@ -40,6 +70,28 @@ class Ops:
             out.lib_tensor(), inp.lib_tensor(), pos_ids.lib_tensor(), c_float(theta)
         )
 
+    @staticmethod
+    def sample(
+        out_idx: Tensor,
+        logits: Tensor,
+        temperature: float,
+        top_k: int,
+        top_p: float,
+        random_val: float,
+    ):
+        LIB_LLAISYS.llaisysSample(
+            out_idx.lib_tensor(),
+            logits.lib_tensor(),
+            c_float(temperature),
+            c_int(top_k),
+            c_float(top_p),
+            c_float(random_val),
+        )
+
+    @staticmethod
+    def select_rows(out: Tensor, inp: Tensor, index: Tensor):
+        LIB_LLAISYS.llaisysSelectRows(out.lib_tensor(), inp.lib_tensor(), index.lib_tensor())
+
     @staticmethod
     def self_attention(attn_val: Tensor, q: Tensor, k: Tensor, v: Tensor, scale: float):
         LIB_LLAISYS.llaisysSelfAttention(
@@ -53,3 +105,25 @@ class Ops:
     @staticmethod
     def swiglu(out: Tensor, gate: Tensor, up: Tensor):
         LIB_LLAISYS.llaisysSwiGLU(out.lib_tensor(), gate.lib_tensor(), up.lib_tensor())
+
+    @staticmethod
+    def set_tracing(enabled: bool):
+        """Record every op call (name, tensors, thread, duration) while enabled."""
+        LIB_LLAISYS.llaisysOpTraceEnable(c_int(int(enabled)))
+
+    @staticmethod
+    def clear_trace():
+        LIB_LLAISYS.llaisysOpTraceClear()
+
+    @staticmethod
+    def dump_trace(path: str) -> int:
+        """Write the recorded op calls as Chrome trace JSON; returns how many."""
+        return LIB_LLAISYS.llaisysOpTraceDump(str(path).encode())
+
+    @staticmethod
+    def concurrent_threads(nbranch: int):
+        """Threads of the calling thread, and the share of them each of `nbranch`
+        independent ops run side by side would get."""
+        threads = (c_int * nbranch)()
+        total = LIB_LLAISYS.llaisysOpConcurrentThreads(c_size_t(nbranch), threads)
+        return total, list(threads)
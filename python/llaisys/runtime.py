@@ -1,13 +1,78 @@
 from . import libllaisys
 from .libllaisys import LIB_LLAISYS
-from ctypes import c_void_p
+from ctypes import byref, c_void_p
+
+
+def set_allocator(allocator: libllaisys.AllocatorType) -> None:
+    """Select the device memory allocator of the current runtime of this thread.
+
+    Must be called before any tensor is created on that device.
+    """
+    LIB_LLAISYS.llaisysSetContextAllocator(libllaisys.llaisysAllocatorType_t(allocator))
+
+
+def set_shared_runtime(shared: bool) -> None:
+    """Share one runtime per device, and its allocator cache, among all threads.
+
+    Off by default, where every thread has runtimes of its own. The selected device
+    stays per thread. Threads that already selected a device move on their next
+    device switch, so enable it before starting the threads that serve requests.
+    """
+    LIB_LLAISYS.llaisysSetSharedRuntime(int(shared))
+
+
+def set_memory_category(category: libllaisys.MemoryCategory) -> None:
+    """Count the storages allocated by this thread under `category` from now on."""
+    LIB_LLAISYS.llaisysSetMemoryCategory(libllaisys.llaisysMemoryCategory_t(category))
+
+
+def empty_cache() -> None:
+    """Return device memory cached by the current runtime's allocator."""
+    LIB_LLAISYS.llaisysContextEmptyCache()
+
+
+def set_cpu_memory_config(
+    huge_pages: bool = None,
+    huge_page_threshold: int = None,
+    lock: bool = None,
+    numa_policy: libllaisys.CpuNumaPolicy = None,
+) -> None:
+    """Configure CPU allocations made from now on; arguments left as None are unchanged.
+
+    Buffers of at least `huge_page_threshold` bytes are backed by transparent huge
+    pages if `huge_pages`, locked into RAM if `lock` (e.g. while loading weights),
+    and spread over NUMA nodes according to `numa_policy`.
+    """
+    config = libllaisys.LlaisysCpuMemoryConfig()
+    LIB_LLAISYS.llaisysGetCpuMemoryConfig(byref(config))
+    if huge_pages is not None:
+        config.huge_pages = int(huge_pages)
+    if huge_page_threshold is not None:
+        config.huge_page_threshold = huge_page_threshold
+    if lock is not None:
+        config.lock = int(lock)
+    if numa_policy is not None:
+        config.numa_policy = int(numa_policy)
+    LIB_LLAISYS.llaisysSetCpuMemoryConfig(byref(config))
+
+
+def cpu_numa_node_count() -> int:
+    return LIB_LLAISYS.llaisysCpuNumaNodeCount()
+
+
+def bind_cpu_threads() -> None:
+    """Pin the CPU worker threads to NUMA nodes in proportion to their CPUs.
+
+    Combined with CpuNumaPolicy.PARTITION, each thread's share of a GEMV reads
+    weights from its local node.
+    """
+    LIB_LLAISYS.llaisysCpuBindThreads()
 
 
 class RuntimeAPI:
     def __init__(self, device_type: libllaisys.DeviceType):
-        self._api = LIB_LLAISYS.llaisysGetRuntimeAPI(
-            libllaisys.llaisysDeviceType_t(device_type)
-        )
+        self._device_type = libllaisys.llaisysDeviceType_t(device_type)
+        self._api = LIB_LLAISYS.llaisysGetRuntimeAPI(self._device_type)
 
     def get_device_count(self) -> int:
         result = self._api.contents.get_device_count()
@@ -55,6 +120,30 @@ class RuntimeAPI:
             dst, src, size, libllaisys.llaisysMemcpyKind_t(kind)
         )
 
+    def memory_stats(self, device_id: int = 0) -> dict:
+        """Live / peak bytes and allocation counts per memory category, summed over all threads."""
+        stats = libllaisys.LlaisysMemoryStats()
+        LIB_LLAISYS.llaisysGetMemoryStats(self._device_type, device_id, byref(stats))
+        categories = {}
+        for category in libllaisys.MemoryCategory:
+            if category == libllaisys.MemoryCategory.COUNT:
+                continue
+            categories[category.name.lower()] = {
+                "live_bytes": stats.live_bytes[category],
+                "peak_bytes": stats.peak_bytes[category],
+                "allocations": stats.allocations[category],
+                "frees": stats.frees[category],
+                "size_classes": list(stats.size_classes[category]),
+            }
+        return {
+            "total_live_bytes": stats.total_live_bytes,
+            "total_peak_bytes": stats.total_peak_bytes,
+            "categories": categories,
+        }
+
+    def reset_peak_memory_stats(self, device_id: int = 0) -> None:
+        LIB_LLAISYS.llaisysResetPeakMemoryStats(self._device_type, device_id)
+
     def memcpy_async(
         self,
         dst: c_void_p,
@@ -66,3 +155,30 @@ class RuntimeAPI:
         self._api.contents.memcpy_async(
             dst, src, size, libllaisys.llaisysMemcpyKind_t(kind), stream
         )
+
+    def create_event(self) -> libllaisys.llaisysEvent_t:
+        return self._api.contents.create_event()
+
+    def destroy_event(self, event: libllaisys.llaisysEvent_t) -> None:
+        self._api.contents.destroy_event(event)
+
+    def event_record(
+        self, event: libllaisys.llaisysEvent_t, stream: libllaisys.llaisysStream_t
+    ) -> None:
+        """Mark the current end of the work enqueued on `stream`."""
+        self._api.contents.event_record(event, stream)
+
+    def stream_wait_event(
+        self, stream: libllaisys.llaisysStream_t, event: libllaisys.llaisysEvent_t
+    ) -> None:
+        """Make work enqueued on `stream` from now on wait for the last record of `event`."""
+        self._api.contents.stream_wait_event(stream, event)
+
+    def event_synchronize(self, event: libllaisys.llaisysEvent_t) -> None:
+        self._api.contents.event_synchronize(event)
+
+    def event_elapsed_time(
+        self, start: libllaisys.llaisysEvent_t, end: libllaisys.llaisysEvent_t
+    ) -> float:
+        """Milliseconds between two recorded events, once both have completed."""
+        return self._api.contents.event_elapsed_time(start, end)
@@ -0,0 +1,421 @@
+// Operator microbenchmarks over the shapes of Qwen2-1.5B.
+//
+//   llaisys-bench [--ops linear,rope] [--dtypes f32,f16,bf16] [--threads 1,4,8]
+//                 [--phases prefill,decode] [--prefill N] [--context N]
+//                 [--time SECONDS] [--samples N] [--output FILE]
+//
+// Every op is called through llaisys::ops on the CPU, as the model calls it, with the
+// shapes of one decoder layer (and of the embedding and the head) in two phases:
+// prefill runs `--prefill` new tokens of a fresh sequence, decode runs one token
+// against a context of `--context` tokens. The head (lm_head, argmax, sample) works
+// on one row in both phases and is measured under decode only. rearrange is not
+// implemented and therefore skipped.
+//
+// Build with `xmake build llaisys-bench`; it is not part of the default build.
+//
+// Each case is called in samples of enough calls to take about 200 us, until
+// `--samples` samples or `--time` seconds; the median and 99th percentile of the time
+// per call are reported as JSON together with the FLOP and byte rates they imply.
+
+#include "../ops/add/op.hpp"
+#include "../ops/argmax/op.hpp"
+#include "../ops/embedding/op.hpp"
+#include "../ops/linear/op.hpp"
+#include "../ops/linear_argmax/op.hpp"
+#include "../ops/paged_attention/op.hpp"
+#include "../ops/rms_norm/op.hpp"
+#include "../ops/rope/op.hpp"
+#include "../ops/sample/op.hpp"
+#include "../ops/select_rows/op.hpp"
+#include "../ops/self_attention/op.hpp"
+#include "../ops/swiglu/op.hpp"
+
+#include "../utils.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+using namespace llaisys;
+
+namespace {
+// Qwen2-1.5B
+constexpr size_t kHidden = 1536;
+constexpr size_t kHeads = 12;
+constexpr size_t kKVHeads = 2;
+constexpr size_t kHeadDim = 128;
+constexpr size_t kIntermediate = 8960;
+constexpr size_t kVocab = 151936;
+constexpr float kTheta = 1000000.0f;
+constexpr float kEpsilon = 1e-6f;
+constexpr size_t kBlockSize = 16; // KV block size of the model
+
+struct Options {
+    std::vector<std::string> ops;
+    std::vector<std::string> dtypes{"f32", "f16", "bf16"};
+    std::vector<int> threads;
+    std::vector<std::string> phases{"prefill", "decode"};
+    size_t prefill = 128;
+    size_t context = 1024;
+    double time = 1.0;
+    size_t samples = 100;
+    std::string output;
+};
+
+struct Case {
+    std::string op;
+    std::string name;
+    std::string tensors; // shapes, as in op traces
+    double flops;        // per call
+    double bytes;        // read and written per call
+    std::function<void()> run;
+};
+
+struct Result {
+    size_t calls;
+    size_t samples;
+    double median_us;
+    double p99_us;
+};
+
+llaisysDataType_t parseDtype(const std::string &name) {
+    if (name == "f32") {
+        return LLAISYS_DTYPE_F32;
+    }
+    if (name == "f16") {
+        return LLAISYS_DTYPE_F16;
+    }
+    if (name == "bf16") {
+        return LLAISYS_DTYPE_BF16;
+    }
+    CHECK_ARGUMENT(false, "llaisys-bench: unknown dtype " + name);
+    return LLAISYS_DTYPE_INVALID;
+}
+
+std::vector<std::string> split(const std::string &list) {
+    std::vector<std::string> items;
+    std::stringstream ss(list);
+    for (std::string item; std::getline(ss, item, ',');) {
+        if (!item.empty()) {
+            items.push_back(item);
+        }
+    }
+    return items;
+}
+
+// Uniform values in [-scale, scale) from a fixed seed, so that runs are comparable.
+tensor_t randomTensor(const std::vector<size_t> &shape, llaisysDataType_t dtype, float scale = 1.0f) {
+    auto tensor = Tensor::create(shape, dtype);
+    std::vector<std::byte> host(tensor->numel() * tensor->elementSize());
+    uint64_t state = 0x9e3779b97f4a7c15ull ^ tensor->numel();
+    for (size_t i = 0; i < tensor->numel(); i++) {
+        state = state * 6364136223846793005ull + 1442695040888963407ull;
+        const float value = (static_cast<float>(state >> 40) / static_cast<float>(1 << 24) * 2.0f - 1.0f) * scale;
+        switch (dtype) {
+        case LLAISYS_DTYPE_F32:
+            reinterpret_cast<float *>(host.data())[i] = value;
+            break;
+        case LLAISYS_DTYPE_F16:
+            reinterpret_cast<fp16_t *>(host.data())[i] = utils::cast<fp16_t>(value);
+            break;
+        case LLAISYS_DTYPE_BF16:
+            reinterpret_cast<bf16_t *>(host.data())[i] = utils::cast<bf16_t>(value);
+            break;
+        default:
+            EXCEPTION_UNSUPPORTED_DATATYPE(dtype);
+        }
+    }
+    tensor->load(host.data());
+    return tensor;
+}
+
+tensor_t indexTensor(const std::vector<int64_t> &values) {
+    auto tensor = Tensor::create({values.size()}, LLAISYS_DTYPE_I64);
+    tensor->load(values.data());
+    return tensor;
+}
+
+std::string describe(const std::vector<tensor_t> &tensors) {
+    std::string text;
+    for (const auto &tensor : tensors) {
+        text += text.empty() ? "" : " ";
+        text += utils::dtype_to_str(tensor->dtype());
+        text += "[";
+        for (size_t i = 0; i < tensor->ndim(); i++) {
+            text += (i == 0 ? "" : ",") + std::to_string(tensor->shape()[i]);
+        }
+        text += "]";
+    }
+    return text;
+}
+
+// The cases of one phase: `n` new tokens attending to `total` tokens of context.
+std::vector<Case> buildCases(const std::string &phase, size_t n, size_t total, llaisysDataType_t dtype) {
+    const double es = static_cast<double>(utils::dsize(dtype));
+    const size_t q_dim = kHeads * kHeadDim, kv_dim = kKVHeads * kHeadDim;
+    std::vector<Case> cases;
+
+    auto x = randomTensor({n, kHidden}, dtype);
+    auto y = randomTensor({n, kHidden}, dtype);
+    auto out = randomTensor({n, kHidden}, dtype);
+
+    std::vector<int64_t> ids(n), pos(n);
+    for (size_t i = 0; i < n; i++) {
+        ids[i] = static_cast<int64_t>((i * 7919) % kVocab);
+        pos[i] = static_cast<int64_t>(total - n + i);
+    }
+    auto id_tensor = indexTensor(ids);
+    auto pos_tensor = indexTensor(pos);
+
+    if (phase == "prefill") {
+        auto embed = randomTensor({kVocab, kHidden}, dtype, 0.02f);
+        cases.push_back({"embedding", "embed_tokens", describe({out, id_tensor, embed}), 0.0,
+                         (2.0 * n * kHidden) * es + n * 8.0, [=] { ops::embedding(out, id_tensor, embed); }});
+    }
+
+    auto norm_w = randomTensor({kHidden}, dtype);
+    cases.push_back({"rms_norm", "input_layernorm", describe({out, x, norm_w}), 4.0 * n * kHidden,
+                     (2.0 * n * kHidden + kHidden) * es, [=] { ops::rms_norm(out, x, norm_w, kEpsilon); }});
+
+    auto addLinear = [&](const std::string &name, size_t in_features, size_t out_features, bool bias) {
+        auto in = randomTensor({n, in_features}, dtype, 0.1f);
+        auto weight = randomTensor({out_features, in_features}, dtype, 0.02f);
+        auto b = bias ? randomTensor({out_features}, dtype) : nullptr;
+        auto o = randomTensor({n, out_features}, dtype);
+        std::vector<tensor_t> tensors{o, in, weight};
+        if (b) {
+            tensors.push_back(b);
+        }
+        const double flops = 2.0 * n * in_features * out_features + (bias ? 1.0 * n * out_features : 0.0);
+        const double bytes = (1.0 * n * in_features + 1.0 * out_features * in_features + 1.0 * n * out_features
+                              + (bias ? out_features : 0))
+                           * es;
+        cases.push_back({"linear", name, describe(tensors), flops, bytes, [=] { ops::linear(o, in, weight, b); }});
+    };
+    addLinear("q_proj", kHidden, q_dim, true);
+    addLinear("k_proj", kHidden, kv_dim, true);
+    addLinear("v_proj", kHidden, kv_dim, true);
+    addLinear("o_proj", q_dim, kHidden, false);
+    addLinear("gate_proj", kHidden, kIntermediate, false);
+    addLinear("up_proj", kHidden, kIntermediate, false);
+    addLinear("down_proj", kIntermediate, kHidden, false);
+
+    auto q = randomTensor({n, kHeads, kHeadDim}, dtype);
+    auto k = randomTensor({n, kKVHeads, kHeadDim}, dtype);
+    auto q_out = randomTensor({n, kHeads, kHeadDim}, dtype);
+    auto k_out = randomTensor({n, kKVHeads, kHeadDim}, dtype);
+    cases.push_back({"rope", "q", describe({q_out, q, pos_tensor}), 3.0 * n * q_dim, 2.0 * n * q_dim * es + n * 8.0,
+                     [=] { ops::rope(q_out, q, pos_tensor, kTheta); }});
+    cases.push_back({"rope", "k", describe({k_out, k, pos_tensor}), 3.0 * n * kv_dim, 2.0 * n * kv_dim * es + n * 8.0,
+                     [=] { ops::rope(k_out, k, pos_tensor, kTheta); }});
+
+    // Query s attends to the first total - n + s + 1 tokens.
+    double keys = 0.0;
+    for (size_t s = 0; s < n; s++) {
+        keys += static_cast<double>(total - n + s + 1);
+    }
+    const double attn_flops = 4.0 * keys * q_dim;
+    const double attn_bytes = (2.0 * n * q_dim + 2.0 * total * kv_dim) * es;
+    auto attn = randomTensor({n, kHeads, kHeadDim}, dtype);
+    auto k_cache = randomTensor({total, kKVHeads, kHeadDim}, dtype);
+    auto v_cache = randomTensor({total, kKVHeads, kHeadDim}, dtype);
+    cases.push_back({"self_attention", "attn", describe({attn, q, k_cache, v_cache}), attn_flops, attn_bytes,
+                     [=] { ops::self_attention(attn, q, k_cache, v_cache, 1.0f / std::sqrt(float(kHeadDim))); }});
+
+    const size_t nblocks = (total + kBlockSize - 1) / kBlockSize;
+    std::vector<int64_t> table(nblocks);
+    for (size_t i = 0; i < nblocks; i++) {
+        table[i] = static_cast<int64_t>(nblocks - 1 - i); // scattered, as blocks come out of a pool
+    }
+    auto k_blocks = randomTensor({nblocks, kBlockSize, kKVHeads, kHeadDim}, dtype);
+    auto v_blocks = randomTensor({nblocks, kBlockSize, kKVHeads, kHeadDim}, dtype);
+    auto table_tensor = indexTensor(table);
+    cases.push_back({"paged_attention", "attn", describe({attn, q, k_blocks, v_blocks, table_tensor}), attn_flops,
+                     attn_bytes + nblocks * 8.0, [=] {
+                         ops::paged_attention(attn, q, k_blocks, v_blocks, table_tensor, total,
+                                              1.0f / std::sqrt(float(kHeadDim)));
+                     }});
+
+    auto gate = randomTensor({n, kIntermediate}, dtype);
+    auto up = randomTensor({n, kIntermediate}, dtype);
+    auto act = randomTensor({n, kIntermediate}, dtype);
+    cases.push_back({"swiglu", "mlp", describe({act, gate, up}), 5.0 * n * kIntermediate, 3.0 * n * kIntermediate * es,
+                     [=] { ops::swiglu(act, gate, up); }});
+
+    cases.push_back({"add", "residual", describe({out, x, y}), 1.0 * n * kHidden, 3.0 * n * kHidden * es,
+                     [=] { ops::add(out, x, y); }});
+
+    if (phase == "prefill") {
+        auto last = randomTensor({1, kHidden}, dtype);
+        auto last_index = indexTensor({static_cast<int64_t>(n - 1)});
+        cases.push_back({"select_rows", "last_token", describe({last, x, last_index}), 0.0, 2.0 * kHidden * es + 8.0,
+                         [=] { ops::select_rows(last, x, last_index); }});
+    } else {
+        auto hidden = randomTensor({1, kHidden}, dtype, 0.1f);
+        auto lm_head = randomTensor({kVocab, kHidden}, dtype, 0.02f);
+        auto logits = randomTensor({1, kVocab}, dtype);
+        auto max_idx = Tensor::create({1}, LLAISYS_DTYPE_I64);
+        auto max_val = Tensor::create({1}, dtype);
+        const double head_flops = 2.0 * kHidden * kVocab;
+        const double head_bytes = (1.0 * kVocab * kHidden + kHidden) * es;
+        cases.push_back({"linear", "lm_head", describe({logits, hidden, lm_head}), head_flops,
+                         head_bytes + kVocab * es, [=] { ops::linear(logits, hidden, lm_head, nullptr); }});
+        cases.push_back({"linear_argmax", "lm_head", describe({max_idx, max_val, hidden, lm_head}), head_flops,
+                         head_bytes, [=] { ops::linear_argmax(max_idx, max_val, hidden, lm_head, nullptr); }});
+        auto vals = logits->view({kVocab});
+        cases.push_back({"argmax", "logits", describe({max_idx, max_val, vals}), 1.0 * kVocab, kVocab * es,
+                         [=] { ops::argmax(max_idx, max_val, vals); }});
+        cases.push_back({"sample", "logits", describe({max_idx, logits}), 4.0 * kVocab, kVocab * es,
+                         [=] { ops::sample(max_idx, logits, 0.8f, 50, 0.8f, 0.5f); }});
+    }
+    return cases;
+}
+
+double now() {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+Result measure(const Case &c, const Options &options) {
+    // Warm up (caches, pages, thread teams) and size the samples.
+    const double warm_start = now();
+    size_t warm_calls = 0;
+    do {
+        c.run();
+        warm_calls++;
+    } while (warm_calls < 2 || (now() - warm_start < 0.05 && warm_calls < 1000));
+    const double per_call = (now() - warm_start) / static_cast<double>(warm_calls);
+    const size_t calls = std::max<size_t>(1, static_cast<size_t>(200e-6 / per_call));
+
+    std::vector<double> times;
+    const double start = now();
+    while (times.size() < options.samples && (times.size() < 5 || now() - start < options.time)) {
+        const double t0 = now();
+        for (size_t i = 0; i < calls; i++) {
+            c.run();
+        }
+        times.push_back((now() - t0) / static_cast<double>(calls));
+    }
+    std::sort(times.begin(), times.end());
+    const size_t p99 = std::min(times.size() - 1, static_cast<size_t>(std::ceil(0.99 * times.size())) - 1);
+    return Result{calls, times.size(), times[times.size() / 2] * 1e6, times[p99] * 1e6};
+}
+
+void usage() {
+    std::cerr << "usage: llaisys-bench [--ops LIST] [--dtypes f32,f16,bf16] [--threads LIST]\n"
+                 "                     [--phases prefill,decode] [--prefill N] [--context N]\n"
+                 "                     [--time SECONDS] [--samples N] [--output FILE]\n";
+}
+
+bool parseOptions(int argc, char **argv, Options &options) {
+    for (int i = 1; i < argc; i++) {
+        const std::string arg = argv[i];
+        if (arg == "--help" || arg == "-h" || i + 1 >= argc) {
+            return false;
+        }
+        const std::string value = argv[++i];
+        if (arg == "--ops") {
+            options.ops = split(value);
+        } else if (arg == "--dtypes") {
+            options.dtypes = split(value);
+        } else if (arg == "--threads") {
+            options.threads.clear();
+            for (const auto &item : split(value)) {
+                options.threads.push_back(std::stoi(item));
+            }
+        } else if (arg == "--phases") {
+            options.phases = split(value);
+        } else if (arg == "--prefill") {
+            options.prefill = std::stoul(value);
+        } else if (arg == "--context") {
+            options.context = std::stoul(value);
+        } else if (arg == "--time") {
+            options.time = std::stod(value);
+        } else if (arg == "--samples") {
+            options.samples = std::stoul(value);
+        } else if (arg == "--output") {
+            options.output = value;
+        } else {
+            return false;
+        }
+    }
+    return options.prefill > 0 && options.context > 0 && options.samples > 0;
+}
+} // namespace
+
+int main(int argc, char **argv) {
+    Options options;
+    if (!parseOptions(argc, argv, options)) {
+        usage();
+        return 2;
+    }
+#ifdef _OPENMP
+    const int max_threads = omp_get_max_threads();
+#else
+    const int max_threads = 1;
+#endif
+    if (options.threads.empty()) {
+        options.threads = {1, std::max(1, max_threads / 2), max_threads};
+    }
+    std::sort(options.threads.begin(), options.threads.end());
+    options.threads.erase(std::unique(options.threads.begin(), options.threads.end()), options.threads.end());
+
+    std::ostringstream json;
+    json << "{\"model\":\"Qwen2-1.5B\",\"prefill_tokens\":" << options.prefill << ",\"context\":" << options.context
+         << ",\"results\":[";
+    size_t count = 0;
+    for (const auto &phase : options.phases) {
+        CHECK_ARGUMENT(phase == "prefill" || phase == "decode", "llaisys-bench: unknown phase " + phase);
+        const size_t n = phase == "prefill" ? options.prefill : 1;
+        const size_t total = phase == "prefill" ? options.prefill : options.context;
+        for (const auto &dtype_name : options.dtypes) {
+            const auto cases = buildCases(phase, n, total, parseDtype(dtype_name));
+            for (const auto &c : cases) {
+                if (!options.ops.empty() && std::find(options.ops.begin(), options.ops.end(), c.op) == options.ops.end()) {
+                    continue;
+                }
+                for (int threads : options.threads) {
+#ifdef _OPENMP
+                    omp_set_num_threads(threads);
+#endif
+                    const Result r = measure(c, options);
+                    const double seconds = r.median_us * 1e-6;
+                    char line[1024];
+                    std::snprintf(line, sizeof(line),
+                                  "%s\n{\"op\":\"%s\",\"case\":\"%s\",\"phase\":\"%s\",\"dtype\":\"%s\",\"threads\":%d,"
+                                  "\"tensors\":\"%s\",\"calls_per_sample\":%zu,\"samples\":%zu,\"median_us\":%.3f,"
+                                  "\"p99_us\":%.3f,\"gflops\":%.3f,\"gbps\":%.3f}",
+                                  count == 0 ? "" : ",", c.op.c_str(), c.name.c_str(), phase.c_str(),
+                                  dtype_name.c_str(), threads, c.tensors.c_str(), r.calls, r.samples, r.median_us,
+                                  r.p99_us, c.flops / seconds * 1e-9, c.bytes / seconds * 1e-9);
+                    json << line;
+                    count++;
+                    std::fprintf(stderr, "%-16s %-16s %-8s %-5s %3d threads: median %10.2f us, p99 %10.2f us\n",
+                                 c.op.c_str(), c.name.c_str(), phase.c_str(), dtype_name.c_str(), threads, r.median_us,
+                                 r.p99_us);
+                }
+            }
+        }
+    }
+    json << "\n]}\n";
+
+    if (options.output.empty()) {
+        std::cout << json.str();
+    } else {
+        std::ofstream file(options.output, std::ios::trunc);
+        CHECK_ARGUMENT(file.good(), "llaisys-bench: cannot create " + options.output);
+        file << json.str();
+    }
+    return 0;
+}
@@ -14,6 +14,8 @@ public:
     virtual ~MemoryAllocator() = default;
     virtual std::byte *allocate(size_t size) = 0;
     virtual void release(std::byte *memory) = 0;
+    // Return memory kept for reuse to the runtime.
+    virtual void emptyCache() {}
 };
 
 } // namespace llaisys::core
@@ -0,0 +1,175 @@
+#include "caching_allocator.hpp"
+
+#include "../../utils.hpp"
+
+#include <vector>
+
+namespace llaisys::core::allocators {
+CachingAllocator::CachingAllocator(const LlaisysRuntimeAPI *runtime_api, std::function<uint64_t()> placement_epoch,
+                                   size_t release_threshold)
+    : MemoryAllocator(runtime_api), _placement_epoch(std::move(placement_epoch)), _epoch(0),
+      _release_threshold(release_threshold), _reserved_bytes(0), _allocated_bytes(0) {
+    if (_placement_epoch) {
+        _epoch = _placement_epoch();
+    }
+}
+
+CachingAllocator::~CachingAllocator() {
+    // Memory still handed out is owned by its storages and cannot be returned here.
+    _releaseSegments(0);
+}
+
+CachingAllocator::bin_t &CachingAllocator::_bin(const Block *block) {
+    return block->small ? _small_bin : _large_bin;
+}
+
+CachingAllocator::Block *CachingAllocator::_findFree(size_t size, bool small) {
+    bin_t &bin = small ? _small_bin : _large_bin;
+    Block key{nullptr, size, small, false, 0, nullptr, nullptr};
+    // Best fit among the blocks placed under the current config.
+    for (auto it = bin.lower_bound(&key); it != bin.end(); ++it) {
+        if ((*it)->epoch == _epoch) {
+            Block *block = *it;
+            bin.erase(it);
+            return block;
+        }
+    }
+    return nullptr;
+}
+
+CachingAllocator::Block *CachingAllocator::_newSegment(size_t size, bool small) {
+    const size_t segment = small ? kSmallSegment : (size + kLargeRound - 1) / kLargeRound * kLargeRound;
+    auto *memory = static_cast<std::byte *>(_api->malloc_device(segment));
+    if (memory == nullptr) {
+        // Out of memory: give all cached segments back and retry once.
+        _releaseSegments(0);
+        memory = static_cast<std::byte *>(_api->malloc_device(segment));
+    }
+    ASSERT(memory != nullptr, "CachingAllocator: out of device memory");
+    _reserved_bytes += segment;
+    return new Block{memory, segment, small, false, _epoch, nullptr, nullptr};
+}
+
+void CachingAllocator::_freeSegment(Block *block) {
+    _bin(block).erase(block);
+    _api->free_device(block->ptr);
+    _reserved_bytes -= block->size;
+    delete block;
+}
+
+void CachingAllocator::_split(Block *block, size_t size) {
+    const size_t remaining = block->size - size;
+    // Small blocks are split down to the alignment; large ones only if the rest is large too.
+    if (block->small ? remaining < kAlignment : remaining <= kSmallSize) {
+        return;
+    }
+    auto *rest = new Block{block->ptr + size, remaining, block->small, false, block->epoch, block, block->next};
+    if (block->next != nullptr) {
+        block->next->prev = rest;
+    }
+    block->next = rest;
+    block->size = size;
+    _bin(rest).insert(rest);
+}
+
+CachingAllocator::Block *CachingAllocator::_merge(Block *block) {
+    if (block->next != nullptr && !block->next->allocated) {
+        Block *next = block->next;
+        _bin(next).erase(next);
+        block->size += next->size;
+        block->next = next->next;
+        if (next->next != nullptr) {
+            next->next->prev = block;
+        }
+        delete next;
+    }
+    if (block->prev != nullptr && !block->prev->allocated) {
+        Block *prev = block->prev;
+        _bin(prev).erase(prev);
+        prev->size += block->size;
+        prev->next = block->next;
+        if (block->next != nullptr) {
+            block->next->prev = prev;
+        }
+        delete block;
+        block = prev;
+    }
+    return block;
+}
+
+void CachingAllocator::_releaseSegments(size_t keep) {
+    std::vector<Block *> segments;
+    for (bin_t *bin : {&_large_bin, &_small_bin}) {
+        for (Block *block : *bin) {
+            if (block->prev == nullptr && block->next == nullptr) {
+                segments.push_back(block);
+            }
+        }
+    }
+    for (Block *block : segments) {
+        if (_reserved_bytes - _allocated_bytes <= keep) {
+            break;
+        }
+        _freeSegment(block);
+    }
+}
+
+std::byte *CachingAllocator::allocate(size_t size) {
+    size = (std::max<size_t>(size, 1) + kAlignment - 1) / kAlignment * kAlignment;
+    const bool small = size <= kSmallSize;
+
+    std::lock_guard<std::mutex> lock(_mutex);
+    if (_placement_epoch) {
+        const uint64_t epoch = _placement_epoch();
+        if (epoch != _epoch) {
+            // Every cached segment is now placed under an outdated config.
+            _epoch = epoch;
+            _releaseSegments(0);
+        }
+    }
+    Block *block = _findFree(size, small);
+    if (block == nullptr) {
+        block = _newSegment(size, small);
+    }
+    _split(block, size);
+    block->allocated = true;
+    _allocated[block->ptr] = block;
+    _allocated_bytes += block->size;
+    return block->ptr;
+}
+
+void CachingAllocator::release(std::byte *memory) {
+    std::lock_guard<std::mutex> lock(_mutex);
+    auto it = _allocated.find(memory);
+    ASSERT(it != _allocated.end(), "CachingAllocator: releasing memory it does not own");
+    Block *block = it->second;
+    _allocated.erase(it);
+    block->allocated = false;
+    _allocated_bytes -= block->size;
+
+    block = _merge(block);
+    _bin(block).insert(block);
+    if (block->epoch != _epoch && block->prev == nullptr && block->next == nullptr) {
+        _freeSegment(block);
+        return;
+    }
+    if (_reserved_bytes - _allocated_bytes > _release_threshold) {
+        _releaseSegments(_release_threshold);
+    }
+}
+
+void CachingAllocator::emptyCache() {
+    std::lock_guard<std::mutex> lock(_mutex);
+    _releaseSegments(0);
+}
+
+size_t CachingAllocator::reservedBytes() {
+    std::lock_guard<std::mutex> lock(_mutex);
+    return _reserved_bytes;
+}
+
+size_t CachingAllocator::allocatedBytes() {
+    std::lock_guard<std::mutex> lock(_mutex);
+    return _allocated_bytes;
+}
+} // namespace llaisys::core::allocators
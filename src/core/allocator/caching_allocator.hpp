@@ -0,0 +1,79 @@
+#pragma once
+
+#include "allocator.hpp"
+
+#include <functional>
+#include <mutex>
+#include <set>
+#include <unordered_map>
+
+namespace llaisys::core::allocators {
+// Keeps freed device memory for reuse instead of returning it to the runtime.
+//
+// Memory is obtained from the runtime in segments: requests up to kSmallSize share
+// kSmallSegment-byte segments, larger ones get a segment of their own rounded to
+// kLargeRound. A segment is carved into blocks; free blocks are binned by size
+// class (small / large) and reused best-fit, split when the remainder is worth
+// keeping, and merged with free neighbours when released. Segments that become
+// entirely free go back to the runtime once the cached bytes exceed the release
+// threshold, and all of them when an allocation from the runtime fails.
+//
+// Where the runtime places memory (CPU NUMA policy, locking) is decided when a
+// segment is obtained. `placement_epoch`, if given, changes whenever that placement
+// config does: blocks of segments from an older epoch are not handed out again, and
+// such segments go back to the runtime as soon as they are entirely free.
+class CachingAllocator : public MemoryAllocator {
+public:
+    static constexpr size_t kAlignment = 512;
+    static constexpr size_t kSmallSize = size_t(1) << 20;
+    static constexpr size_t kSmallSegment = size_t(2) << 20;
+    static constexpr size_t kLargeRound = size_t(2) << 20;
+
+private:
+    struct Block {
+        std::byte *ptr;
+        size_t size;
+        bool small;
+        bool allocated;
+        uint64_t epoch; // placement epoch of the segment
+        Block *prev; // neighbours within the same segment
+        Block *next;
+    };
+    struct BlockLess {
+        bool operator()(const Block *a, const Block *b) const {
+            return a->size != b->size ? a->size < b->size : a->ptr < b->ptr;
+        }
+    };
+    using bin_t = std::set<Block *, BlockLess>;
+
+    std::mutex _mutex;
+    bin_t _small_bin;
+    bin_t _large_bin;
+    std::unordered_map<std::byte *, Block *> _allocated;
+    std::function<uint64_t()> _placement_epoch;
+    uint64_t _epoch;
+    size_t _release_threshold;
+    size_t _reserved_bytes;  // held from the runtime
+    size_t _allocated_bytes; // handed out to callers
+
+    bin_t &_bin(const Block *block);
+    Block *_findFree(size_t size, bool small);
+    Block *_newSegment(size_t size, bool small);
+    void _freeSegment(Block *block);
+    void _split(Block *block, size_t size);
+    Block *_merge(Block *block);
+    // Return entirely free segments to the runtime until at most `keep` bytes stay cached.
+    void _releaseSegments(size_t keep);
+
+public:
+    CachingAllocator(const LlaisysRuntimeAPI *runtime_api, std::function<uint64_t()> placement_epoch = nullptr,
+                     size_t release_threshold = size_t(1) << 30);
+    ~CachingAllocator();
+    std::byte *allocate(size_t size) override;
+    void release(std::byte *memory) override;
+    void emptyCache() override;
+
+    size_t reservedBytes();
+    size_t allocatedBytes();
+};
+} // namespace llaisys::core::allocators
@@ -1,10 +1,24 @@
 #include "context.hpp"
 #include "../../utils.hpp"
+#include <atomic>
+#include <map>
+#include <mutex>
 #include <thread>
 
 namespace llaisys::core {
+namespace {
+std::atomic<bool> shared_runtime{false};
+} // namespace
 
-Context::Context() {
+void setSharedRuntime(bool shared) {
+    shared_runtime = shared;
+}
+
+bool sharedRuntime() {
+    return shared_runtime.load(std::memory_order_relaxed);
+}
+
+Context::Context() : _current_runtime(nullptr) {
     // All device types, put CPU at the end
     std::vector<llaisysDeviceType_t> device_typs;
     for (int i = 1; i < LLAISYS_DEVICE_TYPE_COUNT; i++) {
@@ -12,28 +26,24 @@ Context::Context() {
     }
     device_typs.push_back(LLAISYS_DEVICE_CPU);
 
-    // Create runtimes for each device type.
+    // Runtimes are created on first use.
     // Activate the first available device. If no other device is available, activate CPU runtime.
     for (auto device_type : device_typs) {
         const LlaisysRuntimeAPI *api_ = llaisysGetRuntimeAPI(device_type);
         int device_count = api_->get_device_count();
-        std::vector<Runtime *> runtimes_(device_count);
-        for (int device_id = 0; device_id < device_count; device_id++) {
-
-            if (_current_runtime == nullptr) {
-                auto runtime = new Runtime(device_type, device_id);
-                runtime->_activate();
-                runtimes_[device_id] = runtime;
-                _current_runtime = runtime;
-            }
+        _runtime_map[device_type] = std::vector<Runtime *>(device_count, nullptr);
+        if (_current_runtime == nullptr && device_count > 0) {
+            _current_runtime = _runtime(device_type, 0);
+            _current_runtime->_activate();
         }
-        _runtime_map[device_type] = runtimes_;
     }
 }
 
 Context::~Context() {
     // Destroy current runtime first.
-    delete _current_runtime;
+    if (_current_runtime != nullptr && !_current_runtime->isShared()) {
+        delete _current_runtime;
+    }
 
     for (auto &runtime_entry : _runtime_map) {
         std::vector<Runtime *> runtimes = runtime_entry.second;
@@ -49,19 +59,43 @@ Context::~Context() {
     _runtime_map.clear();
 }
 
+Runtime *Context::_runtime(llaisysDeviceType_t device_type, int device_id) {
+    auto &runtimes = _runtime_map[device_type];
+    CHECK_ARGUMENT((size_t)device_id < runtimes.size() && device_id >= 0, "invalid device id");
+    if (sharedRuntime()) {
+        return _sharedRuntime(device_type, device_id);
+    }
+    if (runtimes[device_id] == nullptr) {
+        runtimes[device_id] = new Runtime(device_type, device_id);
+    }
+    return runtimes[device_id];
+}
+
+Runtime *Context::_sharedRuntime(llaisysDeviceType_t device_type, int device_id) {
+    static std::mutex mutex;
+    // Never destroyed: storages of any thread may refer to them until exit.
+    static auto *runtimes = new std::map<std::pair<llaisysDeviceType_t, int>, Runtime *>();
+    std::lock_guard<std::mutex> lock(mutex);
+    Runtime *&runtime = (*runtimes)[{device_type, device_id}];
+    if (runtime == nullptr) {
+        runtime = new Runtime(device_type, device_id);
+        runtime->_is_shared = true;
+    }
+    return runtime;
+}
+
 void Context::setDevice(llaisysDeviceType_t device_type, int device_id) {
     // If doest not match the current runtime.
-    if (_current_runtime == nullptr || _current_runtime->deviceType() != device_type || _current_runtime->deviceId() != device_id) {
-        auto runtimes = _runtime_map[device_type];
-        CHECK_ARGUMENT((size_t)device_id < runtimes.size() && device_id >= 0, "invalid device id");
-        if (_current_runtime != nullptr) {
+    if (_current_runtime == nullptr || _current_runtime->deviceType() != device_type || _current_runtime->deviceId() != device_id
+        || _current_runtime->isShared() != sharedRuntime()) {
+        Runtime *runtime = _runtime(device_type, device_id);
+        // A shared runtime stays active for the other threads using it.
+        if (_current_runtime != nullptr && !_current_runtime->isShared()) {
             _current_runtime->_deactivate();
         }
-        if (runtimes[device_id] == nullptr) {
-            runtimes[device_id] = new Runtime(device_type, device_id);
-        }
-        runtimes[device_id]->_activate();
-        _current_runtime = runtimes[device_id];
+        // Also selects the device for this thread.
+        runtime->_activate();
+        _current_runtime = runtime;
     }
 }
 
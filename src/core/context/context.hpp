@@ -16,6 +16,10 @@ private:
     Runtime *_current_runtime;
     Context();
 
+    // The runtime of a device for this thread: its own, or the process-wide one when shared.
+    Runtime *_runtime(llaisysDeviceType_t device_type, int device_id);
+    static Runtime *_sharedRuntime(llaisysDeviceType_t device_type, int device_id);
+
 public:
     ~Context();
 
@@ -32,4 +36,8 @@ public:
 
     friend Context &context();
 };
+
+// Whether threads select process-wide runtimes (see llaisysSetSharedRuntime).
+void setSharedRuntime(bool shared);
+bool sharedRuntime();
 } // namespace llaisys::core
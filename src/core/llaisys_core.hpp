@@ -5,5 +5,6 @@
 #include "core.hpp"
 
 #include "context/context.hpp"
+#include "runtime/memory_stats.hpp"
 #include "runtime/runtime.hpp"
 #include "storage/storage.hpp"
@@ -0,0 +1,114 @@
+#include "metrics.hpp"
+
+#include <algorithm>
+
+namespace llaisys::core {
+LatencyHistogram::LatencyHistogram() {
+    reset();
+}
+
+size_t LatencyHistogram::bucket(uint64_t ns) {
+    size_t i = 0;
+    for (uint64_t limit = 1000; ns > limit && i + 1 < LLAISYS_LATENCY_BUCKETS; limit *= 2) {
+        i++;
+    }
+    return i;
+}
+
+void LatencyHistogram::record(uint64_t ns) {
+    _count.fetch_add(1, std::memory_order_relaxed);
+    _sum_ns.fetch_add(ns, std::memory_order_relaxed);
+    _buckets[bucket(ns)].fetch_add(1, std::memory_order_relaxed);
+}
+
+void LatencyHistogram::snapshot(LlaisysLatencyHistogram &out) const {
+    out.count = _count.load(std::memory_order_relaxed);
+    out.sum_ns = _sum_ns.load(std::memory_order_relaxed);
+    for (size_t i = 0; i < LLAISYS_LATENCY_BUCKETS; i++) {
+        out.buckets[i] = _buckets[i].load(std::memory_order_relaxed);
+    }
+}
+
+void LatencyHistogram::reset() {
+    _count.store(0, std::memory_order_relaxed);
+    _sum_ns.store(0, std::memory_order_relaxed);
+    for (auto &bucket : _buckets) {
+        bucket.store(0, std::memory_order_relaxed);
+    }
+}
+
+Metrics::Metrics() : _queue_depth(0), _running(0) {
+    reset();
+}
+
+void Metrics::recordOp(llaisysOpType_t op, uint64_t ns) {
+    _ops[op].record(ns);
+}
+
+void Metrics::recordLayer(size_t layer, uint64_t ns) {
+    _layers[std::min<size_t>(layer, LLAISYS_METRICS_MAX_LAYERS - 1)].record(ns);
+}
+
+void Metrics::recordForward(bool decode, size_t ntoken, uint64_t ns) {
+    (decode ? _decode : _prefill).record(ns);
+    (decode ? _decode_tokens : _prefill_tokens).fetch_add(ntoken, std::memory_order_relaxed);
+}
+
+void Metrics::recordRequest() {
+    _requests.fetch_add(1, std::memory_order_relaxed);
+}
+
+void Metrics::recordToken(bool first, uint64_t ns) {
+    (first ? _time_to_first_token : _inter_token).record(ns);
+}
+
+void Metrics::addQueueDepth(int64_t delta) {
+    _queue_depth.fetch_add(delta, std::memory_order_relaxed);
+}
+
+void Metrics::addRunning(int64_t delta) {
+    _running.fetch_add(delta, std::memory_order_relaxed);
+}
+
+LlaisysMetrics Metrics::snapshot() const {
+    LlaisysMetrics out{};
+    for (size_t i = 0; i < LLAISYS_OP_COUNT; i++) {
+        _ops[i].snapshot(out.ops[i]);
+    }
+    for (size_t i = 0; i < LLAISYS_METRICS_MAX_LAYERS; i++) {
+        _layers[i].snapshot(out.layers[i]);
+    }
+    _prefill.snapshot(out.prefill);
+    _decode.snapshot(out.decode);
+    out.prefill_tokens = _prefill_tokens.load(std::memory_order_relaxed);
+    out.decode_tokens = _decode_tokens.load(std::memory_order_relaxed);
+    out.requests = _requests.load(std::memory_order_relaxed);
+    _time_to_first_token.snapshot(out.time_to_first_token);
+    _inter_token.snapshot(out.inter_token);
+    out.queue_depth = static_cast<uint64_t>(std::max<int64_t>(_queue_depth.load(std::memory_order_relaxed), 0));
+    out.running = static_cast<uint64_t>(std::max<int64_t>(_running.load(std::memory_order_relaxed), 0));
+    return out;
+}
+
+void Metrics::reset() {
+    for (auto &histogram : _ops) {
+        histogram.reset();
+    }
+    for (auto &histogram : _layers) {
+        histogram.reset();
+    }
+    _prefill.reset();
+    _decode.reset();
+    _prefill_tokens.store(0, std::memory_order_relaxed);
+    _decode_tokens.store(0, std::memory_order_relaxed);
+    _requests.store(0, std::memory_order_relaxed);
+    _time_to_first_token.reset();
+    _inter_token.reset();
+}
+
+Metrics &metrics() {
+    // Never destroyed: ops may run during static destruction.
+    static auto *metrics = new Metrics();
+    return *metrics;
+}
+} // namespace llaisys::core
@@ -0,0 +1,68 @@
+#pragma once
+
+#include "llaisys/metrics.h"
+
+#include <atomic>
+#include <chrono>
+
+namespace llaisys::core {
+// Latency histogram updated with relaxed atomics; see LlaisysLatencyHistogram.
+class LatencyHistogram {
+private:
+    std::atomic<uint64_t> _count;
+    std::atomic<uint64_t> _sum_ns;
+    std::atomic<uint64_t> _buckets[LLAISYS_LATENCY_BUCKETS];
+
+public:
+    LatencyHistogram();
+
+    static size_t bucket(uint64_t ns);
+
+    void record(uint64_t ns);
+    void snapshot(LlaisysLatencyHistogram &out) const;
+    void reset();
+};
+
+// Process-wide performance metrics, see LlaisysMetrics.
+class Metrics {
+private:
+    LatencyHistogram _ops[LLAISYS_OP_COUNT];
+    LatencyHistogram _layers[LLAISYS_METRICS_MAX_LAYERS];
+    LatencyHistogram _prefill;
+    LatencyHistogram _decode;
+    std::atomic<uint64_t> _prefill_tokens;
+    std::atomic<uint64_t> _decode_tokens;
+    std::atomic<uint64_t> _requests;
+    LatencyHistogram _time_to_first_token;
+    LatencyHistogram _inter_token;
+    std::atomic<int64_t> _queue_depth;
+    std::atomic<int64_t> _running;
+
+public:
+    Metrics();
+
+    void recordOp(llaisysOpType_t op, uint64_t ns);
+    void recordLayer(size_t layer, uint64_t ns);
+    // A forward pass over `ntoken` new tokens.
+    void recordForward(bool decode, size_t ntoken, uint64_t ns);
+    void recordRequest();
+    // A generated token, `ns` after the request started if it is the first one and
+    // after the previous token otherwise.
+    void recordToken(bool first, uint64_t ns);
+    // Changes of the scheduler totals.
+    void addQueueDepth(int64_t delta);
+    void addRunning(int64_t delta);
+
+    LlaisysMetrics snapshot() const;
+    void reset();
+};
+
+Metrics &metrics();
+
+// Clock of the metrics, in nanoseconds.
+inline uint64_t metricsClock() {
+    return static_cast<uint64_t>(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch())
+            .count());
+}
+} // namespace llaisys::core
@@ -0,0 +1,78 @@
+#include "memory_stats.hpp"
+
+#include "../../utils.hpp"
+
+#include <algorithm>
+#include <map>
+#include <memory>
+
+namespace llaisys::core {
+namespace {
+thread_local llaisysMemoryCategory_t current_category = LLAISYS_MEMORY_OTHER;
+} // namespace
+
+size_t MemoryStats::sizeClass(size_t size) {
+    size_t cls = 0;
+    for (size_t limit = 1024; size > limit && cls + 1 < LLAISYS_MEMORY_SIZE_CLASSES; limit *= 2) {
+        cls++;
+    }
+    return cls;
+}
+
+void MemoryStats::recordAllocation(llaisysMemoryCategory_t category, size_t size) {
+    std::lock_guard<std::mutex> lock(_mutex);
+    _stats.live_bytes[category] += size;
+    _stats.peak_bytes[category] = std::max(_stats.peak_bytes[category], _stats.live_bytes[category]);
+    _stats.allocations[category]++;
+    _stats.size_classes[category][sizeClass(size)]++;
+    _stats.total_live_bytes += size;
+    _stats.total_peak_bytes = std::max(_stats.total_peak_bytes, _stats.total_live_bytes);
+}
+
+void MemoryStats::recordFree(llaisysMemoryCategory_t category, size_t size) {
+    std::lock_guard<std::mutex> lock(_mutex);
+    _stats.live_bytes[category] -= size;
+    _stats.frees[category]++;
+    _stats.total_live_bytes -= size;
+}
+
+LlaisysMemoryStats MemoryStats::snapshot() {
+    std::lock_guard<std::mutex> lock(_mutex);
+    return _stats;
+}
+
+void MemoryStats::resetPeak() {
+    std::lock_guard<std::mutex> lock(_mutex);
+    std::copy(std::begin(_stats.live_bytes), std::end(_stats.live_bytes), std::begin(_stats.peak_bytes));
+    _stats.total_peak_bytes = _stats.total_live_bytes;
+}
+
+MemoryStats &memoryStats(llaisysDeviceType_t device_type, int device_id) {
+    static std::mutex mutex;
+    // Never destroyed: storages may be released during static destruction.
+    static auto *stats = new std::map<std::pair<int, int>, std::unique_ptr<MemoryStats>>();
+    std::lock_guard<std::mutex> lock(mutex);
+    auto &entry = (*stats)[{device_type, device_id}];
+    if (!entry) {
+        entry = std::make_unique<MemoryStats>();
+    }
+    return *entry;
+}
+
+llaisysMemoryCategory_t memoryCategory() {
+    return current_category;
+}
+
+void setMemoryCategory(llaisysMemoryCategory_t category) {
+    CHECK_ARGUMENT(category >= 0 && category < LLAISYS_MEMORY_CATEGORY_COUNT, "invalid memory category");
+    current_category = category;
+}
+
+MemoryCategoryScope::MemoryCategoryScope(llaisysMemoryCategory_t category) : _previous(current_category) {
+    setMemoryCategory(category);
+}
+
+MemoryCategoryScope::~MemoryCategoryScope() {
+    current_category = _previous;
+}
+} // namespace llaisys::core
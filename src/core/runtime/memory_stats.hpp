@@ -0,0 +1,41 @@
+#pragma once
+
+#include "llaisys/runtime.h"
+
+#include <mutex>
+
+namespace llaisys::core {
+// Process-wide memory counters of one device, updated by every runtime of it.
+class MemoryStats {
+private:
+    std::mutex _mutex;
+    LlaisysMemoryStats _stats{};
+
+public:
+    static size_t sizeClass(size_t size);
+
+    void recordAllocation(llaisysMemoryCategory_t category, size_t size);
+    void recordFree(llaisysMemoryCategory_t category, size_t size);
+    LlaisysMemoryStats snapshot();
+    void resetPeak();
+};
+
+MemoryStats &memoryStats(llaisysDeviceType_t device_type, int device_id);
+
+// Category of the storages allocated by the calling thread.
+llaisysMemoryCategory_t memoryCategory();
+void setMemoryCategory(llaisysMemoryCategory_t category);
+
+// Tag the allocations of the calling thread with `category` until the scope ends.
+class MemoryCategoryScope {
+private:
+    llaisysMemoryCategory_t _previous;
+
+public:
+    explicit MemoryCategoryScope(llaisysMemoryCategory_t category);
+    ~MemoryCategoryScope();
+
+    MemoryCategoryScope(const MemoryCategoryScope &) = delete;
+    MemoryCategoryScope &operator=(const MemoryCategoryScope &) = delete;
+};
+} // namespace llaisys::core
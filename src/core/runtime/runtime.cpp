@@ -1,14 +1,19 @@
 #include "runtime.hpp"
 
+#include "../../device/cpu/cpu_memory.hpp"
 #include "../../device/runtime_api.hpp"
+#include "../allocator/caching_allocator.hpp"
 #include "../allocator/naive_allocator.hpp"
 
+#include "../../utils.hpp"
+
 namespace llaisys::core {
 Runtime::Runtime(llaisysDeviceType_t device_type, int device_id)
-    : _device_type(device_type), _device_id(device_id), _is_active(false) {
+    : _device_type(device_type), _device_id(device_id), _allocator(nullptr), _live_storages(0),
+      _device_stats(memoryStats(device_type, device_id)), _host_stats(memoryStats(LLAISYS_DEVICE_CPU, 0)), _is_active(false), _is_shared(false) {
     _api = llaisys::device::getRuntimeAPI(_device_type);
     _stream = _api->create_stream();
-    _allocator = new allocators::NaiveAllocator(_api);
+    setAllocator(LLAISYS_ALLOCATOR_CACHING);
 }
 
 Runtime::~Runtime() {
@@ -34,6 +39,10 @@ bool Runtime::isActive() const {
     return _is_active;
 }
 
+bool Runtime::isShared() const {
+    return _is_shared;
+}
+
 llaisysDeviceType_t Runtime::deviceType() const {
     return _device_type;
 }
@@ -47,19 +56,77 @@ const LlaisysRuntimeAPI *Runtime::api() const {
 }
 
 storage_t Runtime::allocateDeviceStorage(size_t size) {
-    return std::shared_ptr<Storage>(new Storage(_allocator->allocate(size), size, *this, false));
+    const llaisysMemoryCategory_t category = memoryCategory();
+    std::byte *memory;
+    {
+        std::shared_lock<std::shared_mutex> lock(_allocator_mutex);
+        memory = _allocator->allocate(size);
+        // Counted under the lock, so that setAllocator() sees it.
+        _live_storages++;
+    }
+    auto storage = std::shared_ptr<Storage>(new Storage(memory, size, *this, false, category));
+    _device_stats.recordAllocation(category, size);
+    return storage;
 }
 
 storage_t Runtime::allocateHostStorage(size_t size) {
-    return std::shared_ptr<Storage>(new Storage((std::byte *)_api->malloc_host(size), size, *this, true));
+    const llaisysMemoryCategory_t category = memoryCategory();
+    auto storage = std::shared_ptr<Storage>(new Storage((std::byte *)_api->malloc_host(size), size, *this, true, category));
+    _host_stats.recordAllocation(category, size);
+    return storage;
+}
+
+storage_t Runtime::wrapDeviceStorage(std::byte *memory, size_t size, std::shared_ptr<void> owner) {
+    CHECK_ARGUMENT(owner != nullptr, "Runtime: wrapped storage needs an owner");
+    const llaisysMemoryCategory_t category = memoryCategory();
+    auto storage = std::shared_ptr<Storage>(new Storage(memory, size, *this, false, category, std::move(owner)));
+    _device_stats.recordAllocation(category, size);
+    return storage;
 }
 
 void Runtime::freeStorage(Storage *storage) {
-    if (storage->isHost()) {
+    if (storage->isExternal()) {
+        _device_stats.recordFree(storage->category(), storage->size());
+    } else if (storage->isHost()) {
         _api->free_host(storage->memory());
+        _host_stats.recordFree(storage->category(), storage->size());
     } else {
+        std::shared_lock<std::shared_mutex> lock(_allocator_mutex);
         _allocator->release(storage->memory());
+        _live_storages--;
+        _device_stats.recordFree(storage->category(), storage->size());
+    }
+}
+
+void Runtime::setAllocator(llaisysAllocatorType_t type) {
+    // Other threads of a shared runtime may be allocating: check and swap under one lock.
+    std::unique_lock<std::shared_mutex> lock(_allocator_mutex);
+    CHECK_ARGUMENT(_live_storages == 0, "Runtime: cannot change the allocator while device storages are alive");
+    MemoryAllocator *allocator = nullptr;
+    switch (type) {
+    case LLAISYS_ALLOCATOR_NAIVE:
+        allocator = new allocators::NaiveAllocator(_api);
+        break;
+    case LLAISYS_ALLOCATOR_CACHING:
+        // CPU segments are placed by the CPU memory config in effect when they are mapped.
+        allocator = new allocators::CachingAllocator(
+            _api, _device_type == LLAISYS_DEVICE_CPU ? &llaisys::device::cpu::memoryConfigEpoch : nullptr);
+        break;
+    default:
+        CHECK_ARGUMENT(false, "Runtime: unknown allocator type");
     }
+    delete _allocator;
+    _allocator = allocator;
+    _allocator_type = type;
+}
+
+llaisysAllocatorType_t Runtime::allocatorType() const {
+    return _allocator_type;
+}
+
+void Runtime::emptyCache() {
+    std::shared_lock<std::shared_mutex> lock(_allocator_mutex);
+    _allocator->emptyCache();
 }
 
 llaisysStream_t Runtime::stream() const {
@@ -3,6 +3,10 @@
 
 #include "../../device/runtime_api.hpp"
 #include "../allocator/allocator.hpp"
+#include "memory_stats.hpp"
+
+#include <atomic>
+#include <shared_mutex>
 
 namespace llaisys::core {
 class Runtime {
@@ -10,8 +14,16 @@ private:
     llaisysDeviceType_t _device_type;
     int _device_id;
     const LlaisysRuntimeAPI *_api;
+    // Held shared while allocating or releasing through `_allocator`, exclusively while
+    // replacing it: threads of a shared runtime allocate concurrently.
+    mutable std::shared_mutex _allocator_mutex;
     MemoryAllocator *_allocator;
-    bool _is_active;
+    llaisysAllocatorType_t _allocator_type;
+    std::atomic<size_t> _live_storages; // device storages not yet freed, possibly by another thread
+    MemoryStats &_device_stats;
+    MemoryStats &_host_stats;
+    std::atomic<bool> _is_active; // written by every thread switching to a shared runtime
+    bool _is_shared;              // owned by the process rather than a thread's context
     void _activate();
     void _deactivate();
     llaisysStream_t _stream;
@@ -33,14 +45,23 @@ public:
     llaisysDeviceType_t deviceType() const;
     int deviceId() const;
     bool isActive() const;
+    bool isShared() const;
 
     const LlaisysRuntimeAPI *api() const;
 
     storage_t allocateDeviceStorage(size_t size);
     ;
     storage_t allocateHostStorage(size_t size);
+    // Device storage over memory that `owner` keeps alive, e.g. a mapped file on CPU.
+    storage_t wrapDeviceStorage(std::byte *memory, size_t size, std::shared_ptr<void> owner);
     void freeStorage(Storage *storage);
 
+    // Replace the device memory allocator; only allowed while no device storage is alive.
+    void setAllocator(llaisysAllocatorType_t type);
+    llaisysAllocatorType_t allocatorType() const;
+    // Return the memory cached by the allocator to the device.
+    void emptyCache();
+
     llaisysStream_t stream() const;
     void synchronize() const;
 };
@@ -3,8 +3,9 @@
 #include "../runtime/runtime.hpp"
 
 namespace llaisys::core {
-Storage::Storage(std::byte *memory, size_t size, Runtime &runtime, bool is_host)
-    : _memory(memory), _size(size), _runtime(runtime), _is_host(is_host) {}
+Storage::Storage(std::byte *memory, size_t size, Runtime &runtime, bool is_host, llaisysMemoryCategory_t category,
+                 std::shared_ptr<void> owner)
+    : _memory(memory), _size(size), _runtime(runtime), _is_host(is_host), _category(category), _owner(std::move(owner)) {}
 
 Storage::~Storage() {
     _runtime.freeStorage(this);
@@ -37,4 +38,12 @@ int Storage::deviceId() const {
 bool Storage::isHost() const {
     return _is_host;
 }
+
+llaisysMemoryCategory_t Storage::category() const {
+    return _category;
+}
+
+bool Storage::isExternal() const {
+    return _owner != nullptr;
+}
 } // namespace llaisys::core
\ No newline at end of file
@@ -1,5 +1,5 @@
 #pragma once
-#include "llaisys.h"
+#include "llaisys/runtime.h"
 
 #include "../core.hpp"
 
@@ -12,7 +12,10 @@ private:
     size_t _size;
     Runtime &_runtime;
     bool _is_host;
-    Storage(std::byte *memory, size_t size, Runtime &runtime, bool is_host);
+    llaisysMemoryCategory_t _category;
+    std::shared_ptr<void> _owner; // keeps external memory alive; null if the runtime allocated it
+    Storage(std::byte *memory, size_t size, Runtime &runtime, bool is_host, llaisysMemoryCategory_t category,
+            std::shared_ptr<void> owner = nullptr);
 
 public:
     friend class Runtime;
@@ -23,6 +26,9 @@ public:
     llaisysDeviceType_t deviceType() const;
     int deviceId() const;
     bool isHost() const;
+    llaisysMemoryCategory_t category() const;
+    // Whether the memory is owned by someone else (e.g. a file mapping) rather than the runtime.
+    bool isExternal() const;
 };
 
 }; // namespace llaisys::core
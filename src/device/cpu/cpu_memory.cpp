@@ -0,0 +1,115 @@
+#include "cpu_memory.hpp"
+#include "cpu_numa.hpp"
+
+#include "../../utils.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <cstdlib>
+#include <mutex>
+#include <unordered_map>
+
+#if defined(_WIN32)
+#include <malloc.h>
+#else
+#include <sys/mman.h>
+#endif
+
+namespace llaisys::device::cpu {
+namespace {
+std::mutex config_mutex;
+LlaisysCpuMemoryConfig config = {1, kHugePageSize, 0, LLAISYS_CPU_NUMA_DEFAULT};
+std::atomic<uint64_t> config_epoch{0};
+
+#if !defined(_WIN32)
+// Sizes of the mapped (huge-page) allocations, needed to unmap them.
+std::mutex mapped_mutex;
+std::unordered_map<void *, size_t> mapped;
+
+void *mapMemory(size_t size, bool lock, llaisysCpuNumaPolicy_t numa_policy) {
+    size = (size + kHugePageSize - 1) / kHugePageSize * kHugePageSize;
+    // Over-map by one huge page so that the buffer can start on a huge page boundary.
+    const size_t span = size + kHugePageSize;
+    void *base = mmap(nullptr, span, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (base == MAP_FAILED) {
+        return nullptr;
+    }
+    auto addr = reinterpret_cast<uintptr_t>(base);
+    auto aligned = (addr + kHugePageSize - 1) / kHugePageSize * kHugePageSize;
+    if (aligned > addr) {
+        munmap(base, aligned - addr);
+    }
+    if (aligned + size < addr + span) {
+        munmap(reinterpret_cast<void *>(aligned + size), addr + span - (aligned + size));
+    }
+    void *ptr = reinterpret_cast<void *>(aligned);
+#ifdef MADV_HUGEPAGE
+    madvise(ptr, size, MADV_HUGEPAGE);
+#endif
+    placeMemory(ptr, size, numa_policy);
+    if (lock && mlock(ptr, size) != 0) {
+        static std::once_flag warned;
+        std::call_once(warned, [] {
+            std::cerr << "[WARNING] mlock failed, CPU memory is not locked (check RLIMIT_MEMLOCK)" << std::endl;
+        });
+    }
+    std::lock_guard<std::mutex> guard(mapped_mutex);
+    mapped[ptr] = size;
+    return ptr;
+}
+#endif
+} // namespace
+
+void *allocateMemory(size_t size) {
+    const LlaisysCpuMemoryConfig current = memoryConfig();
+    size = (std::max<size_t>(size, 1) + kMemoryAlignment - 1) / kMemoryAlignment * kMemoryAlignment;
+#if defined(_WIN32)
+    (void)current;
+    return _aligned_malloc(size, kMemoryAlignment);
+#else
+    if (current.huge_pages && size >= current.huge_page_threshold) {
+        if (void *ptr = mapMemory(size, current.lock != 0, current.numa_policy)) {
+            return ptr;
+        }
+    }
+    void *ptr = nullptr;
+    return posix_memalign(&ptr, kMemoryAlignment, size) == 0 ? ptr : nullptr;
+#endif
+}
+
+void freeMemory(void *ptr) {
+    if (ptr == nullptr) {
+        return;
+    }
+#if defined(_WIN32)
+    _aligned_free(ptr);
+#else
+    {
+        std::lock_guard<std::mutex> guard(mapped_mutex);
+        auto it = mapped.find(ptr);
+        if (it != mapped.end()) {
+            munmap(ptr, it->second);
+            mapped.erase(it);
+            return;
+        }
+    }
+    std::free(ptr);
+#endif
+}
+
+void setMemoryConfig(const LlaisysCpuMemoryConfig &new_config) {
+    std::lock_guard<std::mutex> guard(config_mutex);
+    config = new_config;
+    config_epoch++;
+}
+
+LlaisysCpuMemoryConfig memoryConfig() {
+    std::lock_guard<std::mutex> guard(config_mutex);
+    return config;
+}
+
+uint64_t memoryConfigEpoch() {
+    return config_epoch.load();
+}
+} // namespace llaisys::device::cpu
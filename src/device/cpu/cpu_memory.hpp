@@ -0,0 +1,25 @@
+#pragma once
+
+#include "llaisys/runtime.h"
+
+#include <cstddef>
+#include <cstdint>
+
+namespace llaisys::device::cpu {
+// CPU buffers are aligned to kMemoryAlignment bytes. Allocations of at least
+// `huge_page_threshold` bytes are mapped directly (aligned to 2 MiB, advised for
+// transparent huge pages on Linux), placed on NUMA nodes by `numa_policy` and, if
+// `lock` is set, locked into RAM.
+constexpr size_t kMemoryAlignment = 64;
+constexpr size_t kHugePageSize = size_t(2) << 20;
+
+void *allocateMemory(size_t size);
+void freeMemory(void *ptr);
+
+void setMemoryConfig(const LlaisysCpuMemoryConfig &config);
+LlaisysCpuMemoryConfig memoryConfig();
+
+// Incremented by every setMemoryConfig(), so that cached memory placed under an
+// older config can be told apart.
+uint64_t memoryConfigEpoch();
+} // namespace llaisys::device::cpu
@@ -0,0 +1,168 @@
+#include "cpu_numa.hpp"
+
+#include "../../utils.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <thread>
+
+#if defined(__linux__)
+#include <sched.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+namespace llaisys::device::cpu {
+namespace {
+// Parse a sysfs list such as "0-3,8,10-11".
+std::vector<int> parseList(const std::string &text) {
+    std::vector<int> values;
+    std::stringstream stream(text);
+    std::string range;
+    while (std::getline(stream, range, ',')) {
+        if (range.empty() || range == "\n") {
+            continue;
+        }
+        size_t dash = range.find('-');
+        int first = std::stoi(range.substr(0, dash));
+        int last = dash == std::string::npos ? first : std::stoi(range.substr(dash + 1));
+        for (int v = first; v <= last; v++) {
+            values.push_back(v);
+        }
+    }
+    return values;
+}
+
+std::string readFile(const std::string &path) {
+    std::ifstream file(path);
+    std::string text;
+    std::getline(file, text);
+    return text;
+}
+
+std::vector<NumaNode> detectNodes() {
+    std::vector<NumaNode> nodes;
+#if defined(__linux__)
+    for (int node : parseList(readFile("/sys/devices/system/node/online"))) {
+        auto cpus = parseList(readFile("/sys/devices/system/node/node" + std::to_string(node) + "/cpulist"));
+        if (!cpus.empty()) {
+            nodes.push_back(NumaNode{node, cpus});
+        }
+    }
+#endif
+    if (nodes.empty()) {
+        NumaNode node{0, {}};
+        for (unsigned i = 0; i < std::max(1u, std::thread::hardware_concurrency()); i++) {
+            node.cpus.push_back(static_cast<int>(i));
+        }
+        nodes.push_back(node);
+    }
+    return nodes;
+}
+
+// Split `count` items into one contiguous range per node, proportional to the node's
+// CPUs: node n gets [bounds[n], bounds[n + 1]).
+std::vector<size_t> nodeBounds(size_t count) {
+    const auto &nodes = numaNodes();
+    size_t total = 0;
+    for (const auto &node : nodes) {
+        total += node.cpus.size();
+    }
+    std::vector<size_t> bounds{0};
+    size_t cpus = 0;
+    for (const auto &node : nodes) {
+        cpus += node.cpus.size();
+        bounds.push_back(count * cpus / total);
+    }
+    return bounds;
+}
+
+#if defined(__linux__) && defined(SYS_mbind)
+constexpr int kMpolPreferred = 1;
+constexpr int kMpolInterleave = 3;
+constexpr unsigned kMpolMfMove = 1 << 1;
+constexpr size_t kMaxNodes = 1024;
+
+void bindRange(void *ptr, size_t size, int mode, const std::vector<int> &nodes, unsigned flags) {
+    constexpr size_t bits = 8 * sizeof(unsigned long);
+    unsigned long mask[kMaxNodes / bits] = {};
+    for (int node : nodes) {
+        if (node >= 0 && static_cast<size_t>(node) < kMaxNodes) {
+            mask[node / bits] |= 1UL << (node % bits);
+        }
+    }
+    // Placement is a hint: a failure leaves the default first-touch policy in place.
+    syscall(SYS_mbind, ptr, size, mode, mask, kMaxNodes, flags);
+}
+#endif
+} // namespace
+
+const std::vector<NumaNode> &numaNodes() {
+    static const std::vector<NumaNode> nodes = detectNodes();
+    return nodes;
+}
+
+void placeMemory(void *ptr, size_t size, llaisysCpuNumaPolicy_t policy, bool move) {
+    const auto &nodes = numaNodes();
+    if (policy == LLAISYS_CPU_NUMA_DEFAULT || nodes.size() <= 1) {
+        return;
+    }
+#if defined(__linux__) && defined(SYS_mbind)
+    // mbind works on whole pages; a page shared with a neighbouring range keeps its placement.
+    const size_t page = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+    const auto begin = (reinterpret_cast<uintptr_t>(ptr) + page - 1) / page * page;
+    const auto end = (reinterpret_cast<uintptr_t>(ptr) + size) / page * page;
+    if (end <= begin) {
+        return;
+    }
+    auto *base = reinterpret_cast<std::byte *>(begin);
+    const unsigned flags = move ? kMpolMfMove : 0;
+    if (policy == LLAISYS_CPU_NUMA_INTERLEAVE) {
+        std::vector<int> all;
+        for (const auto &node : nodes) {
+            all.push_back(node.id);
+        }
+        bindRange(base, end - begin, kMpolInterleave, all, flags);
+        return;
+    }
+    const auto bounds = nodeBounds((end - begin) / page);
+    for (size_t n = 0; n < nodes.size(); n++) {
+        if (bounds[n + 1] > bounds[n]) {
+            bindRange(base + bounds[n] * page, (bounds[n + 1] - bounds[n]) * page, kMpolPreferred, {nodes[n].id}, flags);
+        }
+    }
+#else
+    (void)ptr;
+    (void)size;
+    (void)move;
+#endif
+}
+
+void bindThreads() {
+#if defined(__linux__) && defined(_OPENMP)
+    const auto &nodes = numaNodes();
+#pragma omp parallel
+    {
+        const auto bounds = nodeBounds(omp_get_num_threads());
+        const size_t t = omp_get_thread_num();
+        size_t n = 0;
+        while (n + 1 < nodes.size() && t >= bounds[n + 1]) {
+            n++;
+        }
+        cpu_set_t set;
+        CPU_ZERO(&set);
+        for (int cpu : nodes[n].cpus) {
+            CPU_SET(cpu, &set);
+        }
+        sched_setaffinity(0, sizeof(set), &set);
+    }
+#endif
+}
+} // namespace llaisys::device::cpu
@@ -0,0 +1,29 @@
+#pragma once
+
+#include "llaisys/runtime.h"
+
+#include <cstddef>
+#include <vector>
+
+namespace llaisys::device::cpu {
+struct NumaNode {
+    int id;
+    std::vector<int> cpus;
+};
+
+// Online NUMA nodes and their CPUs, detected once from sysfs. Machines without
+// NUMA information report a single node holding all CPUs.
+const std::vector<NumaNode> &numaNodes();
+
+// Apply `policy` to the pages of a fresh mapping before it is first touched.
+// PARTITION splits the range into one contiguous part per node, sized by the
+// node's share of CPUs, matching the statically scheduled OpenMP loops once the
+// threads are bound with bindThreads(). Only whole pages inside the range are
+// affected. With `move`, pages that are already resident (e.g. those of a mapped
+// file) are migrated as well.
+void placeMemory(void *ptr, size_t size, llaisysCpuNumaPolicy_t policy, bool move = false);
+
+// Pin the OpenMP worker threads to NUMA nodes: thread t of T runs on the node
+// whose share of CPUs covers t, so contiguous thread ranges stay node-local.
+void bindThreads();
+} // namespace llaisys::device::cpu
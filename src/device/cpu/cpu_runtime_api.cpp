@@ -1,6 +1,7 @@
 #include "../runtime_api.hpp"
+#include "cpu_memory.hpp"
+#include "cpu_stream.hpp"
 
-#include <cstdlib>
 #include <cstring>
 
 namespace llaisys::device::cpu {
@@ -15,26 +16,15 @@ void setDevice(int) {
 }
 
 void deviceSynchronize() {
-    // do nothing
-}
-
-llaisysStream_t createStream() {
-    return (llaisysStream_t)0; // null stream
-}
-
-void destroyStream(llaisysStream_t stream) {
-    // do nothing
-}
-void streamSynchronize(llaisysStream_t stream) {
-    // do nothing
+    synchronizeAll();
 }
 
 void *mallocDevice(size_t size) {
-    return std::malloc(size);
+    return allocateMemory(size);
 }
 
 void freeDevice(void *ptr) {
-    std::free(ptr);
+    freeMemory(ptr);
 }
 
 void *mallocHost(size_t size) {
@@ -50,7 +40,11 @@ void memcpySync(void *dst, const void *src, size_t size, llaisysMemcpyKind_t kin
 }
 
 void memcpyAsync(void *dst, const void *src, size_t size, llaisysMemcpyKind_t kind, llaisysStream_t stream) {
-    memcpySync(dst, src, size, kind);
+    enqueue(stream, [=] { std::memcpy(dst, src, size); });
+}
+
+void launchHostFunc(llaisysStream_t stream, llaisysHostFunc_t func, void *userdata) {
+    enqueue(stream, [=] { func(userdata); });
 }
 
 static const LlaisysRuntimeAPI RUNTIME_API = {
@@ -65,7 +59,14 @@ static const LlaisysRuntimeAPI RUNTIME_API = {
     &mallocHost,
     &freeHost,
     &memcpySync,
-    &memcpyAsync};
+    &memcpyAsync,
+    &launchHostFunc,
+    &createEvent,
+    &destroyEvent,
+    &eventRecord,
+    &streamWaitEvent,
+    &eventSynchronize,
+    &eventElapsedTime};
 
 } // namespace runtime_api
 
@@ -0,0 +1,216 @@
+#include "cpu_stream.hpp"
+
+#include "../../utils.hpp"
+
+#include <unordered_map>
+#include <vector>
+
+namespace llaisys::device::cpu {
+namespace {
+std::mutex streams_mutex;
+// Shared so that synchronizeAll() can wait on a stream outside the lock while it is being destroyed.
+std::unordered_map<Stream *, std::shared_ptr<Stream>> &liveStreams() {
+    // Never destroyed: streams may outlive static destruction.
+    static auto *streams = new std::unordered_map<Stream *, std::shared_ptr<Stream>>();
+    return *streams;
+}
+} // namespace
+
+Stream::Stream() : _busy(false), _stop(false) {}
+
+Stream::~Stream() {
+    {
+        std::unique_lock<std::mutex> lock(_mutex);
+        _cv.wait(lock, [this] { return _queue.empty() && !_busy; });
+        _stop = true;
+    }
+    _cv.notify_all();
+    if (_worker.joinable()) {
+        _worker.join();
+    }
+}
+
+void Stream::_work() {
+    std::unique_lock<std::mutex> lock(_mutex);
+    while (true) {
+        _cv.wait(lock, [this] { return _stop || !_queue.empty(); });
+        if (_queue.empty()) {
+            return;
+        }
+        std::function<void()> work = std::move(_queue.front());
+        _queue.pop_front();
+        _busy = true;
+        lock.unlock();
+        try {
+            work();
+        } catch (...) {
+            lock.lock();
+            if (!_error) {
+                _error = std::current_exception();
+            }
+            lock.unlock();
+        }
+        lock.lock();
+        _busy = false;
+        _cv.notify_all();
+    }
+}
+
+void Stream::enqueue(std::function<void()> work) {
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        if (!_worker.joinable()) {
+            _worker = std::thread(&Stream::_work, this);
+        }
+        _queue.push_back(std::move(work));
+    }
+    _cv.notify_all();
+}
+
+void Stream::drain() {
+    std::unique_lock<std::mutex> lock(_mutex);
+    _cv.wait(lock, [this] { return _queue.empty() && !_busy; });
+}
+
+void Stream::synchronize() {
+    std::unique_lock<std::mutex> lock(_mutex);
+    _cv.wait(lock, [this] { return _queue.empty() && !_busy; });
+    if (_error) {
+        std::exception_ptr error = _error;
+        _error = nullptr;
+        std::rethrow_exception(error);
+    }
+}
+
+void enqueue(llaisysStream_t stream, std::function<void()> work) {
+    if (stream == nullptr) {
+        work();
+    } else {
+        static_cast<Stream *>(stream)->enqueue(std::move(work));
+    }
+}
+
+void synchronizeAll() {
+    // Wait outside the lock, so that streams can be created and destroyed meanwhile.
+    std::vector<std::shared_ptr<Stream>> streams;
+    {
+        std::lock_guard<std::mutex> lock(streams_mutex);
+        for (const auto &[_, stream] : liveStreams()) {
+            streams.push_back(stream);
+        }
+    }
+    for (const auto &stream : streams) {
+        stream->synchronize();
+    }
+}
+
+llaisysStream_t createStream() {
+    auto stream = std::make_shared<Stream>();
+    std::lock_guard<std::mutex> lock(streams_mutex);
+    liveStreams().emplace(stream.get(), stream);
+    return stream.get();
+}
+
+void destroyStream(llaisysStream_t stream) {
+    if (stream == nullptr) {
+        return;
+    }
+    std::shared_ptr<Stream> owner;
+    {
+        std::lock_guard<std::mutex> lock(streams_mutex);
+        auto it = liveStreams().find(static_cast<Stream *>(stream));
+        owner = std::move(it->second);
+        liveStreams().erase(it);
+    }
+    // The work must be done when this returns even if synchronizeAll() holds the last reference.
+    owner->drain();
+}
+
+void streamSynchronize(llaisysStream_t stream) {
+    if (stream != nullptr) {
+        static_cast<Stream *>(stream)->synchronize();
+    }
+}
+
+Event::Event() : _state(std::make_shared<State>()) {}
+
+void Event::_wait(State &state, uint64_t record) {
+    std::unique_lock<std::mutex> lock(state.mutex);
+    state.cv.wait(lock, [&] { return state.completed >= record; });
+}
+
+void Event::record(llaisysStream_t stream) {
+    uint64_t record;
+    {
+        std::lock_guard<std::mutex> lock(_state->mutex);
+        record = ++_state->recorded;
+    }
+    enqueue(stream, [state = _state, record] {
+        {
+            std::lock_guard<std::mutex> lock(state->mutex);
+            state->time = std::chrono::steady_clock::now();
+            state->completed = record;
+        }
+        state->cv.notify_all();
+    });
+}
+
+void Event::wait(llaisysStream_t stream) {
+    uint64_t record;
+    {
+        std::lock_guard<std::mutex> lock(_state->mutex);
+        record = _state->recorded;
+    }
+    if (record == 0) {
+        return;
+    }
+    enqueue(stream, [state = _state, record] { _wait(*state, record); });
+}
+
+void Event::synchronize() {
+    uint64_t record;
+    {
+        std::lock_guard<std::mutex> lock(_state->mutex);
+        record = _state->recorded;
+    }
+    _wait(*_state, record);
+}
+
+float Event::elapsed(Event &start, Event &end) {
+    start.synchronize();
+    end.synchronize();
+    // One lock at a time: elapsed(a, b) and elapsed(b, a) may run concurrently.
+    auto completed = [](State &state, const char *message) {
+        std::lock_guard<std::mutex> lock(state.mutex);
+        CHECK_ARGUMENT(state.completed > 0, message);
+        return state.time;
+    };
+    const auto start_time = completed(*start._state, "Event: start event was never recorded");
+    const auto end_time = completed(*end._state, "Event: end event was never recorded");
+    return std::chrono::duration<float, std::milli>(end_time - start_time).count();
+}
+
+llaisysEvent_t createEvent() {
+    return new Event();
+}
+
+void destroyEvent(llaisysEvent_t event) {
+    delete static_cast<Event *>(event);
+}
+
+void eventRecord(llaisysEvent_t event, llaisysStream_t stream) {
+    static_cast<Event *>(event)->record(stream);
+}
+
+void streamWaitEvent(llaisysStream_t stream, llaisysEvent_t event) {
+    static_cast<Event *>(event)->wait(stream);
+}
+
+void eventSynchronize(llaisysEvent_t event) {
+    static_cast<Event *>(event)->synchronize();
+}
+
+float eventElapsedTime(llaisysEvent_t start, llaisysEvent_t end) {
+    return Event::elapsed(*static_cast<Event *>(start), *static_cast<Event *>(end));
+}
+} // namespace llaisys::device::cpu
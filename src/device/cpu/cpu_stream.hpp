@@ -0,0 +1,94 @@
+#pragma once
+
+#include "llaisys/runtime.h"
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+namespace llaisys::device::cpu {
+// An ordered work queue executed by its own worker thread, backing the CPU streams
+// of the runtime API. Only asynchronous copies, host functions and event steps are
+// enqueued; operators always run synchronously on the calling thread. Work enqueued
+// on one stream runs in order; different streams run concurrently with each other
+// and with the caller. The worker is started on the first enqueue, so streams that
+// only ever see synchronous work cost nothing. The null stream is not a Stream:
+// work on it runs immediately on the caller.
+class Stream {
+private:
+    std::mutex _mutex;
+    std::condition_variable _cv;
+    std::deque<std::function<void()>> _queue;
+    bool _busy;
+    bool _stop;
+    std::exception_ptr _error; // first failure, reported by the next synchronize()
+    std::thread _worker;
+
+    void _work();
+
+public:
+    Stream();
+    // Waits for the enqueued work to finish.
+    ~Stream();
+
+    Stream(const Stream &) = delete;
+    Stream &operator=(const Stream &) = delete;
+
+    void enqueue(std::function<void()> work);
+    // Wait until all work enqueued so far has run.
+    void drain();
+    // Like drain(), but rethrows the first failure.
+    void synchronize();
+};
+
+// Run `work` on `stream`, or right away if it is the null stream.
+void enqueue(llaisysStream_t stream, std::function<void()> work);
+
+// Wait for every live stream.
+void synchronizeAll();
+
+llaisysStream_t createStream();
+void destroyStream(llaisysStream_t stream);
+void streamSynchronize(llaisysStream_t stream);
+
+// A point in the work of a stream. Each record() enqueues a step that stamps the
+// time once the work before it has run; waits are on the latest record. The state
+// is shared with the enqueued steps, so an event may be destroyed while they are
+// still pending.
+class Event {
+private:
+    struct State {
+        std::mutex mutex;
+        std::condition_variable cv;
+        uint64_t recorded = 0;  // records issued
+        uint64_t completed = 0; // records reached by their stream
+        std::chrono::steady_clock::time_point time;
+    };
+    std::shared_ptr<State> _state;
+
+    static void _wait(State &state, uint64_t record);
+
+public:
+    Event();
+
+    void record(llaisysStream_t stream);
+    // Make work enqueued on `stream` from now on wait for the latest record.
+    void wait(llaisysStream_t stream);
+    void synchronize();
+    // Milliseconds between the latest records of `start` and `end`, after both complete.
+    static float elapsed(Event &start, Event &end);
+};
+
+llaisysEvent_t createEvent();
+void destroyEvent(llaisysEvent_t event);
+void eventRecord(llaisysEvent_t event, llaisysStream_t stream);
+void streamWaitEvent(llaisysStream_t stream, llaisysEvent_t event);
+void eventSynchronize(llaisysEvent_t event);
+float eventElapsedTime(llaisysEvent_t start, llaisysEvent_t end);
+} // namespace llaisys::device::cpu
@@ -53,6 +53,34 @@ void memcpyAsync(void *dst, const void *src, size_t size, llaisysMemcpyKind_t ki
     TO_BE_IMPLEMENTED();
 }
 
+void launchHostFunc(llaisysStream_t stream, llaisysHostFunc_t func, void *userdata) {
+    TO_BE_IMPLEMENTED();
+}
+
+llaisysEvent_t createEvent() {
+    TO_BE_IMPLEMENTED();
+}
+
+void destroyEvent(llaisysEvent_t event) {
+    TO_BE_IMPLEMENTED();
+}
+
+void eventRecord(llaisysEvent_t event, llaisysStream_t stream) {
+    TO_BE_IMPLEMENTED();
+}
+
+void streamWaitEvent(llaisysStream_t stream, llaisysEvent_t event) {
+    TO_BE_IMPLEMENTED();
+}
+
+void eventSynchronize(llaisysEvent_t event) {
+    TO_BE_IMPLEMENTED();
+}
+
+float eventElapsedTime(llaisysEvent_t start, llaisysEvent_t end) {
+    TO_BE_IMPLEMENTED();
+}
+
 static const LlaisysRuntimeAPI RUNTIME_API = {
     &getDeviceCount,
     &setDevice,
@@ -65,7 +93,14 @@ static const LlaisysRuntimeAPI RUNTIME_API = {
     &mallocHost,
     &freeHost,
     &memcpySync,
-    &memcpyAsync};
+    &memcpyAsync,
+    &launchHostFunc,
+    &createEvent,
+    &destroyEvent,
+    &eventRecord,
+    &streamWaitEvent,
+    &eventSynchronize,
+    &eventElapsedTime};
 
 } // namespace runtime_api
 
@@ -0,0 +1,11 @@
+#include "llaisys/metrics.h"
+#include "../core/metrics/metrics.hpp"
+
+// Llaisys API for performance metrics.
+__C void llaisysGetMetrics(LlaisysMetrics *metrics) {
+    *metrics = llaisys::core::metrics().snapshot();
+}
+
+__C void llaisysResetMetrics() {
+    llaisys::core::metrics().reset();
+}
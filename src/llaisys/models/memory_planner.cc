@@ -0,0 +1,47 @@
+#include "llaisys/models/memory_planner.h"
+
+#include "../../models/memory_planner/memory_planner.hpp"
+
+__C {
+    struct LlaisysMemoryPlanner {
+        llaisys::models::MemoryPlanner planner;
+    };
+
+    struct LlaisysMemoryPlanner *llaisysMemoryPlannerCreate() {
+        return new LlaisysMemoryPlanner{};
+    }
+
+    void llaisysMemoryPlannerDestroy(struct LlaisysMemoryPlanner * planner) {
+        delete planner;
+    }
+
+    size_t llaisysMemoryPlannerRequest(
+        struct LlaisysMemoryPlanner * planner,
+        size_t * shape,
+        size_t ndim,
+        llaisysDataType_t dtype,
+        size_t first,
+        size_t last) {
+        return planner->planner.request(std::vector<size_t>(shape, shape + ndim), dtype, first, last);
+    }
+
+    void llaisysMemoryPlannerPlan(struct LlaisysMemoryPlanner * planner, llaisysDeviceType_t device_type, int device_id) {
+        planner->planner.plan(device_type, device_id);
+    }
+
+    size_t llaisysMemoryPlannerOffset(struct LlaisysMemoryPlanner * planner, size_t id) {
+        return planner->planner.offset(id);
+    }
+
+    size_t llaisysMemoryPlannerBytes(struct LlaisysMemoryPlanner * planner, size_t id) {
+        return planner->planner.bytes(id);
+    }
+
+    size_t llaisysMemoryPlannerArenaBytes(struct LlaisysMemoryPlanner * planner) {
+        return planner->planner.arenaBytes();
+    }
+
+    size_t llaisysMemoryPlannerTotalBytes(struct LlaisysMemoryPlanner * planner) {
+        return planner->planner.totalBytes();
+    }
+}
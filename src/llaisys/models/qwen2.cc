@@ -0,0 +1,182 @@
+#include "llaisys/models/qwen2.h"
+
+#include "../../models/qwen2/qwen2.hpp"
+#include "../../models/qwen2/qwen2_scheduler.hpp"
+
+__C {
+    struct LlaisysQwen2Model {
+        llaisys::models::Qwen2 *model;
+    };
+
+    struct LlaisysQwen2Scheduler {
+        llaisys::models::Qwen2Scheduler *scheduler;
+    };
+
+    struct LlaisysQwen2Sequence {
+        llaisys::models::Qwen2 *model;
+        std::unique_ptr<llaisys::models::KVCache> cache;
+        std::mt19937_64 rng;
+    };
+
+    struct LlaisysQwen2Model *llaisysQwen2ModelCreate(const LlaisysQwen2Meta *meta, llaisysDeviceType_t device, int *device_ids, int ndevice) {
+        int device_id = (device_ids != nullptr && ndevice > 0) ? device_ids[0] : 0;
+        return new LlaisysQwen2Model{new llaisys::models::Qwen2(*meta, device, device_id)};
+    }
+
+    void llaisysQwen2ModelDestroy(struct LlaisysQwen2Model * model) {
+        delete model->model;
+        delete model;
+    }
+
+    struct LlaisysQwen2Weights *llaisysQwen2ModelWeights(struct LlaisysQwen2Model * model) {
+        return model->model->weights();
+    }
+
+    size_t llaisysQwen2ModelLoadSafetensors(struct LlaisysQwen2Model * model, const char **paths, size_t npath) {
+        return model->model->loadSafetensors(std::vector<std::string>(paths, paths + npath));
+    }
+
+    void llaisysQwen2ModelSaveImage(struct LlaisysQwen2Model * model, const char *path) {
+        model->model->saveImage(path);
+    }
+
+    void llaisysQwen2ImageMeta(const char *path, struct LlaisysQwen2Meta *meta) {
+        *meta = llaisys::models::Qwen2::imageMeta(llaisys::models::ModelImage(path));
+    }
+
+    size_t llaisysQwen2ModelLoadImage(struct LlaisysQwen2Model * model, const char *path) {
+        llaisys::models::ModelImage image(path);
+        return model->model->loadImage(image);
+    }
+
+    void llaisysQwen2ModelSetWeightResidency(struct LlaisysQwen2Model * model, size_t max_resident_bytes, size_t prefetch_layers) {
+        model->model->setWeightResidency(max_resident_bytes, prefetch_layers);
+    }
+
+    size_t llaisysQwen2ModelResidentWeightBytes(struct LlaisysQwen2Model * model) {
+        return model->model->residentWeightBytes();
+    }
+
+    void llaisysQwen2ModelSetOpCapture(struct LlaisysQwen2Model * model, int enable) {
+        model->model->setOpCapture(enable != 0);
+    }
+
+    size_t llaisysQwen2ModelCapturedOps(struct LlaisysQwen2Model * model) {
+        return model->model->capturedOps();
+    }
+
+    void llaisysQwen2ModelSetOpConcurrency(struct LlaisysQwen2Model * model, int enable) {
+        model->model->setOpConcurrency(enable != 0);
+    }
+
+    void llaisysQwen2ModelReset(struct LlaisysQwen2Model * model) {
+        model->model->reset();
+    }
+
+    void llaisysQwen2ModelConfigureKVCache(struct LlaisysQwen2Model * model, size_t block_size, size_t max_tokens) {
+        model->model->configureKVCache(block_size, max_tokens);
+    }
+
+    size_t llaisysQwen2ModelKVBlocksUsed(struct LlaisysQwen2Model * model) {
+        const llaisys::models::KVBlockPool &pool = model->model->kvPool();
+        return pool.numBlocks() - pool.numFree();
+    }
+
+    void llaisysQwen2ModelSetPrefillChunk(struct LlaisysQwen2Model * model, size_t chunk) {
+        model->model->setPrefillChunk(chunk);
+    }
+
+    void llaisysQwen2ModelPrefill(struct LlaisysQwen2Model * model, int64_t * token_ids, size_t ntoken) {
+        model->model->prefill(token_ids, ntoken);
+    }
+
+    int64_t llaisysQwen2ModelInfer(struct LlaisysQwen2Model * model, int64_t * token_ids, size_t ntoken) {
+        return model->model->infer(token_ids, ntoken);
+    }
+
+    size_t llaisysQwen2ModelGenerate(
+        struct LlaisysQwen2Model * model,
+        int64_t * token_ids,
+        size_t ntoken,
+        size_t max_new_tokens,
+        const struct LlaisysQwen2SamplingParams *params,
+        llaisysQwen2TokenCallback callback,
+        void *userdata,
+        int64_t *out_tokens) {
+        return model->model->generate(token_ids, ntoken, max_new_tokens, params, callback, userdata, out_tokens);
+    }
+
+    struct LlaisysQwen2Sequence *llaisysQwen2SequenceCreate(struct LlaisysQwen2Model * model, uint64_t seed) {
+        auto cache = model->model->createCache(model->model->meta().maxseq);
+        return new LlaisysQwen2Sequence{model->model, std::move(cache), std::mt19937_64(seed)};
+    }
+
+    struct LlaisysQwen2Sequence *llaisysQwen2SequenceFork(struct LlaisysQwen2Sequence * sequence, uint64_t seed) {
+        return new LlaisysQwen2Sequence{sequence->model, sequence->cache->fork(), std::mt19937_64(seed)};
+    }
+
+    void llaisysQwen2SequenceFree(struct LlaisysQwen2Sequence * sequence) {
+        delete sequence;
+    }
+
+    size_t llaisysQwen2SequenceLength(struct LlaisysQwen2Sequence * sequence) {
+        return sequence->cache->length();
+    }
+
+    int64_t llaisysQwen2ModelInferSequence(
+        struct LlaisysQwen2Model * model,
+        struct LlaisysQwen2Sequence * sequence,
+        int64_t * token_ids,
+        size_t ntoken,
+        const struct LlaisysQwen2SamplingParams *params,
+        float *logits) {
+        return model->model->infer(*sequence->cache, token_ids, ntoken, params, sequence->rng, logits);
+    }
+
+    struct LlaisysQwen2Scheduler *llaisysQwen2SchedulerCreate(struct LlaisysQwen2Model * model, size_t max_batch_seqs) {
+        return new LlaisysQwen2Scheduler{new llaisys::models::Qwen2Scheduler(*model->model, max_batch_seqs)};
+    }
+
+    void llaisysQwen2SchedulerDestroy(struct LlaisysQwen2Scheduler * scheduler) {
+        delete scheduler->scheduler;
+        delete scheduler;
+    }
+
+    uint64_t llaisysQwen2SchedulerSubmit(
+        struct LlaisysQwen2Scheduler * scheduler,
+        int64_t * token_ids,
+        size_t ntoken,
+        size_t max_new_tokens,
+        int priority,
+        const struct LlaisysQwen2SamplingParams *params,
+        llaisysQwen2TokenCallback callback,
+        void *userdata) {
+        return scheduler->scheduler->submit(token_ids, ntoken, max_new_tokens, priority, params, callback, userdata);
+    }
+
+    size_t llaisysQwen2SchedulerPoll(
+        struct LlaisysQwen2Scheduler * scheduler,
+        uint64_t request_id,
+        int64_t * out_tokens,
+        size_t capacity,
+        int block,
+        llaisysQwen2RequestStatus_t *status) {
+        return scheduler->scheduler->poll(request_id, out_tokens, capacity, block != 0, status);
+    }
+
+    void llaisysQwen2SchedulerCancel(struct LlaisysQwen2Scheduler * scheduler, uint64_t request_id) {
+        scheduler->scheduler->cancel(request_id);
+    }
+
+    size_t llaisysQwen2SchedulerPending(struct LlaisysQwen2Scheduler * scheduler) {
+        return scheduler->scheduler->pending();
+    }
+
+    void llaisysQwen2SchedulerSetPreemptionMode(struct LlaisysQwen2Scheduler * scheduler, llaisysQwen2PreemptionMode_t mode) {
+        scheduler->scheduler->setPreemptionMode(mode);
+    }
+
+    void llaisysQwen2SchedulerGetStats(struct LlaisysQwen2Scheduler * scheduler, struct LlaisysQwen2SchedulerStats * stats) {
+        *stats = scheduler->scheduler->stats();
+    }
+}
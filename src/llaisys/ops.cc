@@ -4,13 +4,19 @@
 
 #include "../ops/add/op.hpp"
 #include "../ops/argmax/op.hpp"
+#include "../ops/capture/capture.hpp"
 #include "../ops/embedding/op.hpp"
 #include "../ops/linear/op.hpp"
+#include "../ops/linear_argmax/op.hpp"
+#include "../ops/paged_attention/op.hpp"
 #include "../ops/rearrange/op.hpp"
 #include "../ops/rms_norm/op.hpp"
 #include "../ops/rope/op.hpp"
+#include "../ops/sample/op.hpp"
+#include "../ops/select_rows/op.hpp"
 #include "../ops/self_attention/op.hpp"
 #include "../ops/swiglu/op.hpp"
+#include "../ops/trace/trace.hpp"
 
 __C {
     void llaisysAdd(llaisysTensor_t c, llaisysTensor_t a, llaisysTensor_t b) {
@@ -25,6 +31,12 @@ __C {
     void llaisysLinear(llaisysTensor_t out, llaisysTensor_t in, llaisysTensor_t weight, llaisysTensor_t bias) {
         llaisys::ops::linear(out->tensor, in->tensor, weight->tensor, bias->tensor);
     }
+    void llaisysLinearArgmax(llaisysTensor_t max_idx, llaisysTensor_t max_val, llaisysTensor_t in, llaisysTensor_t weight, llaisysTensor_t bias) {
+        llaisys::ops::linear_argmax(max_idx->tensor, max_val->tensor, in->tensor, weight->tensor, bias ? bias->tensor : nullptr);
+    }
+    void llaisysPagedAttention(llaisysTensor_t attn_val, llaisysTensor_t q, llaisysTensor_t k_blocks, llaisysTensor_t v_blocks, llaisysTensor_t block_table, size_t total_len, float scale) {
+        llaisys::ops::paged_attention(attn_val->tensor, q->tensor, k_blocks->tensor, v_blocks->tensor, block_table->tensor, total_len, scale);
+    }
     void llaisysRearrange(llaisysTensor_t out, llaisysTensor_t in) {
         llaisys::ops::rearrange(out->tensor, in->tensor);
     }
@@ -34,10 +46,33 @@ __C {
     void llaisysROPE(llaisysTensor_t out, llaisysTensor_t in, llaisysTensor_t pos_ids, float theta) {
         llaisys::ops::rope(out->tensor, in->tensor, pos_ids->tensor, theta);
     }
+    void llaisysSample(llaisysTensor_t out_idx, llaisysTensor_t logits, float temperature, int top_k, float top_p, float random_val) {
+        llaisys::ops::sample(out_idx->tensor, logits->tensor, temperature, top_k, top_p, random_val);
+    }
+    void llaisysSelectRows(llaisysTensor_t out, llaisysTensor_t in, llaisysTensor_t index) {
+        llaisys::ops::select_rows(out->tensor, in->tensor, index->tensor);
+    }
     void llaisysSelfAttention(llaisysTensor_t attn_val, llaisysTensor_t q, llaisysTensor_t k, llaisysTensor_t v, float scale) {
         llaisys::ops::self_attention(attn_val->tensor, q->tensor, k->tensor, v->tensor, scale);
     }
     void llaisysSwiGLU(llaisysTensor_t out, llaisysTensor_t gate, llaisysTensor_t up) {
         llaisys::ops::swiglu(out->tensor, gate->tensor, up->tensor);
     }
+    void llaisysOpTraceEnable(int enabled) {
+        llaisys::ops::setTracing(enabled != 0);
+    }
+    void llaisysOpTraceClear() {
+        llaisys::ops::clearTrace();
+    }
+    size_t llaisysOpTraceDump(const char *path) {
+        return llaisys::ops::dumpTrace(path);
+    }
+    int llaisysOpConcurrentThreads(size_t nbranch, int *threads) {
+        std::vector<std::function<void()>> branches;
+        for (size_t i = 0; i < nbranch; i++) {
+            branches.push_back([threads, i] { threads[i] = llaisys::ops::availableThreads(); });
+        }
+        llaisys::ops::concurrently(branches);
+        return llaisys::ops::availableThreads();
+    }
 }
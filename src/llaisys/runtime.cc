@@ -1,5 +1,7 @@
 #include "llaisys/runtime.h"
 #include "../core/context/context.hpp"
+#include "../device/cpu/cpu_memory.hpp"
+#include "../device/cpu/cpu_numa.hpp"
 #include "../device/runtime_api.hpp"
 
 // Llaisys API for setting context runtime.
@@ -7,6 +9,49 @@ __C void llaisysSetContextRuntime(llaisysDeviceType_t device_type, int device_id
     llaisys::core::context().setDevice(device_type, device_id);
 }
 
+__C void llaisysSetSharedRuntime(int shared) {
+    llaisys::core::setSharedRuntime(shared != 0);
+}
+
+// Llaisys API for selecting the device memory allocator of the current runtime.
+__C void llaisysSetContextAllocator(llaisysAllocatorType_t type) {
+    llaisys::core::context().runtime().setAllocator(type);
+}
+
+__C void llaisysContextEmptyCache() {
+    llaisys::core::context().runtime().emptyCache();
+}
+
+// Llaisys API for configuring CPU memory allocation.
+__C void llaisysSetCpuMemoryConfig(const LlaisysCpuMemoryConfig *config) {
+    llaisys::device::cpu::setMemoryConfig(*config);
+}
+
+__C void llaisysGetCpuMemoryConfig(LlaisysCpuMemoryConfig *config) {
+    *config = llaisys::device::cpu::memoryConfig();
+}
+
+// Llaisys API for memory telemetry.
+__C void llaisysGetMemoryStats(llaisysDeviceType_t device_type, int device_id, LlaisysMemoryStats *stats) {
+    *stats = llaisys::core::memoryStats(device_type, device_id).snapshot();
+}
+
+__C void llaisysResetPeakMemoryStats(llaisysDeviceType_t device_type, int device_id) {
+    llaisys::core::memoryStats(device_type, device_id).resetPeak();
+}
+
+__C void llaisysSetMemoryCategory(llaisysMemoryCategory_t category) {
+    llaisys::core::setMemoryCategory(category);
+}
+
+__C int llaisysCpuNumaNodeCount() {
+    return static_cast<int>(llaisys::device::cpu::numaNodes().size());
+}
+
+__C void llaisysCpuBindThreads() {
+    llaisys::device::cpu::bindThreads();
+}
+
 // Llaisys API for getting the runtime APIs
 __C const LlaisysRuntimeAPI *llaisysGetRuntimeAPI(llaisysDeviceType_t device_type) {
     return llaisys::device::getRuntimeAPI(device_type);
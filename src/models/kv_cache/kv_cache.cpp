@@ -0,0 +1,267 @@
+#include "kv_cache.hpp"
+
+#include "../../core/llaisys_core.hpp"
+#include "../../utils.hpp"
+
+#include <algorithm>
+
+namespace llaisys::models {
+KVBlockPool::KVBlockPool(size_t nlayer, size_t nblocks, size_t block_size, size_t nkvh, size_t dh,
+                         llaisysDataType_t dtype, llaisysDeviceType_t device_type, int device_id)
+    : _block_size(block_size) {
+    CHECK_ARGUMENT(nblocks > 0 && block_size > 0, "KVBlockPool: nblocks and block_size must be positive");
+    core::MemoryCategoryScope scope(LLAISYS_MEMORY_KV_CACHE);
+    _k.resize(nlayer);
+    _v.resize(nlayer);
+    for (size_t i = 0; i < nlayer; i++) {
+        _k[i] = Tensor::create({nblocks, block_size, nkvh, dh}, dtype, device_type, device_id);
+        _v[i] = Tensor::create({nblocks, block_size, nkvh, dh}, dtype, device_type, device_id);
+    }
+    // Hand out low block indices first.
+    _refs.assign(nblocks, 0);
+    _free.resize(nblocks);
+    for (size_t i = 0; i < nblocks; i++) {
+        _free[i] = static_cast<int64_t>(nblocks - 1 - i);
+    }
+}
+
+size_t KVBlockPool::numLayers() const {
+    return _k.size();
+}
+
+size_t KVBlockPool::blockSize() const {
+    return _block_size;
+}
+
+size_t KVBlockPool::numBlocks() const {
+    return _k.empty() ? 0 : _k[0]->shape()[0];
+}
+
+size_t KVBlockPool::numFree() const {
+    return _free.size();
+}
+
+size_t KVBlockPool::rowBytes() const {
+    return _k[0]->shape()[2] * _k[0]->shape()[3] * _k[0]->elementSize();
+}
+
+size_t KVBlockPool::blockBytes() const {
+    return 2 * _k.size() * _block_size * rowBytes();
+}
+
+size_t KVBlockPool::blocksFor(size_t ntoken) const {
+    return (ntoken + _block_size - 1) / _block_size;
+}
+
+tensor_t KVBlockPool::keys(size_t layer) const {
+    return _k[layer];
+}
+
+tensor_t KVBlockPool::values(size_t layer) const {
+    return _v[layer];
+}
+
+bool KVBlockPool::allocate(size_t n, std::vector<int64_t> &blocks) {
+    if (n > _free.size()) {
+        return false;
+    }
+    for (size_t i = 0; i < n; i++) {
+        blocks.push_back(_free.back());
+        _refs[_free.back()] = 1;
+        _free.pop_back();
+    }
+    return true;
+}
+
+void KVBlockPool::retain(int64_t block) {
+    _refs[block]++;
+}
+
+void KVBlockPool::release(int64_t block) {
+    if (--_refs[block] == 0) {
+        _free.push_back(block);
+    }
+}
+
+uint32_t KVBlockPool::refCount(int64_t block) const {
+    return _refs[block];
+}
+
+void KVBlockPool::copyBlock(int64_t dst, int64_t src) {
+    const size_t bytes = _block_size * rowBytes();
+    core::context().setDevice(_k[0]->deviceType(), _k[0]->deviceId());
+    const LlaisysRuntimeAPI *api = core::context().runtime().api();
+    const llaisysMemcpyKind_t kind = _k[0]->deviceType() == LLAISYS_DEVICE_CPU ? LLAISYS_MEMCPY_H2H : LLAISYS_MEMCPY_D2D;
+    for (size_t l = 0; l < _k.size(); l++) {
+        for (const tensor_t &pool : {_k[l], _v[l]}) {
+            std::byte *base = const_cast<std::byte *>(pool->data());
+            api->memcpy_sync(base + dst * bytes, base + src * bytes, bytes, kind);
+        }
+    }
+}
+
+KVCache::KVCache(KVBlockPool &pool, size_t capacity)
+    : _pool(pool), _capacity(capacity), _length(0), _table_dirty(false) {
+    CHECK_ARGUMENT(capacity > 0, "KVCache: capacity must be positive");
+    core::MemoryCategoryScope scope(LLAISYS_MEMORY_KV_CACHE);
+    const tensor_t &k = pool.keys(0);
+    _table = Tensor::create({pool.blocksFor(capacity)}, LLAISYS_DTYPE_I64, k->deviceType(), k->deviceId());
+}
+
+KVCache::~KVCache() {
+    reset();
+}
+
+KVBlockPool &KVCache::pool() const {
+    return _pool;
+}
+
+size_t KVCache::capacity() const {
+    return _capacity;
+}
+
+size_t KVCache::length() const {
+    return _length;
+}
+
+size_t KVCache::numBlocks() const {
+    return _blocks.size();
+}
+
+size_t KVCache::bytes() const {
+    return _blocks.size() * _pool.blockBytes();
+}
+
+bool KVCache::_sharedTail() const {
+    // Full blocks are never written again, but the partially filled last block is.
+    return _length % _pool.blockSize() != 0 && _pool.refCount(_blocks[_length / _pool.blockSize()]) > 1;
+}
+
+std::unique_ptr<KVCache> KVCache::fork() const {
+    auto child = std::make_unique<KVCache>(_pool, _capacity);
+    // Only blocks holding valid positions are shared.
+    for (size_t i = 0; i < _pool.blocksFor(_length); i++) {
+        _pool.retain(_blocks[i]);
+        child->_blocks.push_back(_blocks[i]);
+    }
+    child->_length = _length;
+    child->_table_dirty = true;
+    return child;
+}
+
+size_t KVCache::blocksNeeded(size_t ntoken) const {
+    size_t needed = _pool.blocksFor(_length + ntoken);
+    size_t extra = needed > _blocks.size() ? needed - _blocks.size() : 0;
+    return extra + (ntoken > 0 && _sharedTail() ? 1 : 0);
+}
+
+bool KVCache::reserve(size_t ntoken) {
+    CHECK_ARGUMENT(_length + ntoken <= _capacity, "KVCache: capacity exceeded");
+    size_t needed = blocksNeeded(ntoken);
+    if (needed == 0) {
+        return true;
+    }
+    std::vector<int64_t> blocks;
+    if (!_pool.allocate(needed, blocks)) {
+        return false;
+    }
+    size_t next = 0;
+    if (_sharedTail()) {
+        // Copy-on-write of the shared last block.
+        int64_t &shared = _blocks[_length / _pool.blockSize()];
+        _pool.copyBlock(blocks[next], shared);
+        _pool.release(shared);
+        shared = blocks[next++];
+    }
+    _blocks.insert(_blocks.end(), blocks.begin() + next, blocks.end());
+    _table_dirty = true;
+    return true;
+}
+
+tensor_t KVCache::blockTable() {
+    auto table = _table->slice(0, 0, _blocks.size());
+    if (_table_dirty) {
+        table->load(_blocks.data());
+        _table_dirty = false;
+    }
+    return table;
+}
+
+void KVCache::_copyRows(size_t layer, size_t pos, size_t ntoken, std::byte *k, std::byte *v,
+                        bool to_cache, bool host_buffer) const {
+    const tensor_t &k_pool = _pool.keys(layer);
+    const tensor_t &v_pool = _pool.values(layer);
+    const size_t block_size = _pool.blockSize();
+    const size_t row_bytes = _pool.rowBytes();
+
+    core::context().setDevice(k_pool->deviceType(), k_pool->deviceId());
+    const LlaisysRuntimeAPI *api = core::context().runtime().api();
+    llaisysMemcpyKind_t kind = LLAISYS_MEMCPY_H2H;
+    if (k_pool->deviceType() != LLAISYS_DEVICE_CPU) {
+        if (!host_buffer) {
+            kind = LLAISYS_MEMCPY_D2D;
+        } else {
+            kind = to_cache ? LLAISYS_MEMCPY_H2D : LLAISYS_MEMCPY_D2H;
+        }
+    }
+
+    for (size_t done = 0; done < ntoken;) {
+        const size_t p = pos + done;
+        const size_t off = p % block_size;
+        const size_t n = std::min(block_size - off, ntoken - done);
+        const size_t row = static_cast<size_t>(_blocks[p / block_size]) * block_size + off;
+        std::byte *k_cache = const_cast<std::byte *>(k_pool->data()) + row * row_bytes;
+        std::byte *v_cache = const_cast<std::byte *>(v_pool->data()) + row * row_bytes;
+        if (to_cache) {
+            api->memcpy_sync(k_cache, k + done * row_bytes, n * row_bytes, kind);
+            api->memcpy_sync(v_cache, v + done * row_bytes, n * row_bytes, kind);
+        } else {
+            api->memcpy_sync(k + done * row_bytes, k_cache, n * row_bytes, kind);
+            api->memcpy_sync(v + done * row_bytes, v_cache, n * row_bytes, kind);
+        }
+        done += n;
+    }
+}
+
+void KVCache::write(size_t layer, tensor_t k, tensor_t v) {
+    const size_t ntoken = k->shape()[0];
+    CHECK_ARGUMENT(_pool.blocksFor(_length + ntoken) <= _blocks.size(), "KVCache: write beyond reserved blocks");
+    ASSERT(k->isContiguous() && v->isContiguous(), "KVCache: keys and values must be contiguous");
+    _copyRows(layer, _length, ntoken, k->data(), v->data(), true, false);
+}
+
+void KVCache::append(size_t ntoken) {
+    CHECK_ARGUMENT(_pool.blocksFor(_length + ntoken) <= _blocks.size(), "KVCache: append beyond reserved blocks");
+    _length += ntoken;
+}
+
+void KVCache::reset() {
+    for (int64_t block : _blocks) {
+        _pool.release(block);
+    }
+    _blocks.clear();
+    _length = 0;
+    _table_dirty = true;
+}
+
+void KVCache::save(std::vector<std::byte> &host) const {
+    const size_t layer_bytes = _length * _pool.rowBytes();
+    host.resize(2 * _pool.numLayers() * layer_bytes);
+    for (size_t l = 0; l < _pool.numLayers(); l++) {
+        std::byte *k = host.data() + 2 * l * layer_bytes;
+        _copyRows(l, 0, _length, k, k + layer_bytes, false, true);
+    }
+}
+
+void KVCache::restore(const std::vector<std::byte> &host, size_t length) {
+    const size_t layer_bytes = length * _pool.rowBytes();
+    CHECK_ARGUMENT(host.size() == 2 * _pool.numLayers() * layer_bytes, "KVCache: saved buffer does not match length");
+    reset();
+    CHECK_ARGUMENT(reserve(length), "KVCache: not enough free blocks to restore");
+    for (size_t l = 0; l < _pool.numLayers(); l++) {
+        std::byte *k = const_cast<std::byte *>(host.data()) + 2 * l * layer_bytes;
+        _copyRows(l, 0, length, k, k + layer_bytes, true, true);
+    }
+    _length = length;
+}
+} // namespace llaisys::models
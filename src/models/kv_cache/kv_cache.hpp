@@ -0,0 +1,110 @@
+#pragma once
+
+#include "../../tensor/tensor.hpp"
+
+#include <memory>
+#include <vector>
+
+namespace llaisys::models {
+// Fixed budget of KV memory shared by all sequences of a model. Keys and values
+// of every layer live in [nblocks, block_size, nkvh, dh] pools; a sequence holds
+// a list of blocks and grows one block at a time. Blocks are reference counted
+// so that forked sequences can share their common prefix.
+class KVBlockPool {
+private:
+    std::vector<tensor_t> _k;
+    std::vector<tensor_t> _v;
+    size_t _block_size;
+    std::vector<int64_t> _free;
+    std::vector<uint32_t> _refs;
+
+public:
+    KVBlockPool(size_t nlayer, size_t nblocks, size_t block_size, size_t nkvh, size_t dh,
+                llaisysDataType_t dtype, llaisysDeviceType_t device_type, int device_id);
+
+    // Prevent copying
+    KVBlockPool(const KVBlockPool &) = delete;
+    KVBlockPool &operator=(const KVBlockPool &) = delete;
+
+    size_t numLayers() const;
+    size_t blockSize() const;
+    size_t numBlocks() const;
+    size_t numFree() const;
+    // Bytes of the keys (or values) of one token in one layer.
+    size_t rowBytes() const;
+    // Bytes of keys and values held by one block across all layers.
+    size_t blockBytes() const;
+    // Blocks needed to hold `ntoken` tokens.
+    size_t blocksFor(size_t ntoken) const;
+
+    tensor_t keys(size_t layer) const;
+    tensor_t values(size_t layer) const;
+
+    // Take `n` free blocks, or none at all if fewer are available.
+    bool allocate(size_t n, std::vector<int64_t> &blocks);
+    void retain(int64_t block);
+    // Drop one reference; the block becomes free with the last one.
+    void release(int64_t block);
+    uint32_t refCount(int64_t block) const;
+    // Copy keys and values of every layer from block `src` to block `dst`.
+    void copyBlock(int64_t dst, int64_t src);
+};
+
+// Keys and values of one sequence: the first `length()` positions of its blocks.
+// Blocks shared with a fork are copied before the first write into them.
+class KVCache {
+private:
+    KVBlockPool &_pool;
+    size_t _capacity;
+    size_t _length;
+    std::vector<int64_t> _blocks;
+    tensor_t _table; // [blocksFor(capacity)] device copy of `_blocks`
+    bool _table_dirty;
+
+    // Copy positions [pos, pos + ntoken) of one layer between the blocks and dense
+    // [ntoken, nkvh, dh] buffers `k` / `v`, which live on the device unless `host_buffer`.
+    void _copyRows(size_t layer, size_t pos, size_t ntoken, std::byte *k, std::byte *v,
+                   bool to_cache, bool host_buffer) const;
+    // Whether the next write lands in a partially filled block shared with another sequence.
+    bool _sharedTail() const;
+
+public:
+    KVCache(KVBlockPool &pool, size_t capacity);
+    ~KVCache();
+
+    // Prevent copying
+    KVCache(const KVCache &) = delete;
+    KVCache &operator=(const KVCache &) = delete;
+
+    KVBlockPool &pool() const;
+    size_t capacity() const;
+    size_t length() const;
+    size_t numBlocks() const;
+    // Bytes of KV memory held by this sequence.
+    size_t bytes() const;
+
+    // New sequence sharing all blocks of this one (copy-on-write).
+    std::unique_ptr<KVCache> fork() const;
+
+    // Additional blocks needed before `ntoken` more tokens can be appended,
+    // including the private copy of a shared partially filled block.
+    size_t blocksNeeded(size_t ntoken) const;
+    // Make room for `ntoken` more tokens; returns false (and takes nothing) if the
+    // pool does not have enough free blocks.
+    bool reserve(size_t ntoken);
+    // Block indices of the valid positions, see ops::paged_attention.
+    tensor_t blockTable();
+
+    // Store [ntoken, nkvh, dh] keys and values for positions [length(), length() + ntoken).
+    void write(size_t layer, tensor_t k, tensor_t v);
+    // Mark `ntoken` more positions as valid once they have been written for every layer.
+    void append(size_t ntoken);
+    // Drop all positions and return the blocks to the pool.
+    void reset();
+
+    // Copy the valid positions of every layer, in the cache dtype, into a host buffer
+    // holding only those positions / back into freshly reserved blocks.
+    void save(std::vector<std::byte> &host) const;
+    void restore(const std::vector<std::byte> &host, size_t length);
+};
+} // namespace llaisys::models
@@ -0,0 +1,103 @@
+#include "mapped_file.hpp"
+
+#include "../../core/llaisys_core.hpp"
+#include "../../device/cpu/cpu_memory.hpp"
+#include "../../device/cpu/cpu_numa.hpp"
+#include "../../utils.hpp"
+
+#include <fstream>
+#include <iostream>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace llaisys::models {
+MappedFile::MappedFile(const std::string &path) : _path(path), _data(nullptr), _size(0), _locked(false) {
+#ifndef _WIN32
+    int fd = ::open(path.c_str(), O_RDONLY);
+    CHECK_ARGUMENT(fd >= 0, "MappedFile: cannot open file");
+    struct stat st;
+    if (::fstat(fd, &st) != 0 || st.st_size == 0) {
+        ::close(fd);
+        CHECK_ARGUMENT(false, "MappedFile: empty or unreadable file");
+    }
+    const size_t size = static_cast<size_t>(st.st_size);
+    // Private and writable so that loading into a view stays local to this process.
+    void *addr = ::mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+    ::close(fd);
+    ASSERT(addr != MAP_FAILED, "MappedFile: mmap failed");
+    _mapping = std::shared_ptr<void>(addr, [size](void *p) { ::munmap(p, size); });
+    // Weights used in place are locked like allocated ones.
+    if (device::cpu::memoryConfig().lock) {
+        _locked = ::mlock(addr, size) == 0;
+        if (!_locked) {
+            std::cerr << "[WARNING] mlock failed, " << path << " is not locked (check RLIMIT_MEMLOCK)" << std::endl;
+        }
+    }
+    _data = static_cast<std::byte *>(addr);
+    _size = size;
+#else
+    std::ifstream file(path, std::ios::binary | std::ios::ate);
+    CHECK_ARGUMENT(file.good(), "MappedFile: cannot open file");
+    const size_t size = static_cast<size_t>(file.tellg());
+    CHECK_ARGUMENT(size > 0, "MappedFile: empty or unreadable file");
+    auto buffer = std::shared_ptr<std::byte[]>(new std::byte[size]);
+    file.seekg(0);
+    file.read(reinterpret_cast<char *>(buffer.get()), size);
+    _mapping = buffer;
+    _data = buffer.get();
+    _size = size;
+#endif
+}
+
+const std::string &MappedFile::path() const {
+    return _path;
+}
+
+std::byte *MappedFile::data() const {
+    return _data;
+}
+
+size_t MappedFile::size() const {
+    return _size;
+}
+
+bool MappedFile::locked() const {
+    return _locked;
+}
+
+tensor_t MappedFile::view(const std::vector<size_t> &shape, llaisysDataType_t dtype, size_t offset) {
+    if (reinterpret_cast<uintptr_t>(_data + offset) % utils::dsize(dtype) != 0) {
+        return nullptr;
+    }
+    if (!_storage) {
+        // The storage belongs to the CPU runtime; the caller may be on another device.
+        const core::Runtime &caller = core::context().runtime();
+        const llaisysDeviceType_t device_type = caller.deviceType();
+        const int device_id = caller.deviceId();
+        core::context().setDevice(LLAISYS_DEVICE_CPU, 0);
+        _storage = core::context().runtime().wrapDeviceStorage(_data, _size, _mapping);
+        core::context().setDevice(device_type, device_id);
+    }
+    tensor_t view = Tensor::create(shape, dtype, _storage, offset);
+#ifndef _WIN32
+    const llaisysCpuNumaPolicy_t policy = device::cpu::memoryConfig().numa_policy;
+    if (policy != LLAISYS_CPU_NUMA_DEFAULT && device::cpu::numaNodes().size() > 1) {
+        // File pages are allocated by the page cache on the node of the thread reading
+        // them, whatever the policy of the mapping: read the tensor in, then move it where
+        // an allocated one would be placed.
+        const size_t bytes = view->numel() * view->elementSize();
+        const size_t page = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+        for (size_t i = offset / page * page; i < offset + bytes; i += page) {
+            (void)*static_cast<volatile const std::byte *>(_data + i);
+        }
+        device::cpu::placeMemory(_data + offset, bytes, policy, true);
+    }
+#endif
+    return view;
+}
+} // namespace llaisys::models
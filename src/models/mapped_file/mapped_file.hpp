@@ -0,0 +1,39 @@
+#pragma once
+
+#include "../../tensor/tensor.hpp"
+
+#include <memory>
+#include <string>
+
+namespace llaisys::models {
+// A whole file mapped into memory copy-on-write.
+//
+// Pages are read on first touch and shared with every other process mapping the
+// same file through the page cache; writes stay private to this process. If
+// locking is enabled in the CPU memory config the mapping is locked into RAM. On
+// platforms without mmap the file is read into memory instead.
+class MappedFile {
+private:
+    std::string _path;
+    std::shared_ptr<void> _mapping; // unmaps the file when the last user goes away
+    std::byte *_data;
+    size_t _size;
+    bool _locked;
+    core::storage_t _storage;
+
+public:
+    explicit MappedFile(const std::string &path);
+
+    const std::string &path() const;
+    std::byte *data() const;
+    size_t size() const;
+    // Whether the mapping is locked into RAM.
+    bool locked() const;
+
+    // Contiguous CPU tensor at `offset` bytes into the file, without copying. Views
+    // share one storage that keeps the mapping alive, and are placed on NUMA nodes by
+    // the CPU memory config like allocated buffers. Returns null if the data is not
+    // aligned to its element size.
+    tensor_t view(const std::vector<size_t> &shape, llaisysDataType_t dtype, size_t offset);
+};
+} // namespace llaisys::models
@@ -0,0 +1,80 @@
+#include "memory_planner.hpp"
+
+#include "../../utils.hpp"
+
+#include <algorithm>
+#include <numeric>
+
+namespace llaisys::models {
+size_t MemoryPlanner::request(const std::vector<size_t> &shape, llaisysDataType_t dtype, size_t first, size_t last) {
+    CHECK_ARGUMENT(first <= last, "MemoryPlanner: buffer must be live for at least one step");
+    CHECK_ARGUMENT(_arena == nullptr, "MemoryPlanner: cannot add buffers after plan()");
+    size_t numel = std::accumulate(shape.begin(), shape.end(), size_t(1), std::multiplies<size_t>());
+    size_t bytes = (numel * utils::dsize(dtype) + kAlignment - 1) / kAlignment * kAlignment;
+    _buffers.push_back(Buffer{shape, dtype, bytes, first, last, 0});
+    return _buffers.size() - 1;
+}
+
+void MemoryPlanner::plan(llaisysDeviceType_t device_type, int device_id) {
+    std::vector<size_t> order(_buffers.size());
+    std::iota(order.begin(), order.end(), size_t(0));
+    std::stable_sort(order.begin(), order.end(), [&](size_t a, size_t b) {
+        return _buffers[a].bytes > _buffers[b].bytes;
+    });
+
+    size_t arena = 0;
+    std::vector<const Buffer *> placed;
+    for (size_t id : order) {
+        Buffer &buffer = _buffers[id];
+        // Memory ranges of placed buffers that are live at the same time, by offset.
+        std::vector<std::pair<size_t, size_t>> busy;
+        for (const Buffer *other : placed) {
+            if (other->first <= buffer.last && buffer.first <= other->last) {
+                busy.emplace_back(other->offset, other->offset + other->bytes);
+            }
+        }
+        std::sort(busy.begin(), busy.end());
+        size_t offset = 0;
+        for (const auto &[begin, end] : busy) {
+            if (offset + buffer.bytes <= begin) {
+                break;
+            }
+            offset = std::max(offset, end);
+        }
+        buffer.offset = offset;
+        arena = std::max(arena, offset + buffer.bytes);
+        placed.push_back(&buffer);
+    }
+    _arena = Tensor::create({std::max<size_t>(arena, 1)}, LLAISYS_DTYPE_BYTE, device_type, device_id);
+}
+
+tensor_t MemoryPlanner::tensor(size_t id) const {
+    CHECK_ARGUMENT(_arena != nullptr, "MemoryPlanner: plan() has not been called");
+    CHECK_ARGUMENT(id < _buffers.size(), "MemoryPlanner: unknown buffer");
+    const Buffer &buffer = _buffers[id];
+    return _arena->reinterpret(buffer.shape, buffer.dtype, buffer.offset);
+}
+
+size_t MemoryPlanner::offset(size_t id) const {
+    CHECK_ARGUMENT(_arena != nullptr, "MemoryPlanner: plan() has not been called");
+    CHECK_ARGUMENT(id < _buffers.size(), "MemoryPlanner: unknown buffer");
+    return _buffers[id].offset;
+}
+
+size_t MemoryPlanner::bytes(size_t id) const {
+    CHECK_ARGUMENT(id < _buffers.size(), "MemoryPlanner: unknown buffer");
+    return _buffers[id].bytes;
+}
+
+size_t MemoryPlanner::arenaBytes() const {
+    return _arena == nullptr ? 0 : _arena->numel();
+}
+
+size_t MemoryPlanner::totalBytes() const {
+    size_t total = 0;
+    for (const auto &buffer : _buffers) {
+        total += buffer.bytes;
+    }
+    return total;
+}
+} // namespace llaisys::models
@@ -0,0 +1,47 @@
+#pragma once
+
+#include "../../tensor/tensor.hpp"
+
+#include <vector>
+
+namespace llaisys::models {
+// Places the intermediate tensors of a forward pass into a single arena. Each
+// buffer is declared with the range of op steps during which it holds live data;
+// buffers whose ranges do not overlap may share memory. `plan()` assigns offsets
+// (largest buffers first, each at the lowest offset that does not collide with
+// an already placed buffer live at the same time) and allocates the arena once,
+// after which every buffer is a tensor viewing its part of it.
+class MemoryPlanner {
+public:
+    static constexpr size_t kAlignment = 256;
+
+private:
+    struct Buffer {
+        std::vector<size_t> shape;
+        llaisysDataType_t dtype;
+        size_t bytes;
+        size_t first, last; // live during steps [first, last]
+        size_t offset;
+    };
+    std::vector<Buffer> _buffers;
+    tensor_t _arena;
+
+public:
+    // Declare a buffer live from step `first` to step `last` (inclusive) and return its id.
+    size_t request(const std::vector<size_t> &shape, llaisysDataType_t dtype, size_t first, size_t last);
+
+    // Assign offsets and allocate the arena on the given device.
+    void plan(llaisysDeviceType_t device_type, int device_id);
+
+    // Contiguous tensor of buffer `id`; only valid after plan().
+    tensor_t tensor(size_t id) const;
+
+    // Byte offset of buffer `id` in the arena (only valid after plan()) and its aligned size.
+    size_t offset(size_t id) const;
+    size_t bytes(size_t id) const;
+
+    // Arena size, and the memory the buffers would take if allocated separately.
+    size_t arenaBytes() const;
+    size_t totalBytes() const;
+};
+} // namespace llaisys::models
@@ -0,0 +1,183 @@
+#include "model_image.hpp"
+
+#include "../../core/llaisys_core.hpp"
+#include "../../utils.hpp"
+
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+
+namespace llaisys::models {
+namespace {
+constexpr char kMagic[8] = {'L', 'L', 'S', 'I', 'M', 'A', 'G', 'E'};
+constexpr uint32_t kByteOrderMark = 0x01020304;
+
+struct ImageHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t byte_order;
+    char kind[16];
+    uint64_t meta_size;
+    uint64_t ntensor;
+    uint64_t table_size;
+};
+
+// Bounds-checked reader over the tensor table.
+class TableReader {
+private:
+    const std::byte *_p;
+    const std::byte *_end;
+
+public:
+    TableReader(const std::byte *data, size_t size) : _p(data), _end(data + size) {}
+
+    void read(void *dst, size_t n) {
+        CHECK_ARGUMENT(static_cast<size_t>(_end - _p) >= n, "ModelImage: truncated tensor table");
+        std::memcpy(dst, _p, n);
+        _p += n;
+    }
+
+    template <typename T>
+    T read() {
+        T v;
+        read(&v, sizeof(v));
+        return v;
+    }
+};
+
+template <typename T>
+void append(std::vector<std::byte> &out, const T &v) {
+    const auto *p = reinterpret_cast<const std::byte *>(&v);
+    out.insert(out.end(), p, p + sizeof(v));
+}
+
+size_t alignUp(size_t n) {
+    return (n + ModelImage::kAlignment - 1) / ModelImage::kAlignment * ModelImage::kAlignment;
+}
+} // namespace
+
+ModelImage::ModelImage(const std::string &path) : _file(path), _meta(nullptr), _meta_size(0) {
+    ImageHeader header;
+    CHECK_ARGUMENT(_file.size() >= sizeof(header), "ModelImage: file too small");
+    std::memcpy(&header, _file.data(), sizeof(header));
+    CHECK_ARGUMENT(std::memcmp(header.magic, kMagic, sizeof(kMagic)) == 0, "ModelImage: not a model image");
+    CHECK_ARGUMENT(header.version == kVersion, "ModelImage: unsupported version");
+    CHECK_ARGUMENT(header.byte_order == kByteOrderMark, "ModelImage: written with a different byte order");
+    CHECK_ARGUMENT(header.meta_size + header.table_size <= _file.size() - sizeof(header), "ModelImage: header exceeds file");
+    _kind.assign(header.kind, strnlen(header.kind, sizeof(header.kind)));
+    _meta = _file.data() + sizeof(header);
+    _meta_size = header.meta_size;
+
+    TableReader table(_meta + _meta_size, header.table_size);
+    for (uint64_t i = 0; i < header.ntensor; i++) {
+        ModelImageEntry entry;
+        entry.name.resize(table.read<uint32_t>());
+        table.read(entry.name.data(), entry.name.size());
+        entry.dtype = static_cast<llaisysDataType_t>(table.read<uint32_t>());
+        entry.shape.resize(table.read<uint32_t>());
+        size_t numel = 1;
+        for (size_t &d : entry.shape) {
+            d = table.read<uint64_t>();
+            numel *= d;
+        }
+        entry.offset = table.read<uint64_t>();
+        entry.size = table.read<uint64_t>();
+        CHECK_ARGUMENT(entry.size == numel * utils::dsize(entry.dtype), "ModelImage: tensor size does not match shape");
+        CHECK_ARGUMENT(entry.offset % kAlignment == 0 && entry.offset + entry.size <= _file.size(),
+                       "ModelImage: tensor data out of bounds");
+        _entries.push_back(std::move(entry));
+    }
+}
+
+const std::string &ModelImage::kind() const {
+    return _kind;
+}
+
+const std::byte *ModelImage::meta() const {
+    return _meta;
+}
+
+size_t ModelImage::metaSize() const {
+    return _meta_size;
+}
+
+const std::vector<ModelImageEntry> &ModelImage::tensors() const {
+    return _entries;
+}
+
+const std::byte *ModelImage::data(const ModelImageEntry &entry) const {
+    return _file.data() + entry.offset;
+}
+
+bool ModelImage::locked() const {
+    return _file.locked();
+}
+
+tensor_t ModelImage::view(const ModelImageEntry &entry) {
+    return _file.view(entry.shape, entry.dtype, entry.offset);
+}
+
+void ModelImage::write(const std::string &path, const std::string &kind, const void *meta, size_t meta_size,
+                       const std::vector<std::pair<std::string, tensor_t>> &tensors) {
+    CHECK_ARGUMENT(kind.size() < sizeof(ImageHeader::kind), "ModelImage: kind name too long");
+
+    std::vector<std::byte> table;
+    std::vector<size_t> offsets;
+    for (const auto &[name, tensor] : tensors) {
+        CHECK_ARGUMENT(tensor->isContiguous(), "ModelImage: tensors must be contiguous");
+        append(table, static_cast<uint32_t>(name.size()));
+        const auto *chars = reinterpret_cast<const std::byte *>(name.data());
+        table.insert(table.end(), chars, chars + name.size());
+        append(table, static_cast<uint32_t>(tensor->dtype()));
+        append(table, static_cast<uint32_t>(tensor->ndim()));
+        for (size_t d : tensor->shape()) {
+            append(table, static_cast<uint64_t>(d));
+        }
+        offsets.push_back(table.size());
+        append(table, uint64_t(0)); // offset, filled in below
+        append(table, static_cast<uint64_t>(tensor->numel() * tensor->elementSize()));
+    }
+
+    ImageHeader header{};
+    std::memcpy(header.magic, kMagic, sizeof(kMagic));
+    header.version = kVersion;
+    header.byte_order = kByteOrderMark;
+    std::memcpy(header.kind, kind.data(), kind.size());
+    header.meta_size = meta_size;
+    header.ntensor = tensors.size();
+    header.table_size = table.size();
+
+    size_t offset = alignUp(sizeof(header) + meta_size + table.size());
+    for (size_t i = 0; i < tensors.size(); i++) {
+        const uint64_t off = offset;
+        std::memcpy(table.data() + offsets[i], &off, sizeof(off));
+        offset = alignUp(offset + tensors[i].second->numel() * tensors[i].second->elementSize());
+    }
+
+    const std::string tmp = path + ".tmp";
+    std::ofstream file(tmp, std::ios::binary | std::ios::trunc);
+    CHECK_ARGUMENT(file.good(), "ModelImage: cannot create file");
+    file.write(reinterpret_cast<const char *>(&header), sizeof(header));
+    file.write(static_cast<const char *>(meta), meta_size);
+    file.write(reinterpret_cast<const char *>(table.data()), table.size());
+
+    std::vector<std::byte> host;
+    for (const auto &[name, tensor] : tensors) {
+        const size_t bytes = tensor->numel() * tensor->elementSize();
+        const size_t pos = static_cast<size_t>(file.tellp());
+        const std::vector<char> padding(alignUp(pos) - pos, 0);
+        file.write(padding.data(), padding.size());
+        const std::byte *data = tensor->data();
+        if (tensor->deviceType() != LLAISYS_DEVICE_CPU) {
+            host.resize(bytes);
+            core::context().setDevice(tensor->deviceType(), tensor->deviceId());
+            core::context().runtime().api()->memcpy_sync(host.data(), data, bytes, LLAISYS_MEMCPY_D2H);
+            data = host.data();
+        }
+        file.write(reinterpret_cast<const char *>(data), bytes);
+    }
+    file.close();
+    ASSERT(file.good(), "ModelImage: write failed");
+    ASSERT(std::rename(tmp.c_str(), path.c_str()) == 0, "ModelImage: cannot rename file into place");
+}
+} // namespace llaisys::models
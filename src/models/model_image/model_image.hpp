@@ -0,0 +1,62 @@
+#pragma once
+
+#include "../mapped_file/mapped_file.hpp"
+
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace llaisys::models {
+// One tensor of a model image; `offset` is relative to the start of the file.
+struct ModelImageEntry {
+    std::string name;
+    llaisysDataType_t dtype;
+    std::vector<size_t> shape;
+    size_t offset;
+    size_t size;
+};
+
+// Native LLAISYS model image: the weights of a model exactly as they are laid out
+// in memory, plus the model's metadata, so that loading is a plain mapping.
+//
+// Layout, all integers in native byte order:
+//   header   magic "LLSIMAGE", u32 version, u32 byte-order mark, char kind[16],
+//            u64 meta bytes, u64 tensor count, u64 table bytes
+//   meta     opaque model metadata (e.g. LlaisysQwen2Meta)
+//   table    per tensor: u32 name length, name, u32 dtype, u32 ndim, u64 shape[ndim],
+//            u64 offset, u64 bytes
+//   data     every tensor starts on a kAlignment boundary
+// Images are only read back on machines with the same byte order.
+class ModelImage {
+public:
+    static constexpr size_t kAlignment = 4096;
+    static constexpr uint32_t kVersion = 1;
+
+private:
+    MappedFile _file;
+    std::string _kind;
+    const std::byte *_meta;
+    size_t _meta_size;
+    std::vector<ModelImageEntry> _entries;
+
+public:
+    explicit ModelImage(const std::string &path);
+
+    // Model architecture the image was written for, e.g. "qwen2".
+    const std::string &kind() const;
+    const std::byte *meta() const;
+    size_t metaSize() const;
+
+    const std::vector<ModelImageEntry> &tensors() const;
+    const std::byte *data(const ModelImageEntry &entry) const;
+    // Whether the mapping is locked into RAM, see MappedFile.
+    bool locked() const;
+    // CPU tensor pointing into the mapping, see MappedFile::view.
+    tensor_t view(const ModelImageEntry &entry);
+
+    // Write `tensors` (contiguous, on any device) and `meta` to `path`. The file is
+    // written next to `path` and renamed into place once complete.
+    static void write(const std::string &path, const std::string &kind, const void *meta, size_t meta_size,
+                      const std::vector<std::pair<std::string, tensor_t>> &tensors);
+};
+} // namespace llaisys::models
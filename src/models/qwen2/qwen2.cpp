@@ -0,0 +1,747 @@
+#include "qwen2.hpp"
+
+#include "../../llaisys/llaisys_tensor.hpp"
+
+#include "../../ops/add/op.hpp"
+#include "../../ops/argmax/op.hpp"
+#include "../../ops/embedding/op.hpp"
+#include "../../ops/linear/op.hpp"
+#include "../../ops/linear_argmax/op.hpp"
+#include "../../ops/paged_attention/op.hpp"
+#include "../../ops/rms_norm/op.hpp"
+#include "../../ops/rope/op.hpp"
+#include "../../ops/sample/op.hpp"
+#include "../../ops/select_rows/op.hpp"
+#include "../../ops/swiglu/op.hpp"
+
+#include "../../core/llaisys_core.hpp"
+#include "../../core/metrics/metrics.hpp"
+#include "../../utils.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <exception>
+
+namespace llaisys::models {
+namespace {
+llaisysTensor_t *createHandles(size_t n) {
+    return new llaisysTensor_t[n]();
+}
+
+void destroyHandles(llaisysTensor_t *handles, size_t n) {
+    for (size_t i = 0; i < n; i++) {
+        delete handles[i];
+    }
+    delete[] handles;
+}
+
+// Rows up to which independent projections share the CPU threads: a GEMV over a few
+// rows cannot keep every core busy, larger products can by themselves.
+constexpr size_t kConcurrentRows = 16;
+
+// Run ops that do not depend on each other, side by side if `concurrent` and `rows` is small.
+void independent(bool concurrent, size_t rows, const std::vector<std::function<void()>> &branches,
+                 const std::vector<double> &costs = {}) {
+    if (concurrent && rows <= kConcurrentRows) {
+        return ops::concurrently(branches, costs);
+    }
+    for (const auto &branch : branches) {
+        branch();
+    }
+}
+
+void toFloat(float *dst, const std::byte *src, size_t n, llaisysDataType_t dtype) {
+    switch (dtype) {
+    case LLAISYS_DTYPE_F32:
+        std::memcpy(dst, src, n * sizeof(float));
+        return;
+    case LLAISYS_DTYPE_BF16:
+        for (size_t i = 0; i < n; i++) {
+            dst[i] = utils::cast<float>(reinterpret_cast<const bf16_t *>(src)[i]);
+        }
+        return;
+    case LLAISYS_DTYPE_F16:
+        for (size_t i = 0; i < n; i++) {
+            dst[i] = utils::cast<float>(reinterpret_cast<const fp16_t *>(src)[i]);
+        }
+        return;
+    default:
+        EXCEPTION_UNSUPPORTED_DATATYPE(dtype);
+    }
+}
+} // namespace
+
+Qwen2::Qwen2(const LlaisysQwen2Meta &meta, llaisysDeviceType_t device_type, int device_id)
+    : _meta(meta), _device_type(device_type), _device_id(device_id), _weights_locked(false), _chunk(0), _op_capture(true),
+      _op_concurrency(true), _step_batch(nullptr), _step_tables(nullptr), _layer_start(0) {
+    CHECK_ARGUMENT(meta.nlayer > 0 && meta.maxseq > 0, "Qwen2: nlayer and maxseq must be positive");
+    CHECK_ARGUMENT(meta.nkvh > 0 && meta.nh % meta.nkvh == 0, "Qwen2: nh must be divisible by nkvh");
+    CHECK_ARGUMENT(meta.nh * meta.dh == meta.hs, "Qwen2: nh * dh must equal hs");
+
+    const size_t nlayer = meta.nlayer, hs = meta.hs, nh = meta.nh, nkvh = meta.nkvh, dh = meta.dh;
+    const size_t di = meta.di, voc = meta.voc;
+    const llaisysDataType_t dtype = meta.dtype;
+
+    // Weights
+    core::MemoryCategoryScope scope(LLAISYS_MEMORY_WEIGHTS);
+    auto handle = [&](const std::vector<size_t> &shape) {
+        return new LlaisysTensor{_createTensor(shape, dtype)};
+    };
+    _weights.in_embed = handle({voc, hs});
+    _weights.out_embed = handle({voc, hs});
+    _weights.out_norm_w = handle({hs});
+    _weights.attn_norm_w = createHandles(nlayer);
+    _weights.attn_q_w = createHandles(nlayer);
+    _weights.attn_q_b = createHandles(nlayer);
+    _weights.attn_k_w = createHandles(nlayer);
+    _weights.attn_k_b = createHandles(nlayer);
+    _weights.attn_v_w = createHandles(nlayer);
+    _weights.attn_v_b = createHandles(nlayer);
+    _weights.attn_o_w = createHandles(nlayer);
+    _weights.mlp_norm_w = createHandles(nlayer);
+    _weights.mlp_gate_w = createHandles(nlayer);
+    _weights.mlp_up_w = createHandles(nlayer);
+    _weights.mlp_down_w = createHandles(nlayer);
+    for (size_t i = 0; i < nlayer; i++) {
+        _weights.attn_norm_w[i] = handle({hs});
+        _weights.attn_q_w[i] = handle({nh * dh, hs});
+        _weights.attn_q_b[i] = handle({nh * dh});
+        _weights.attn_k_w[i] = handle({nkvh * dh, hs});
+        _weights.attn_k_b[i] = handle({nkvh * dh});
+        _weights.attn_v_w[i] = handle({nkvh * dh, hs});
+        _weights.attn_v_b[i] = handle({nkvh * dh});
+        _weights.attn_o_w[i] = handle({hs, nh * dh});
+        _weights.mlp_norm_w[i] = handle({hs});
+        _weights.mlp_gate_w[i] = handle({di, hs});
+        _weights.mlp_up_w[i] = handle({di, hs});
+        _weights.mlp_down_w[i] = handle({hs, di});
+    }
+
+    // KV cache: by default room for one full-length sequence
+    configureKVCache(16, meta.maxseq);
+
+    // Workspace
+    _allocateWorkspace(std::min<size_t>(meta.maxseq, 512));
+    _host_logits.resize(voc * utils::dsize(dtype));
+}
+
+Qwen2::~Qwen2() {
+    const size_t nlayer = _meta.nlayer;
+    delete _weights.in_embed;
+    delete _weights.out_embed;
+    delete _weights.out_norm_w;
+    destroyHandles(_weights.attn_norm_w, nlayer);
+    destroyHandles(_weights.attn_q_w, nlayer);
+    destroyHandles(_weights.attn_q_b, nlayer);
+    destroyHandles(_weights.attn_k_w, nlayer);
+    destroyHandles(_weights.attn_k_b, nlayer);
+    destroyHandles(_weights.attn_v_w, nlayer);
+    destroyHandles(_weights.attn_v_b, nlayer);
+    destroyHandles(_weights.attn_o_w, nlayer);
+    destroyHandles(_weights.mlp_norm_w, nlayer);
+    destroyHandles(_weights.mlp_gate_w, nlayer);
+    destroyHandles(_weights.mlp_up_w, nlayer);
+    destroyHandles(_weights.mlp_down_w, nlayer);
+}
+
+tensor_t Qwen2::_createTensor(const std::vector<size_t> &shape, llaisysDataType_t dtype) const {
+    return Tensor::create(shape, dtype, _device_type, _device_id);
+}
+
+void Qwen2::_allocateWorkspace(size_t chunk) {
+    const size_t hs = _meta.hs, nh = _meta.nh, nkvh = _meta.nkvh, dh = _meta.dh, di = _meta.di, voc = _meta.voc;
+    const llaisysDataType_t dtype = _meta.dtype;
+
+    // Op steps of forward(). Every layer runs steps kNorm..kMlpAdd on the same
+    // buffers, so per-layer lifetimes only need to cover one layer; inputs read by
+    // every layer (`_pos`) and the residual stream `_x` span the whole loop.
+    enum : size_t { kEmbed, kNorm, kQKV, kRope, kAttention, kAttnOut, kAttnAdd,
+                    kMlpNorm, kGateUp, kSwiGLU, kDown, kMlpAdd, kHead };
+
+    _decode_graph.clear();
+    core::MemoryCategoryScope scope(LLAISYS_MEMORY_ACTIVATIONS);
+    _workspace = MemoryPlanner();
+    const size_t ids = _workspace.request({chunk}, LLAISYS_DTYPE_I64, kEmbed, kEmbed);
+    const size_t pos = _workspace.request({chunk}, LLAISYS_DTYPE_I64, kEmbed, kMlpAdd);
+    const size_t x = _workspace.request({chunk, hs}, dtype, kEmbed, kHead);
+    const size_t xn = _workspace.request({chunk, hs}, dtype, kNorm, kGateUp);
+    const size_t q = _workspace.request({chunk, nh, dh}, dtype, kQKV, kAttention);
+    const size_t k = _workspace.request({chunk, nkvh, dh}, dtype, kQKV, kAttention);
+    const size_t v = _workspace.request({chunk, nkvh, dh}, dtype, kQKV, kAttention);
+    const size_t attn = _workspace.request({chunk, nh, dh}, dtype, kAttention, kAttnOut);
+    const size_t o = _workspace.request({chunk, hs}, dtype, kAttnOut, kMlpAdd);
+    const size_t gate = _workspace.request({chunk, di}, dtype, kGateUp, kDown);
+    const size_t up = _workspace.request({chunk, di}, dtype, kGateUp, kSwiGLU);
+    const size_t out_rows = _workspace.request({chunk}, LLAISYS_DTYPE_I64, kHead, kHead);
+    const size_t out_hidden = _workspace.request({chunk, hs}, dtype, kHead, kHead);
+    const size_t out_norm = _workspace.request({chunk, hs}, dtype, kHead, kHead);
+    const size_t out_idx = _workspace.request({chunk}, LLAISYS_DTYPE_I64, kHead, kHead);
+    const size_t out_val = _workspace.request({chunk}, dtype, kHead, kHead);
+    const size_t logits = _workspace.request({1, voc}, dtype, kHead, kHead);
+    _workspace.plan(_device_type, _device_id);
+
+    _chunk = chunk;
+    _ids = _workspace.tensor(ids);
+    _pos = _workspace.tensor(pos);
+    _x = _workspace.tensor(x);
+    _xn = _workspace.tensor(xn);
+    _q = _workspace.tensor(q);
+    _k = _workspace.tensor(k);
+    _v = _workspace.tensor(v);
+    _attn = _workspace.tensor(attn);
+    _o = _workspace.tensor(o);
+    _gate = _workspace.tensor(gate);
+    _up = _workspace.tensor(up);
+
+    _out_rows = _workspace.tensor(out_rows);
+    _out_hidden = _workspace.tensor(out_hidden);
+    _out_norm = _workspace.tensor(out_norm);
+    _out_idx = _workspace.tensor(out_idx);
+    _out_val = _workspace.tensor(out_val);
+    _logits = _workspace.tensor(logits);
+
+    _host_ids.resize(chunk);
+    _host_pos.resize(chunk);
+    _host_rows.resize(chunk);
+}
+
+const LlaisysQwen2Meta &Qwen2::meta() const {
+    return _meta;
+}
+
+LlaisysQwen2Weights *Qwen2::weights() {
+    // The caller may replace weights.
+    _decode_graph.clear();
+    return &_weights;
+}
+
+llaisysTensor_t Qwen2::_weightHandle(const std::string &name) {
+    if (name == "model.embed_tokens.weight") {
+        return _weights.in_embed;
+    }
+    if (name == "lm_head.weight") {
+        return _weights.out_embed;
+    }
+    if (name == "model.norm.weight") {
+        return _weights.out_norm_w;
+    }
+    static const std::string prefix = "model.layers.";
+    if (name.compare(0, prefix.size(), prefix) != 0) {
+        return nullptr;
+    }
+    size_t dot = name.find('.', prefix.size());
+    if (dot == std::string::npos) {
+        return nullptr;
+    }
+    const size_t layer = std::stoul(name.substr(prefix.size(), dot - prefix.size()));
+    CHECK_ARGUMENT(layer < _meta.nlayer, "Qwen2: weight of a layer beyond nlayer");
+    static const std::pair<const char *, llaisysTensor_t *LlaisysQwen2Weights::*> layer_weights[] = {
+        {"input_layernorm.weight", &LlaisysQwen2Weights::attn_norm_w},
+        {"self_attn.q_proj.weight", &LlaisysQwen2Weights::attn_q_w},
+        {"self_attn.q_proj.bias", &LlaisysQwen2Weights::attn_q_b},
+        {"self_attn.k_proj.weight", &LlaisysQwen2Weights::attn_k_w},
+        {"self_attn.k_proj.bias", &LlaisysQwen2Weights::attn_k_b},
+        {"self_attn.v_proj.weight", &LlaisysQwen2Weights::attn_v_w},
+        {"self_attn.v_proj.bias", &LlaisysQwen2Weights::attn_v_b},
+        {"self_attn.o_proj.weight", &LlaisysQwen2Weights::attn_o_w},
+        {"post_attention_layernorm.weight", &LlaisysQwen2Weights::mlp_norm_w},
+        {"mlp.gate_proj.weight", &LlaisysQwen2Weights::mlp_gate_w},
+        {"mlp.up_proj.weight", &LlaisysQwen2Weights::mlp_up_w},
+        {"mlp.down_proj.weight", &LlaisysQwen2Weights::mlp_down_w},
+    };
+    const std::string key = name.substr(dot + 1);
+    for (const auto &[suffix, member] : layer_weights) {
+        if (key == suffix) {
+            return (_weights.*member)[layer];
+        }
+    }
+    return nullptr;
+}
+
+size_t Qwen2::loadSafetensors(const std::vector<std::string> &paths) {
+    _decode_graph.clear();
+    // Mapping a file and parsing its header is cheap, but do all of them at once anyway.
+    std::vector<std::shared_ptr<SafetensorsFile>> files(paths.size());
+    std::exception_ptr error;
+#pragma omp parallel for schedule(dynamic)
+    for (ptrdiff_t i = 0; i < static_cast<ptrdiff_t>(paths.size()); i++) {
+        try {
+            files[i] = std::make_shared<SafetensorsFile>(paths[i]);
+        } catch (...) {
+#pragma omp critical
+            if (!error) {
+                error = std::current_exception();
+            }
+        }
+    }
+    if (error) {
+        std::rethrow_exception(error);
+    }
+
+    core::MemoryCategoryScope scope(LLAISYS_MEMORY_WEIGHTS);
+    WeightLoader loader;
+    size_t loaded = 0;
+    bool has_lm_head = false;
+    for (const auto &file : files) {
+        for (const SafetensorsEntry &entry : file->tensors()) {
+            llaisysTensor_t handle = _weightHandle(entry.name);
+            if (handle == nullptr) {
+                continue;
+            }
+            tensor_t &weight = handle->tensor;
+            CHECK_ARGUMENT(entry.shape == weight->shape(), "Qwen2: weight shape does not match the checkpoint");
+            tensor_t view;
+            if (entry.dtype == weight->dtype() && _device_type == LLAISYS_DEVICE_CPU) {
+                // Point the weight into the mapped file instead of copying it.
+                view = file->view(entry);
+            }
+            if (view) {
+                weight = view;
+                _weights_locked |= file->locked();
+            } else {
+                // Allocated now rather than at creation, so that the CPU memory config of
+                // the load (e.g. locking) applies to the weights and only to them.
+                weight = Tensor::create(weight->shape(), weight->dtype(), _device_type, _device_id);
+                loader.add(weight, file, entry);
+            }
+            has_lm_head |= entry.name == "lm_head.weight";
+            loaded++;
+        }
+    }
+    loader.run();
+
+    // Tied embeddings: the output projection reuses the input embedding.
+    if (loaded > 0 && !has_lm_head) {
+        _weights.out_embed->tensor = _weights.in_embed->tensor;
+    }
+    // Weights replaced by views leave their memory in the allocator's cache.
+    core::context().setDevice(_device_type, _device_id);
+    core::context().runtime().emptyCache();
+    return loaded;
+}
+
+std::vector<std::string> Qwen2::_weightNames() const {
+    std::vector<std::string> names = {"model.embed_tokens.weight", "model.norm.weight"};
+    if (_weights.out_embed->tensor != _weights.in_embed->tensor) {
+        names.push_back("lm_head.weight");
+    }
+    static const char *layer_weights[] = {
+        "input_layernorm.weight", "self_attn.q_proj.weight", "self_attn.q_proj.bias",
+        "self_attn.k_proj.weight", "self_attn.k_proj.bias", "self_attn.v_proj.weight",
+        "self_attn.v_proj.bias", "self_attn.o_proj.weight", "post_attention_layernorm.weight",
+        "mlp.gate_proj.weight", "mlp.up_proj.weight", "mlp.down_proj.weight"};
+    for (size_t i = 0; i < _meta.nlayer; i++) {
+        for (const char *key : layer_weights) {
+            names.push_back("model.layers." + std::to_string(i) + "." + key);
+        }
+    }
+    return names;
+}
+
+void Qwen2::saveImage(const std::string &path) {
+    std::vector<std::pair<std::string, tensor_t>> tensors;
+    for (const std::string &name : _weightNames()) {
+        tensors.emplace_back(name, _weightHandle(name)->tensor);
+    }
+    ModelImage::write(path, "qwen2", &_meta, sizeof(_meta), tensors);
+}
+
+LlaisysQwen2Meta Qwen2::imageMeta(const ModelImage &image) {
+    CHECK_ARGUMENT(image.kind() == "qwen2" && image.metaSize() == sizeof(LlaisysQwen2Meta),
+                   "Qwen2: not a Qwen2 model image");
+    LlaisysQwen2Meta meta;
+    std::memcpy(&meta, image.meta(), sizeof(meta));
+    return meta;
+}
+
+size_t Qwen2::loadImage(ModelImage &image) {
+    const LlaisysQwen2Meta meta = imageMeta(image);
+    CHECK_ARGUMENT(meta.dtype == _meta.dtype && meta.nlayer == _meta.nlayer && meta.hs == _meta.hs && meta.nh == _meta.nh
+                       && meta.nkvh == _meta.nkvh && meta.dh == _meta.dh && meta.di == _meta.di && meta.voc == _meta.voc,
+                   "Qwen2: model image does not match the model");
+
+    _decode_graph.clear();
+    core::MemoryCategoryScope scope(LLAISYS_MEMORY_WEIGHTS);
+    size_t loaded = 0;
+    bool has_lm_head = false;
+    for (const ModelImageEntry &entry : image.tensors()) {
+        llaisysTensor_t handle = _weightHandle(entry.name);
+        CHECK_ARGUMENT(handle != nullptr, "Qwen2: unknown tensor in model image");
+        tensor_t &weight = handle->tensor;
+        CHECK_ARGUMENT(entry.shape == weight->shape() && entry.dtype == weight->dtype(),
+                       "Qwen2: model image tensor does not match the weight");
+        // The image holds the final layout: map it on CPU, copy it as is elsewhere.
+        tensor_t view = _device_type == LLAISYS_DEVICE_CPU ? image.view(entry) : nullptr;
+        if (view) {
+            weight = view;
+            _weights_locked |= image.locked();
+        } else {
+            weight->load(image.data(entry));
+        }
+        has_lm_head |= entry.name == "lm_head.weight";
+        loaded++;
+    }
+    if (!has_lm_head) {
+        _weights.out_embed->tensor = _weights.in_embed->tensor;
+    }
+    core::context().setDevice(_device_type, _device_id);
+    core::context().runtime().emptyCache();
+    return loaded;
+}
+
+void Qwen2::setWeightResidency(size_t max_resident_bytes, size_t prefetch_layers) {
+    _decode_graph.clear();
+    _residency.reset();
+    if (max_resident_bytes == 0) {
+        return;
+    }
+    CHECK_ARGUMENT(_device_type == LLAISYS_DEVICE_CPU, "Qwen2: weight residency needs CPU weights");
+    CHECK_ARGUMENT(prefetch_layers < _meta.nlayer, "Qwen2: cannot prefetch more layers than the model has");
+    // Locked pages cannot be dropped.
+    CHECK_ARGUMENT(!_weights_locked, "Qwen2: weight residency needs weights that are not locked");
+    std::vector<std::vector<WeightResidency::Range>> layers(_meta.nlayer);
+    std::vector<WeightResidency::Range> shared;
+    for (const std::string &name : _weightNames()) {
+        tensor_t weight = _weightHandle(name)->tensor;
+        if (name.compare(0, 13, "model.layers.") != 0) {
+            // Embeddings and the final norm stay resident, and so do pages they share with a layer.
+            if (weight->isExternal()) {
+                shared.push_back({weight->data(), weight->numel() * weight->elementSize()});
+            }
+            continue;
+        }
+        // Only weights used in place from a mapped file can be dropped and read back.
+        CHECK_ARGUMENT(weight->isExternal(), "Qwen2: weight residency needs weights mapped from a file");
+        const size_t layer = std::stoul(name.substr(13));
+        layers[layer].push_back({weight->data(), weight->numel() * weight->elementSize()});
+    }
+    _residency = std::make_unique<WeightResidency>(std::move(layers), shared, max_resident_bytes, prefetch_layers);
+}
+
+size_t Qwen2::residentWeightBytes() {
+    return _residency ? _residency->residentBytes() : 0;
+}
+
+void Qwen2::setOpCapture(bool enable) {
+    _op_capture = enable;
+    _decode_graph.clear();
+}
+
+void Qwen2::setOpConcurrency(bool enable) {
+    _op_concurrency = enable;
+    _decode_graph.clear();
+}
+
+size_t Qwen2::capturedOps() const {
+    return _decode_graph.size();
+}
+
+void Qwen2::configureKVCache(size_t block_size, size_t max_tokens) {
+    CHECK_ARGUMENT(block_size > 0 && max_tokens > 0, "Qwen2: KV block size and token budget must be positive");
+    _cache.reset();
+    CHECK_ARGUMENT(!_pool || _pool->numFree() == _pool->numBlocks(),
+                   "Qwen2: cannot reconfigure the KV cache while sequences hold blocks");
+    const size_t nblocks = (max_tokens + block_size - 1) / block_size;
+    _decode_graph.clear();
+    _pool.reset();
+    _pool = std::make_unique<KVBlockPool>(_meta.nlayer, nblocks, block_size, _meta.nkvh, _meta.dh,
+                                          _meta.dtype, _device_type, _device_id);
+}
+
+KVBlockPool &Qwen2::kvPool() {
+    return *_pool;
+}
+
+std::unique_ptr<KVCache> Qwen2::createCache(size_t capacity) {
+    CHECK_ARGUMENT(capacity <= _meta.maxseq, "Qwen2: KV cache capacity exceeds maxseq");
+    return std::make_unique<KVCache>(*_pool, capacity);
+}
+
+KVCache &Qwen2::_sequence() {
+    if (!_cache) {
+        _cache = createCache(_meta.maxseq);
+    }
+    return *_cache;
+}
+
+size_t Qwen2::cacheLength() const {
+    return _cache ? _cache->length() : 0;
+}
+
+void Qwen2::reset() {
+    if (_cache) {
+        _cache->reset();
+    }
+}
+
+size_t Qwen2::prefillChunk() const {
+    return _chunk;
+}
+
+void Qwen2::setPrefillChunk(size_t chunk) {
+    CHECK_ARGUMENT(chunk > 0, "Qwen2: prefill chunk must be positive");
+    chunk = std::min(chunk, _meta.maxseq);
+    if (chunk != _chunk) {
+        _allocateWorkspace(chunk);
+    }
+}
+
+void Qwen2::forward(std::vector<BatchEntry> &batch) {
+    // Check the whole batch before any entry takes KV blocks, so that a rejected
+    // batch leaves every sequence as it was.
+    size_t n = 0, nblocks = 0;
+    for (const auto &e : batch) {
+        CHECK_ARGUMENT(e.cache != nullptr && e.ntoken > 0, "Qwen2: batch entries must have a cache and tokens");
+        CHECK_ARGUMENT(e.cache->length() + e.ntoken <= e.cache->capacity(), "Qwen2: sequence exceeds its KV cache");
+        n += e.ntoken;
+        nblocks += e.cache->blocksNeeded(e.ntoken);
+    }
+    CHECK_ARGUMENT(n <= _chunk, "Qwen2: batch exceeds the prefill chunk");
+    CHECK_ARGUMENT(nblocks <= _pool->numFree(), "Qwen2: out of KV cache blocks");
+
+    // The new tokens of all entries are laid out as consecutive rows.
+    n = 0;
+    for (const auto &e : batch) {
+        CHECK_ARGUMENT(e.cache->reserve(e.ntoken), "Qwen2: out of KV cache blocks");
+        for (size_t i = 0; i < e.ntoken; i++, n++) {
+            _host_ids[n] = e.token_ids[i];
+            _host_pos[n] = static_cast<int64_t>(e.cache->length() + i);
+        }
+    }
+    if (n == 0) {
+        return;
+    }
+    const uint64_t start = core::metricsClock();
+    core::context().setDevice(_device_type, _device_id);
+
+    // The block tables live on the runtime of the calling thread: keep them for this
+    // pass only, a scheduler worker frees its runtime when it exits.
+    std::vector<tensor_t> tables;
+    for (const auto &e : batch) {
+        tables.push_back(e.cache->blockTable());
+    }
+    _step_batch = &batch;
+    _step_tables = &tables;
+    _ids->slice(0, 0, n)->load(_host_ids.data());
+    _pos->slice(0, 0, n)->load(_host_pos.data());
+
+    // A single-token pass runs the same kernels on the same buffers every time, with
+    // only the token id and position changing: replay it without validating and
+    // dispatching every op again.
+    if (n == 1 && _op_capture) {
+        if (_decode_graph.empty()) {
+            try {
+                ops::CaptureScope capture(&_decode_graph);
+                _layers(n);
+            } catch (...) {
+                _decode_graph.clear();
+                throw;
+            }
+        } else {
+            _decode_graph.replay();
+        }
+    } else {
+        _layers(n);
+    }
+    _step_batch = nullptr;
+    _step_tables = nullptr;
+
+    for (const auto &e : batch) {
+        e.cache->append(e.ntoken);
+    }
+    _head(batch, n);
+
+    const bool decode = std::all_of(batch.begin(), batch.end(), [](const BatchEntry &e) { return e.ntoken == 1; });
+    core::metrics().recordForward(decode, n, core::metricsClock() - start);
+}
+
+void Qwen2::_layers(size_t n) {
+    const size_t nh = _meta.nh, nkvh = _meta.nkvh, dh = _meta.dh;
+    const float eps = _meta.epsilon, theta = _meta.theta;
+
+    auto ids = _ids->slice(0, 0, n);
+    auto pos = _pos->slice(0, 0, n);
+    auto x = _x->slice(0, 0, n);
+    auto xn = _xn->slice(0, 0, n);
+    auto q = _q->slice(0, 0, n);
+    auto k = _k->slice(0, 0, n);
+    auto v = _v->slice(0, 0, n);
+    auto attn = _attn->slice(0, 0, n);
+    auto o = _o->slice(0, 0, n);
+    auto gate = _gate->slice(0, 0, n);
+    auto up = _up->slice(0, 0, n);
+
+    ops::embedding(x, ids, _weights.in_embed->tensor);
+
+    for (size_t l = 0; l < _meta.nlayer; l++) {
+        ops::runStep([this] { _layer_start = core::metricsClock(); });
+        if (_residency) {
+            ops::runStep([this, l] { _residency->beforeLayer(l); });
+        }
+
+        // Attention. Projections run over all rows at once; the new keys and values
+        // are then appended to each sequence's cache and every sequence attends to
+        // its own history only.
+        ops::rms_norm(xn, x, _weights.attn_norm_w[l]->tensor, eps);
+        independent(
+            _op_concurrency, n,
+            {[&] { ops::linear(q->view({n, nh * dh}), xn, _weights.attn_q_w[l]->tensor, _weights.attn_q_b[l]->tensor); },
+             [&] { ops::linear(k->view({n, nkvh * dh}), xn, _weights.attn_k_w[l]->tensor, _weights.attn_k_b[l]->tensor); },
+             [&] { ops::linear(v->view({n, nkvh * dh}), xn, _weights.attn_v_w[l]->tensor, _weights.attn_v_b[l]->tensor); }},
+            {double(nh), double(nkvh), double(nkvh)});
+        ops::rope(q, q, pos, theta);
+        ops::rope(k, k, pos, theta);
+        ops::runStep([=] { _attention(l, q, k, v, attn); });
+        ops::linear(o, attn->view({n, nh * dh}), _weights.attn_o_w[l]->tensor, nullptr);
+        ops::add(x, x, o);
+
+        // MLP
+        ops::rms_norm(xn, x, _weights.mlp_norm_w[l]->tensor, eps);
+        independent(_op_concurrency, n,
+                    {[&] { ops::linear(gate, xn, _weights.mlp_gate_w[l]->tensor, nullptr); },
+                     [&] { ops::linear(up, xn, _weights.mlp_up_w[l]->tensor, nullptr); }});
+        ops::swiglu(gate, gate, up);
+        ops::linear(o, gate, _weights.mlp_down_w[l]->tensor, nullptr);
+        ops::add(x, x, o);
+        ops::runStep([this, l] { core::metrics().recordLayer(l, core::metricsClock() - _layer_start); });
+    }
+}
+
+void Qwen2::_attention(size_t layer, tensor_t q, tensor_t k, tensor_t v, tensor_t attn) {
+    const float scale = 1.0f / std::sqrt(static_cast<float>(_meta.dh));
+    size_t row = 0;
+    for (size_t i = 0; i < _step_batch->size(); i++) {
+        const BatchEntry &e = (*_step_batch)[i];
+        const size_t end = row + e.ntoken;
+        e.cache->write(layer, k->slice(0, row, end), v->slice(0, row, end));
+        ops::paged_attention(attn->slice(0, row, end), q->slice(0, row, end),
+                             _pool->keys(layer), _pool->values(layer), (*_step_tables)[i], e.cache->length() + e.ntoken, scale);
+        row = end;
+    }
+}
+
+void Qwen2::_head(std::vector<BatchEntry> &batch, size_t nrows) {
+    // Only the last row of each entry that picks a token needs logits: run the final
+    // norm and the output projection on those rows only. Greedy rows come first so
+    // that they share a single linear_argmax call; rows that sample or return their
+    // logits compute the full logits one at a time.
+    std::vector<std::pair<BatchEntry *, int64_t>> picks, sampled;
+    size_t end = 0;
+    for (auto &e : batch) {
+        end += e.ntoken;
+        if (!e.pick) {
+            continue;
+        }
+        bool greedy = e.params == nullptr || e.params->top_k == 1 || e.params->temperature <= 0.0f;
+        (greedy && e.logits == nullptr ? picks : sampled).emplace_back(&e, static_cast<int64_t>(end - 1));
+    }
+    const size_t ngreedy = picks.size();
+    picks.insert(picks.end(), sampled.begin(), sampled.end());
+    const size_t m = picks.size();
+    if (m == 0) {
+        return;
+    }
+    for (size_t j = 0; j < m; j++) {
+        _host_rows[j] = picks[j].second;
+    }
+
+    auto rows = _out_rows->slice(0, 0, m);
+    auto hidden = _out_hidden->slice(0, 0, m);
+    auto norm = _out_norm->slice(0, 0, m);
+    rows->load(_host_rows.data());
+    ops::select_rows(hidden, _x->slice(0, 0, nrows), rows);
+    ops::rms_norm(norm, hidden, _weights.out_norm_w->tensor, _meta.epsilon);
+
+    if (ngreedy > 0) {
+        ops::linear_argmax(_out_idx->slice(0, 0, ngreedy), _out_val->slice(0, 0, ngreedy),
+                           norm->slice(0, 0, ngreedy), _weights.out_embed->tensor, nullptr);
+    }
+    const llaisysMemcpyKind_t d2h = _device_type == LLAISYS_DEVICE_CPU ? LLAISYS_MEMCPY_H2H : LLAISYS_MEMCPY_D2H;
+    for (size_t j = ngreedy; j < m; j++) {
+        const BatchEntry &e = *picks[j].first;
+        ops::linear(_logits, norm->slice(0, j, j + 1), _weights.out_embed->tensor, nullptr);
+        if (e.logits != nullptr) {
+            core::context().runtime().api()->memcpy_sync(_host_logits.data(), _logits->data(), _host_logits.size(), d2h);
+            toFloat(e.logits, _host_logits.data(), _meta.voc, _meta.dtype);
+        }
+        const LlaisysQwen2SamplingParams *params = e.params;
+        if (params == nullptr || params->top_k == 1 || params->temperature <= 0.0f) {
+            ops::argmax(_out_idx->slice(0, j, j + 1), _out_val->slice(0, j, j + 1), _logits->view({_meta.voc}));
+            continue;
+        }
+        float u = std::uniform_real_distribution<float>(0.0f, 1.0f)(*e.rng);
+        u = std::min(u, std::nextafter(1.0f, 0.0f));
+        ops::sample(_out_idx->slice(0, j, j + 1), _logits, params->temperature, params->top_k, params->top_p, u);
+    }
+
+    core::context().runtime().api()->memcpy_sync(_host_rows.data(), _out_idx->data(), m * sizeof(int64_t), d2h);
+    for (size_t j = 0; j < m; j++) {
+        picks[j].first->next_token = _host_rows[j];
+    }
+}
+
+int64_t Qwen2::_append(KVCache &cache, const int64_t *token_ids, size_t ntoken, bool pick,
+                       const LlaisysQwen2SamplingParams *params, std::mt19937_64 &rng, float *logits) {
+    CHECK_ARGUMENT(cache.length() + ntoken <= cache.capacity(), "Qwen2: sequence exceeds maxseq");
+
+    std::vector<BatchEntry> batch(1);
+    for (size_t begin = 0; begin < ntoken; begin += _chunk) {
+        const size_t n = std::min(_chunk, ntoken - begin);
+        const bool last = pick && begin + n == ntoken;
+        batch[0] = BatchEntry{&cache, token_ids + begin, n, last, params, &rng, 0, last ? logits : nullptr};
+        forward(batch);
+    }
+    return batch[0].next_token;
+}
+
+void Qwen2::prefill(const int64_t *token_ids, size_t ntoken) {
+    _append(_sequence(), token_ids, ntoken, false, nullptr, _rng, nullptr);
+}
+
+int64_t Qwen2::infer(const int64_t *token_ids, size_t ntoken) {
+    CHECK_ARGUMENT(ntoken > 0, "Qwen2: ntoken must be positive");
+    return _append(_sequence(), token_ids, ntoken, true, nullptr, _rng, nullptr);
+}
+
+int64_t Qwen2::infer(KVCache &cache, const int64_t *token_ids, size_t ntoken,
+                     const LlaisysQwen2SamplingParams *params, std::mt19937_64 &rng, float *logits) {
+    CHECK_ARGUMENT(ntoken > 0, "Qwen2: ntoken must be positive");
+    CHECK_ARGUMENT(&cache.pool() == _pool.get(), "Qwen2: sequence belongs to another KV cache");
+    return _append(cache, token_ids, ntoken, true, params, rng, logits);
+}
+
+size_t Qwen2::generate(const int64_t *token_ids, size_t ntoken, size_t max_new_tokens,
+                       const LlaisysQwen2SamplingParams *params,
+                       llaisysQwen2TokenCallback callback, void *userdata, int64_t *out_tokens) {
+    CHECK_ARGUMENT(ntoken <= _meta.maxseq, "Qwen2: prompt exceeds maxseq");
+    reset();
+    if (max_new_tokens == 0 || ntoken == 0) {
+        return 0;
+    }
+    if (params != nullptr) {
+        _rng.seed(params->seed);
+    }
+
+    core::metrics().recordRequest();
+    uint64_t last = core::metricsClock();
+    size_t count = 0;
+    int64_t token = _append(_sequence(), token_ids, ntoken, true, params, _rng, nullptr);
+    while (true) {
+        const uint64_t now = core::metricsClock();
+        core::metrics().recordToken(count == 0, now - last);
+        last = now;
+        if (out_tokens != nullptr) {
+            out_tokens[count] = token;
+        }
+        count++;
+
+        bool cancelled = callback != nullptr && callback(token, userdata) != 0;
+        if (cancelled || token == _meta.end_token || count >= max_new_tokens || cacheLength() >= _meta.maxseq) {
+            break;
+        }
+        token = _append(_sequence(), &token, 1, true, params, _rng, nullptr);
+    }
+    return count;
+}
+} // namespace llaisys::models
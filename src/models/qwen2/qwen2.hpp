@@ -0,0 +1,190 @@
+#pragma once
+
+#include "llaisys/models/qwen2.h"
+
+#include "../../ops/capture/capture.hpp"
+#include "../kv_cache/kv_cache.hpp"
+#include "../memory_planner/memory_planner.hpp"
+#include "../model_image/model_image.hpp"
+#include "../weight_loader/weight_loader.hpp"
+#include "../weight_residency/weight_residency.hpp"
+
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace llaisys::models {
+class Qwen2 {
+private:
+    LlaisysQwen2Meta _meta;
+    llaisysDeviceType_t _device_type;
+    int _device_id;
+
+    // Weight handles, filled by the caller through `weights()`.
+    LlaisysQwen2Weights _weights;
+
+    // Bounds the resident set of mapped layer weights if enabled.
+    std::unique_ptr<WeightResidency> _residency;
+    bool _weights_locked; // some weights are used in place from a locked mapping
+
+    // KV memory shared by all sequences, and the cache of the sequence driven by
+    // prefill / infer / generate (created on first use).
+    std::unique_ptr<KVBlockPool> _pool;
+    std::unique_ptr<KVCache> _cache;
+
+    // Workspace. Every activation buffer has room for one prefill chunk and is
+    // sliced to the current number of tokens, so steps never allocate and peak
+    // activation memory is bounded by the chunk size. The buffers are views into
+    // one arena laid out by a MemoryPlanner: buffers that are never live at the
+    // same time during a forward pass share memory.
+    MemoryPlanner _workspace;
+    size_t _chunk;
+    tensor_t _ids;  // [chunk]
+    tensor_t _pos;  // [chunk]
+    tensor_t _x;    // [chunk, hs] residual stream
+    tensor_t _xn;   // [chunk, hs] normalized input of attention / mlp
+    tensor_t _q;    // [chunk, nh, dh]
+    tensor_t _k;    // [chunk, nkvh, dh] new keys, copied into each sequence's cache
+    tensor_t _v;    // [chunk, nkvh, dh] new values
+    tensor_t _attn; // [chunk, nh, dh]
+    tensor_t _o;    // [chunk, hs] attention / mlp output projection
+    tensor_t _gate; // [chunk, di]
+    tensor_t _up;   // [chunk, di]
+
+    // Output head, only evaluated for the rows that need logits.
+    tensor_t _out_rows;   // [chunk] row indices into the hidden states
+    tensor_t _out_hidden; // [chunk, hs]
+    tensor_t _out_norm;   // [chunk, hs]
+    tensor_t _out_idx;    // [chunk]
+    tensor_t _out_val;    // [chunk]
+    tensor_t _logits;     // [1, voc], only used when sampling or returning logits
+
+    std::vector<int64_t> _host_ids;
+    std::vector<int64_t> _host_pos;
+    std::vector<int64_t> _host_rows;
+    std::vector<std::byte> _host_logits;
+    std::mt19937_64 _rng;
+
+public:
+    // One sequence's share of a batched forward pass.
+    struct BatchEntry {
+        KVCache *cache;                           // the new tokens are appended to this cache
+        const int64_t *token_ids;                 // [ntoken]
+        size_t ntoken;
+        bool pick;                                // pick a token after the last new one
+        const LlaisysQwen2SamplingParams *params; // null for greedy
+        std::mt19937_64 *rng;                     // random source when sampling
+        int64_t next_token;                       // written by forward() if `pick` is set
+        float *logits = nullptr;                  // [voc] host buffer receiving the logits if `pick` is set
+    };
+
+private:
+    // Kernels of a single-token forward pass, recorded on the first one and replayed
+    // by the next ones. Attention (and weight residency) are replayed as steps of their
+    // own that read the batch of the current pass.
+    bool _op_capture;
+    bool _op_concurrency; // run independent projections of small passes side by side
+    ops::OpGraph _decode_graph;
+    std::vector<BatchEntry> *_step_batch;
+    std::vector<tensor_t> *_step_tables;
+    uint64_t _layer_start; // metrics clock at the start of the running layer
+
+    tensor_t _createTensor(const std::vector<size_t> &shape, llaisysDataType_t dtype) const;
+    // Weight handle a Hugging Face tensor name is loaded into, or null if the model has no use for it.
+    llaisysTensor_t _weightHandle(const std::string &name);
+    // Hugging Face names of all weights, without lm_head.weight if the embeddings are tied.
+    std::vector<std::string> _weightNames() const;
+    void _allocateWorkspace(size_t chunk);
+    KVCache &_sequence();
+    // Embedding and all layers over the first `n` rows of the workspace.
+    void _layers(size_t n);
+    // Append the new keys and values of every entry of the current batch to its cache
+    // and attend to its history.
+    void _attention(size_t layer, tensor_t q, tensor_t k, tensor_t v, tensor_t attn);
+    // Pick the next token of every entry with `pick` set from the hidden states of the last forward.
+    void _head(std::vector<BatchEntry> &batch, size_t nrows);
+    // Feed `ntoken` tokens to `cache` chunk by chunk and, if `pick`, return the next
+    // token (greedy if `params` is null) and optionally its logits.
+    int64_t _append(KVCache &cache, const int64_t *token_ids, size_t ntoken, bool pick,
+                    const LlaisysQwen2SamplingParams *params, std::mt19937_64 &rng, float *logits);
+
+public:
+    Qwen2(const LlaisysQwen2Meta &meta, llaisysDeviceType_t device_type, int device_id);
+    ~Qwen2();
+
+    // Prevent copying
+    Qwen2(const Qwen2 &) = delete;
+    Qwen2 &operator=(const Qwen2 &) = delete;
+
+    const LlaisysQwen2Meta &meta() const;
+    LlaisysQwen2Weights *weights();
+
+    // Load the weights stored in the Hugging Face safetensors files `paths` and return the
+    // number of tensors loaded, see llaisysQwen2ModelLoadSafetensors.
+    size_t loadSafetensors(const std::vector<std::string> &paths);
+
+    // Write all weights and the model metadata to a model image, see llaisysQwen2ModelSaveImage.
+    void saveImage(const std::string &path);
+    // Use the weights of `image`, which must have been saved from a model of the same
+    // architecture and dtype, and return the number of tensors loaded.
+    size_t loadImage(ModelImage &image);
+    // Metadata stored in `image`.
+    static LlaisysQwen2Meta imageMeta(const ModelImage &image);
+
+    // Keep at most `max_resident_bytes` of mapped layer weights in memory, prefetching
+    // `prefetch_layers` layers ahead of the forward pass; 0 bytes disables the limit.
+    // See llaisysQwen2ModelSetWeightResidency.
+    void setWeightResidency(size_t max_resident_bytes, size_t prefetch_layers);
+    size_t residentWeightBytes();
+
+    // Record the kernels of the first single-token forward pass and replay them for the
+    // next ones (on by default). See llaisysQwen2ModelSetOpCapture.
+    void setOpCapture(bool enable);
+    // Kernel launches and steps recorded for single-token passes; 0 until the first one.
+    size_t capturedOps() const;
+    // Run independent projections of small passes side by side (on by default).
+    // See llaisysQwen2ModelSetOpConcurrency.
+    void setOpConcurrency(bool enable);
+
+    // Replace the KV block pool with one of `block_size`-token blocks holding at least
+    // `max_tokens` tokens in total. Fails while any sequence other than the default one
+    // holds blocks.
+    void configureKVCache(size_t block_size, size_t max_tokens);
+    KVBlockPool &kvPool();
+
+    // Create an empty sequence of at most `capacity` tokens backed by the block pool.
+    std::unique_ptr<KVCache> createCache(size_t capacity);
+
+    // Run all layers once over the new tokens of every entry, append their keys and
+    // values to the entries' caches and pick the requested next tokens. The total
+    // number of new tokens must not exceed prefillChunk().
+    void forward(std::vector<BatchEntry> &batch);
+
+    // Number of tokens currently held in the KV cache.
+    size_t cacheLength() const;
+    // Drop the KV cache so that the next call starts a new sequence.
+    void reset();
+
+    // Maximum number of tokens processed by one forward pass. Changing it
+    // reallocates the workspace.
+    size_t prefillChunk() const;
+    void setPrefillChunk(size_t chunk);
+
+    // Append `ntoken` tokens to the KV cache chunk by chunk without computing logits.
+    void prefill(const int64_t *token_ids, size_t ntoken);
+
+    // Append `ntoken` tokens to the sequence and return the greedy next token.
+    int64_t infer(const int64_t *token_ids, size_t ntoken);
+
+    // Append `ntoken` tokens to `cache` (e.g. a fork of another sequence) and return the
+    // next token, see llaisysQwen2SequenceInfer.
+    int64_t infer(KVCache &cache, const int64_t *token_ids, size_t ntoken,
+                  const LlaisysQwen2SamplingParams *params, std::mt19937_64 &rng, float *logits);
+
+    // Generate up to `max_new_tokens` tokens for a new sequence, see llaisysQwen2ModelGenerate.
+    size_t generate(const int64_t *token_ids, size_t ntoken, size_t max_new_tokens,
+                    const LlaisysQwen2SamplingParams *params,
+                    llaisysQwen2TokenCallback callback, void *userdata, int64_t *out_tokens);
+};
+} // namespace llaisys::models
@@ -0,0 +1,447 @@
+#include "qwen2_scheduler.hpp"
+
+#include "../../core/metrics/metrics.hpp"
+#include "../../utils.hpp"
+
+#include <algorithm>
+#include <cstring>
+
+namespace llaisys::models {
+Qwen2Scheduler::Qwen2Scheduler(Qwen2 &model, size_t max_batch_seqs)
+    : _model(model), _max_batch_seqs(max_batch_seqs), _next_id(1), _active(0), _stop(false),
+      _mode(LLAISYS_QWEN2_PREEMPT_RECOMPUTE), _stats{}, _published_waiting(0), _published_running(0) {
+    CHECK_ARGUMENT(max_batch_seqs > 0, "Qwen2Scheduler: max_batch_seqs must be positive");
+    // Give the blocks of the model's own sequence back to the pool.
+    _model.reset();
+    _updateStats();
+    _worker = std::thread([this] { _loop(); });
+}
+
+Qwen2Scheduler::~Qwen2Scheduler() {
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _stop = true;
+    }
+    _work_cv.notify_all();
+    _worker.join();
+
+    // Fail whatever did not complete so that nobody keeps waiting on it.
+    std::lock_guard<std::mutex> lock(_mutex);
+    for (auto &[id, request] : _requests) {
+        if (request->status == LLAISYS_QWEN2_REQUEST_RUNNING) {
+            request->status = LLAISYS_QWEN2_REQUEST_FAILED;
+        }
+    }
+    _token_cv.notify_all();
+    _stats.waiting = 0;
+    _stats.running = 0;
+    _publishTotals();
+}
+
+uint64_t Qwen2Scheduler::submit(const int64_t *token_ids, size_t ntoken, size_t max_new_tokens, int priority,
+                                const LlaisysQwen2SamplingParams *params,
+                                llaisysQwen2TokenCallback callback, void *userdata) {
+    const LlaisysQwen2Meta &meta = _model.meta();
+    CHECK_ARGUMENT(ntoken > 0, "Qwen2Scheduler: prompt must not be empty");
+    CHECK_ARGUMENT(ntoken <= meta.maxseq, "Qwen2Scheduler: prompt exceeds maxseq");
+
+    auto request = std::make_shared<Request>();
+    request->priority = priority;
+    request->max_new_tokens = max_new_tokens;
+    request->capacity = std::min(meta.maxseq, ntoken + max_new_tokens);
+    request->sample = params != nullptr;
+    request->params = params != nullptr ? *params : LlaisysQwen2SamplingParams{1, 1.0f, 0.0f, 0};
+    request->rng.seed(request->params.seed);
+    request->callback = callback;
+    request->userdata = userdata;
+    request->seq.assign(token_ids, token_ids + ntoken);
+    request->ngenerated = 0;
+    request->swap_len = 0;
+    request->last_event = core::metricsClock();
+    request->npolled = 0;
+    request->status = LLAISYS_QWEN2_REQUEST_RUNNING;
+    request->cancelled = false;
+
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        CHECK_ARGUMENT(_model.kvPool().blocksFor(ntoken) <= _model.kvPool().numBlocks(),
+                       "Qwen2Scheduler: prompt does not fit into the KV cache");
+        request->id = _next_id++;
+        _requests[request->id] = request;
+        if (max_new_tokens == 0) {
+            request->status = LLAISYS_QWEN2_REQUEST_FINISHED;
+            return request->id;
+        }
+        _enqueue(request, false);
+        _active++;
+        _stats.waiting = _waiting.size();
+        _publishTotals();
+    }
+    core::metrics().recordRequest();
+    _work_cv.notify_one();
+    return request->id;
+}
+
+size_t Qwen2Scheduler::poll(uint64_t id, int64_t *out_tokens, size_t capacity, bool block,
+                            llaisysQwen2RequestStatus_t *status) {
+    std::unique_lock<std::mutex> lock(_mutex);
+    auto it = _requests.find(id);
+    CHECK_ARGUMENT(it != _requests.end(), "Qwen2Scheduler: unknown request id");
+    request_t request = it->second;
+
+    if (block) {
+        _token_cv.wait(lock, [&] {
+            return request->npolled < request->tokens.size() || request->status != LLAISYS_QWEN2_REQUEST_RUNNING;
+        });
+    }
+
+    size_t count = std::min(capacity, request->tokens.size() - request->npolled);
+    if (count > 0 && out_tokens != nullptr) {
+        std::memcpy(out_tokens, request->tokens.data() + request->npolled, count * sizeof(int64_t));
+    }
+    request->npolled += count;
+
+    // A request is reported as done only once all of its tokens have been read,
+    // after which its id is released.
+    llaisysQwen2RequestStatus_t result = request->status;
+    if (request->npolled < request->tokens.size()) {
+        result = LLAISYS_QWEN2_REQUEST_RUNNING;
+    } else if (result != LLAISYS_QWEN2_REQUEST_RUNNING) {
+        _requests.erase(it);
+    }
+    if (status != nullptr) {
+        *status = result;
+    }
+    return count;
+}
+
+void Qwen2Scheduler::cancel(uint64_t id) {
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        auto it = _requests.find(id);
+        if (it == _requests.end()) {
+            return;
+        }
+        request_t request = it->second;
+        request->cancelled = true;
+
+        // A waiting request holds no KV blocks: retire it now rather than when it
+        // reaches the front of the queue. Running ones stop at the next iteration.
+        auto waiting = std::find(_waiting.begin(), _waiting.end(), request);
+        if (waiting == _waiting.end()) {
+            return;
+        }
+        _waiting.erase(waiting);
+        request->swap = std::vector<std::byte>();
+        request->swap_len = 0;
+        request->status = LLAISYS_QWEN2_REQUEST_FINISHED;
+        _active--;
+        _stats.waiting = _waiting.size();
+        _publishTotals();
+    }
+    _token_cv.notify_all();
+}
+
+size_t Qwen2Scheduler::pending() {
+    std::lock_guard<std::mutex> lock(_mutex);
+    return _active;
+}
+
+void Qwen2Scheduler::setPreemptionMode(llaisysQwen2PreemptionMode_t mode) {
+    CHECK_ARGUMENT(mode == LLAISYS_QWEN2_PREEMPT_RECOMPUTE || mode == LLAISYS_QWEN2_PREEMPT_SWAP,
+                   "Qwen2Scheduler: unknown preemption mode");
+    std::lock_guard<std::mutex> lock(_mutex);
+    _mode = mode;
+}
+
+LlaisysQwen2SchedulerStats Qwen2Scheduler::stats() {
+    std::lock_guard<std::mutex> lock(_mutex);
+    return _stats;
+}
+
+void Qwen2Scheduler::_enqueue(const request_t &request, bool front) {
+    auto it = std::find_if(_waiting.begin(), _waiting.end(), [&](const request_t &r) {
+        return front ? r->priority <= request->priority : r->priority < request->priority;
+    });
+    _waiting.insert(it, request);
+}
+
+bool Qwen2Scheduler::_emit(Request &request, int64_t token) {
+    const uint64_t now = core::metricsClock();
+    core::metrics().recordToken(request.ngenerated == 0, now - request.last_event);
+    request.last_event = now;
+    request.seq.push_back(token);
+    request.ngenerated++;
+    bool cancelled;
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        request.tokens.push_back(token);
+        cancelled = request.cancelled;
+    }
+    _token_cv.notify_all();
+
+    if (request.callback != nullptr && request.callback(token, request.userdata) != 0) {
+        cancelled = true;
+    }
+    return cancelled || token == _model.meta().end_token || request.ngenerated >= request.max_new_tokens
+        || request.cache->length() >= request.capacity;
+}
+
+void Qwen2Scheduler::_finish(Request &request, llaisysQwen2RequestStatus_t status) {
+    request.cache.reset();
+    request.swap = std::vector<std::byte>();
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        request.status = status;
+        _active--;
+    }
+    _token_cv.notify_all();
+}
+
+void Qwen2Scheduler::_preempt(const request_t &request, llaisysQwen2PreemptionMode_t mode) {
+    if (mode == LLAISYS_QWEN2_PREEMPT_SWAP && request->cache->length() > 0) {
+        request->cache->save(request->swap);
+        request->swap_len = request->cache->length();
+    }
+    request->cache.reset();
+    _running.erase(std::find(_running.begin(), _running.end(), request));
+
+    std::lock_guard<std::mutex> lock(_mutex);
+    _stats.preemptions++;
+    if (request->swap_len > 0) {
+        _stats.swap_outs++;
+    }
+    _enqueue(request, true);
+}
+
+void Qwen2Scheduler::_admit() {
+    KVBlockPool &pool = _model.kvPool();
+    std::vector<request_t> admitted;
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        // Keep one spare block per running sequence so that admitted prompts do not
+        // immediately force running sequences out.
+        size_t reserved = _running.size();
+        size_t free = pool.numFree();
+        while (!_waiting.empty() && _running.size() + admitted.size() < _max_batch_seqs) {
+            const request_t &request = _waiting.front();
+            if (request->cancelled) {
+                // Cancelled while running, then preempted back into the queue.
+                request->status = LLAISYS_QWEN2_REQUEST_FINISHED;
+                request->swap = std::vector<std::byte>();
+                _active--;
+                _waiting.pop_front();
+                _token_cv.notify_all();
+                continue;
+            }
+            size_t context = request->swap_len > 0 ? request->swap_len : request->seq.size();
+            size_t needed = pool.blocksFor(std::min(context + 1, request->capacity));
+            if (needed + reserved > free) {
+                if (_running.empty() && admitted.empty() && needed > pool.numBlocks()) {
+                    // Can never fit, even into an empty pool.
+                    request->status = LLAISYS_QWEN2_REQUEST_FAILED;
+                    _active--;
+                    _waiting.pop_front();
+                    _token_cv.notify_all();
+                    continue;
+                }
+                break; // keep priority order: do not let smaller requests overtake
+            }
+            free -= needed;
+            reserved++;
+            admitted.push_back(request);
+            _waiting.pop_front();
+        }
+    }
+
+    for (auto &request : admitted) {
+        const bool swapped = request->swap_len > 0;
+        try {
+            request->cache = _model.createCache(request->capacity);
+            if (swapped) {
+                request->cache->restore(request->swap, request->swap_len);
+                request->swap = std::vector<std::byte>();
+                request->swap_len = 0;
+            }
+        } catch (const std::exception &) {
+            // Only this request is affected: it is in neither the queue nor the batch.
+            _finish(*request, LLAISYS_QWEN2_REQUEST_FAILED);
+            continue;
+        }
+        if (!swapped && request->ngenerated > 0) {
+            std::lock_guard<std::mutex> lock(_mutex);
+            _stats.recomputed_tokens += request->seq.size() - 1;
+        }
+        _running.push_back(request);
+    }
+}
+
+void Qwen2Scheduler::_updateStats() {
+    const KVBlockPool &pool = _model.kvPool();
+    size_t kv_bytes = 0;
+    for (const auto &request : _running) {
+        kv_bytes += request->cache->bytes();
+    }
+
+    std::lock_guard<std::mutex> lock(_mutex);
+    size_t swapped = 0, swap_bytes = 0;
+    for (const auto &request : _waiting) {
+        if (request->swap_len > 0) {
+            swapped++;
+            swap_bytes += request->swap.size();
+        }
+    }
+    _stats.waiting = _waiting.size();
+    _stats.running = _running.size();
+    _stats.swapped = swapped;
+    _stats.kv_block_size = pool.blockSize();
+    _stats.kv_blocks_total = pool.numBlocks();
+    _stats.kv_blocks_used = pool.numBlocks() - pool.numFree();
+    _stats.kv_bytes_used = kv_bytes;
+    _stats.swap_bytes = swap_bytes;
+    _publishTotals();
+}
+
+void Qwen2Scheduler::_publishTotals() {
+    core::metrics().addQueueDepth(static_cast<int64_t>(_stats.waiting) - static_cast<int64_t>(_published_waiting));
+    core::metrics().addRunning(static_cast<int64_t>(_stats.running) - static_cast<int64_t>(_published_running));
+    _published_waiting = _stats.waiting;
+    _published_running = _stats.running;
+}
+
+void Qwen2Scheduler::_step(llaisysQwen2PreemptionMode_t mode) {
+    // Drop cancelled sequences, then fill free slots.
+    for (auto &request : _running) {
+        std::lock_guard<std::mutex> lock(_mutex);
+        if (request->cancelled) {
+            request->cache.reset();
+        }
+    }
+    for (auto &request : _running) {
+        if (request->cache == nullptr) {
+            _finish(*request, LLAISYS_QWEN2_REQUEST_FINISHED);
+        }
+    }
+    _running.erase(std::remove_if(_running.begin(), _running.end(),
+                                  [](const request_t &r) { return r->cache == nullptr; }),
+                   _running.end());
+    _admit();
+    if (_running.empty()) {
+        return;
+    }
+
+    // Decode steps go first so that running sequences keep a steady token rate;
+    // the remaining token budget is filled with prefill chunks in arrival order.
+    std::vector<request_t> order;
+    for (auto &request : _running) {
+        if (request->seq.size() - request->cache->length() == 1) {
+            order.push_back(request);
+        }
+    }
+    for (auto &request : _running) {
+        if (request->seq.size() - request->cache->length() > 1) {
+            order.push_back(request);
+        }
+    }
+
+    size_t budget = _model.prefillChunk();
+    std::vector<request_t> owners;
+    std::vector<size_t> counts;
+    for (auto &request : order) {
+        if (budget == 0) {
+            break;
+        }
+        if (request->cache == nullptr) {
+            continue; // preempted while making room for an earlier sequence
+        }
+        size_t n = std::min(budget, request->seq.size() - request->cache->length());
+
+        // Make room in the pool, preempting the lowest priority, most recent sequence.
+        while (!request->cache->reserve(n)) {
+            request_t victim = *std::min_element(_running.begin(), _running.end(),
+                                                 [](const request_t &a, const request_t &b) {
+                                                     return a->priority != b->priority ? a->priority < b->priority
+                                                                                       : a->id > b->id;
+                                                 });
+            if (victim == request && _running.size() == 1) {
+                break; // alone and still out of blocks: the pool is full
+            }
+            auto planned = std::find(owners.begin(), owners.end(), victim);
+            if (planned != owners.end()) {
+                budget += counts[planned - owners.begin()];
+                counts.erase(counts.begin() + (planned - owners.begin()));
+                owners.erase(planned);
+            }
+            _preempt(victim, mode);
+            if (victim == request) {
+                break;
+            }
+        }
+        if (request->cache == nullptr) {
+            continue;
+        }
+        if (request->cache->blocksNeeded(n) > 0) {
+            _finish(*request, LLAISYS_QWEN2_REQUEST_FINISHED);
+            _running.erase(std::find(_running.begin(), _running.end(), request));
+            continue;
+        }
+        owners.push_back(request);
+        counts.push_back(n);
+        budget -= n;
+    }
+
+    std::vector<Qwen2::BatchEntry> batch;
+    for (size_t i = 0; i < owners.size(); i++) {
+        Request &request = *owners[i];
+        const size_t begin = request.cache->length();
+        const bool pick = begin + counts[i] == request.seq.size();
+        const LlaisysQwen2SamplingParams *params = request.sample ? &request.params : nullptr;
+        batch.push_back({request.cache.get(), request.seq.data() + begin, counts[i], pick, params, &request.rng, 0});
+    }
+
+    _model.forward(batch);
+
+    for (size_t i = 0; i < batch.size(); i++) {
+        Request &request = *owners[i];
+        if (batch[i].pick && _emit(request, batch[i].next_token)) {
+            _finish(request, LLAISYS_QWEN2_REQUEST_FINISHED);
+        }
+    }
+    _running.erase(std::remove_if(_running.begin(), _running.end(),
+                                  [](const request_t &r) { return r->cache == nullptr; }),
+                   _running.end());
+}
+
+void Qwen2Scheduler::_loop() {
+    while (true) {
+        llaisysQwen2PreemptionMode_t mode;
+        {
+            std::unique_lock<std::mutex> lock(_mutex);
+            _work_cv.wait(lock, [&] { return _stop || !_waiting.empty() || !_running.empty(); });
+            if (_stop) {
+                break;
+            }
+            mode = _mode;
+        }
+
+        try {
+            _step(mode);
+        } catch (const std::exception &) {
+            // A forward pass, or KV memory for a swap or a copy-on-write block, failed
+            // midway: the running sequences may be inconsistent, so fail all of them.
+            for (auto &request : _running) {
+                _finish(*request, LLAISYS_QWEN2_REQUEST_FAILED);
+            }
+            _running.clear();
+        }
+        _updateStats();
+    }
+
+    // Storage is owned by the runtime of the thread that allocated it, so the
+    // caches must be released before this thread exits.
+    for (auto &request : _running) {
+        request->cache.reset();
+    }
+    _running.clear();
+}
+} // namespace llaisys::models
@@ -0,0 +1,118 @@
+#pragma once
+
+#include "qwen2.hpp"
+
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+namespace llaisys::models {
+// Continuous-batching scheduler. Requests may be submitted and polled from any
+// thread; a worker thread forms one batch per iteration out of the running
+// sequences (one decode token each, then prefill chunks of new prompts up to the
+// model's prefill chunk), runs a single batched forward and retires sequences as
+// soon as they finish, admitting waiting requests into the freed slots.
+//
+// KV memory comes from the model's fixed block pool. A waiting request is only
+// admitted when its context fits into the free blocks (keeping one spare block
+// per running sequence), and when a running sequence cannot grow, the lowest
+// priority (then most recent) sequence is preempted: its KV is either copied to
+// a host buffer or dropped and recomputed when it is resumed.
+//
+// While a scheduler exists it owns the model: do not call prefill / infer /
+// generate on the same model concurrently.
+class Qwen2Scheduler {
+private:
+    struct Request {
+        uint64_t id;
+        int priority;
+        size_t max_new_tokens;
+        size_t capacity; // maximum sequence length
+        bool sample;
+        LlaisysQwen2SamplingParams params;
+        std::mt19937_64 rng;
+        llaisysQwen2TokenCallback callback;
+        void *userdata;
+
+        // Worker-only state, except that cancel() drops the swap of a waiting request
+        std::vector<int64_t> seq; // prompt followed by the generated tokens
+        size_t ngenerated;
+        std::unique_ptr<KVCache> cache;
+        std::vector<std::byte> swap; // KV of a swapped-out sequence
+        size_t swap_len;
+        uint64_t last_event; // metrics clock at submission, then at the last token
+
+        // Guarded by the scheduler mutex
+        std::vector<int64_t> tokens;
+        size_t npolled;
+        llaisysQwen2RequestStatus_t status;
+        bool cancelled;
+    };
+    using request_t = std::shared_ptr<Request>;
+
+    Qwen2 &_model;
+    size_t _max_batch_seqs;
+
+    std::mutex _mutex;
+    std::condition_variable _work_cv;  // wakes the worker on new requests / shutdown
+    std::condition_variable _token_cv; // wakes blocking pollers on new tokens
+    std::deque<request_t> _waiting;    // highest priority first
+    std::unordered_map<uint64_t, request_t> _requests;
+    uint64_t _next_id;
+    size_t _active; // queued or running requests
+    bool _stop;
+    llaisysQwen2PreemptionMode_t _mode;
+    LlaisysQwen2SchedulerStats _stats;
+    size_t _published_waiting; // share of the process-wide metrics totals
+    size_t _published_running;
+
+    std::vector<request_t> _running; // worker thread only
+    std::thread _worker;
+
+    void _loop();
+    // One iteration of the worker: admit, form a batch, run it and retire finished
+    // sequences. Throws if KV memory or the forward pass fails.
+    void _step(llaisysQwen2PreemptionMode_t mode);
+    // Move admissible waiting requests to `_running`.
+    void _admit();
+    // Release the KV of a running request and put it back into the waiting queue.
+    void _preempt(const request_t &request, llaisysQwen2PreemptionMode_t mode);
+    // Queue a request behind those of higher (or, unless `front`, equal) priority. Locked by the caller.
+    void _enqueue(const request_t &request, bool front);
+    // Record a generated token; returns true if the request is done.
+    bool _emit(Request &request, int64_t token);
+    void _finish(Request &request, llaisysQwen2RequestStatus_t status);
+    void _updateStats();
+    // Bring this scheduler's share of the metrics totals up to `_stats`. Locked by the caller.
+    void _publishTotals();
+
+public:
+    Qwen2Scheduler(Qwen2 &model, size_t max_batch_seqs);
+    ~Qwen2Scheduler();
+
+    // Prevent copying
+    Qwen2Scheduler(const Qwen2Scheduler &) = delete;
+    Qwen2Scheduler &operator=(const Qwen2Scheduler &) = delete;
+
+    // Queue a new sequence and return its request id, see llaisysQwen2SchedulerSubmit.
+    uint64_t submit(const int64_t *token_ids, size_t ntoken, size_t max_new_tokens, int priority,
+                    const LlaisysQwen2SamplingParams *params,
+                    llaisysQwen2TokenCallback callback, void *userdata);
+
+    // Copy up to `capacity` tokens generated since the last poll, see llaisysQwen2SchedulerPoll.
+    size_t poll(uint64_t id, int64_t *out_tokens, size_t capacity, bool block,
+                llaisysQwen2RequestStatus_t *status);
+
+    void cancel(uint64_t id);
+
+    // Number of requests that are queued or running.
+    size_t pending();
+
+    void setPreemptionMode(llaisysQwen2PreemptionMode_t mode);
+    LlaisysQwen2SchedulerStats stats();
+};
+} // namespace llaisys::models
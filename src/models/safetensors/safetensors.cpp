@@ -0,0 +1,236 @@
+#include "safetensors.hpp"
+
+#include "../../utils.hpp"
+
+namespace llaisys::models {
+namespace {
+llaisysDataType_t parseDtype(const std::string &name) {
+    static const std::pair<const char *, llaisysDataType_t> dtypes[] = {
+        {"BOOL", LLAISYS_DTYPE_BOOL}, {"U8", LLAISYS_DTYPE_U8}, {"I8", LLAISYS_DTYPE_I8},
+        {"I16", LLAISYS_DTYPE_I16}, {"I32", LLAISYS_DTYPE_I32}, {"I64", LLAISYS_DTYPE_I64},
+        {"U16", LLAISYS_DTYPE_U16}, {"U32", LLAISYS_DTYPE_U32}, {"U64", LLAISYS_DTYPE_U64},
+        {"F16", LLAISYS_DTYPE_F16}, {"BF16", LLAISYS_DTYPE_BF16}, {"F32", LLAISYS_DTYPE_F32},
+        {"F64", LLAISYS_DTYPE_F64}};
+    for (const auto &[str, dtype] : dtypes) {
+        if (name == str) {
+            return dtype;
+        }
+    }
+    return LLAISYS_DTYPE_INVALID;
+}
+
+// Just enough JSON to read a safetensors header: an object of objects holding
+// strings and arrays of integers. Anything else is skipped.
+class HeaderParser {
+private:
+    const char *_p;
+    const char *_end;
+
+    void _fail() const {
+        throw std::invalid_argument("safetensors: malformed header");
+    }
+
+public:
+    HeaderParser(const char *data, size_t size) : _p(data), _end(data + size) {}
+
+    void skipSpace() {
+        while (_p < _end && (*_p == ' ' || *_p == '\n' || *_p == '\r' || *_p == '\t')) {
+            _p++;
+        }
+    }
+
+    bool consume(char c) {
+        skipSpace();
+        if (_p < _end && *_p == c) {
+            _p++;
+            return true;
+        }
+        return false;
+    }
+
+    void expect(char c) {
+        if (!consume(c)) {
+            _fail();
+        }
+    }
+
+    char peek() {
+        skipSpace();
+        if (_p == _end) {
+            _fail();
+        }
+        return *_p;
+    }
+
+    std::string string() {
+        expect('"');
+        std::string s;
+        while (_p < _end && *_p != '"') {
+            if (*_p == '\\') {
+                // Escapes only occur in names and metadata; keep the escaped character.
+                if (++_p == _end) {
+                    _fail();
+                }
+            }
+            s.push_back(*_p++);
+        }
+        expect('"');
+        return s;
+    }
+
+    size_t integer() {
+        skipSpace();
+        if (_p == _end || *_p < '0' || *_p > '9') {
+            _fail();
+        }
+        size_t v = 0;
+        while (_p < _end && *_p >= '0' && *_p <= '9') {
+            v = v * 10 + static_cast<size_t>(*_p++ - '0');
+        }
+        return v;
+    }
+
+    std::vector<size_t> integers() {
+        std::vector<size_t> values;
+        expect('[');
+        if (!consume(']')) {
+            do {
+                values.push_back(integer());
+            } while (consume(','));
+            expect(']');
+        }
+        return values;
+    }
+
+    void skipValue() {
+        switch (peek()) {
+        case '"':
+            string();
+            return;
+        case '{':
+            expect('{');
+            if (!consume('}')) {
+                do {
+                    string();
+                    expect(':');
+                    skipValue();
+                } while (consume(','));
+                expect('}');
+            }
+            return;
+        case '[':
+            expect('[');
+            if (!consume(']')) {
+                do {
+                    skipValue();
+                } while (consume(','));
+                expect(']');
+            }
+            return;
+        default:
+            // Number, true, false or null.
+            while (_p < _end && *_p != ',' && *_p != '}' && *_p != ']') {
+                _p++;
+            }
+        }
+    }
+};
+} // namespace
+
+SafetensorsFile::SafetensorsFile(const std::string &path) : _file(path), _data_offset(0) {
+    const std::byte *base = _file.data();
+    CHECK_ARGUMENT(_file.size() >= 8, "safetensors: file too small");
+    uint64_t header_size = 0;
+    for (int i = 7; i >= 0; i--) {
+        header_size = (header_size << 8) | static_cast<uint8_t>(base[i]);
+    }
+    CHECK_ARGUMENT(header_size <= _file.size() - 8, "safetensors: header exceeds file");
+    _data_offset = 8 + header_size;
+    _parseHeader(reinterpret_cast<const char *>(base + 8), header_size);
+}
+
+void SafetensorsFile::_parseHeader(const char *header, size_t size) {
+    HeaderParser parser(header, size);
+    parser.expect('{');
+    if (parser.consume('}')) {
+        return;
+    }
+    do {
+        std::string name = parser.string();
+        parser.expect(':');
+        if (name == "__metadata__") {
+            parser.skipValue();
+            continue;
+        }
+        SafetensorsEntry entry{name, "", LLAISYS_DTYPE_INVALID, {}, 0, 0};
+        std::vector<size_t> offsets;
+        parser.expect('{');
+        do {
+            std::string key = parser.string();
+            parser.expect(':');
+            if (key == "dtype") {
+                entry.dtype_name = parser.string();
+                entry.dtype = parseDtype(entry.dtype_name);
+            } else if (key == "shape") {
+                entry.shape = parser.integers();
+            } else if (key == "data_offsets") {
+                offsets = parser.integers();
+            } else {
+                parser.skipValue();
+            }
+        } while (parser.consume(','));
+        parser.expect('}');
+
+        CHECK_ARGUMENT(!entry.dtype_name.empty() && offsets.size() == 2 && offsets[0] <= offsets[1],
+                       "safetensors: incomplete tensor entry");
+        CHECK_ARGUMENT(offsets[1] <= _file.size() - _data_offset, "safetensors: tensor data exceeds file");
+        size_t numel = 1;
+        for (size_t d : entry.shape) {
+            numel *= d;
+        }
+        entry.offset = offsets[0];
+        entry.size = offsets[1] - offsets[0];
+        // The element size of an unknown dtype is unknown too (it may be packed).
+        CHECK_ARGUMENT(entry.dtype == LLAISYS_DTYPE_INVALID || entry.size == numel * utils::dsize(entry.dtype),
+                       "safetensors: tensor size does not match shape");
+        _entries.push_back(std::move(entry));
+    } while (parser.consume(','));
+    parser.expect('}');
+}
+
+const std::string &SafetensorsFile::path() const {
+    return _file.path();
+}
+
+bool SafetensorsFile::locked() const {
+    return _file.locked();
+}
+
+const std::vector<SafetensorsEntry> &SafetensorsFile::tensors() const {
+    return _entries;
+}
+
+const SafetensorsEntry *SafetensorsFile::find(const std::string &name) const {
+    for (const auto &entry : _entries) {
+        if (entry.name == name) {
+            return &entry;
+        }
+    }
+    return nullptr;
+}
+
+void SafetensorsFile::_checkSupported(const SafetensorsEntry &entry) {
+    CHECK_ARGUMENT(entry.dtype != LLAISYS_DTYPE_INVALID,
+                   "safetensors: unsupported dtype " + entry.dtype_name + " of " + entry.name);
+}
+
+const std::byte *SafetensorsFile::data(const SafetensorsEntry &entry) const {
+    _checkSupported(entry);
+    return _file.data() + _data_offset + entry.offset;
+}
+
+tensor_t SafetensorsFile::view(const SafetensorsEntry &entry) {
+    _checkSupported(entry);
+    return _file.view(entry.shape, entry.dtype, _data_offset + entry.offset);
+}
+} // namespace llaisys::models
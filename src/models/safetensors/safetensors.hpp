@@ -0,0 +1,46 @@
+#pragma once
+
+#include "../mapped_file/mapped_file.hpp"
+
+#include <string>
+#include <vector>
+
+namespace llaisys::models {
+// One tensor of a safetensors file; `offset` is relative to the start of the data section.
+// Tensors of a dtype LLAISYS has no type for (e.g. F8_E4M3) are listed with an invalid
+// dtype and only fail when their data is used.
+struct SafetensorsEntry {
+    std::string name;
+    std::string dtype_name; // as written in the header
+    llaisysDataType_t dtype;
+    std::vector<size_t> shape;
+    size_t offset;
+    size_t size;
+};
+
+// Read-only view of a memory-mapped safetensors file.
+class SafetensorsFile {
+private:
+    MappedFile _file;
+    size_t _data_offset; // start of the data section
+    std::vector<SafetensorsEntry> _entries;
+
+    void _parseHeader(const char *header, size_t size);
+    static void _checkSupported(const SafetensorsEntry &entry);
+
+public:
+    explicit SafetensorsFile(const std::string &path);
+
+    const std::string &path() const;
+    // Whether the mapping is locked into RAM, see MappedFile.
+    bool locked() const;
+    const std::vector<SafetensorsEntry> &tensors() const;
+    const SafetensorsEntry *find(const std::string &name) const;
+    // Raw data of an entry; fails for an unsupported dtype.
+    const std::byte *data(const SafetensorsEntry &entry) const;
+
+    // Tensor pointing into the mapping, without copying. Only possible on CPU and
+    // when the data is aligned to its element size; returns null otherwise.
+    tensor_t view(const SafetensorsEntry &entry);
+};
+} // namespace llaisys::models
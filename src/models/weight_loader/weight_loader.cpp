@@ -0,0 +1,165 @@
+#include "weight_loader.hpp"
+
+#include "../../utils.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <exception>
+
+namespace llaisys::models {
+namespace {
+inline float bitsToFloat(uint32_t bits) {
+    float f;
+    std::memcpy(&f, &bits, sizeof(f));
+    return f;
+}
+
+inline uint32_t floatToBits(float f) {
+    uint32_t bits;
+    std::memcpy(&bits, &f, sizeof(bits));
+    return bits;
+}
+
+void bf16ToF32(uint32_t *dst, const uint16_t *src, size_t n) {
+#pragma omp simd
+    for (size_t i = 0; i < n; i++) {
+        dst[i] = static_cast<uint32_t>(src[i]) << 16;
+    }
+}
+
+void f32ToBf16(uint16_t *dst, const uint32_t *src, size_t n) {
+    // Round to nearest even, as utils::cast<bf16_t>.
+#pragma omp simd
+    for (size_t i = 0; i < n; i++) {
+        dst[i] = static_cast<uint16_t>((src[i] + 0x7FFF + ((src[i] >> 16) & 1)) >> 16);
+    }
+}
+
+void f16ToF32(uint32_t *dst, const uint16_t *src, size_t n) {
+    // Exact like utils::cast<float>, with the special cases as selects instead of branches.
+#pragma omp simd
+    for (size_t i = 0; i < n; i++) {
+        const uint32_t h = src[i];
+        uint32_t bits = (h & 0x7FFF) << 13;
+        const uint32_t exponent = bits & 0x0F800000;
+        bits += (127 - 15) << 23;
+        const uint32_t special = bits + ((128 - 16) << 23);                                 // Inf / NaN
+        const uint32_t subnormal = floatToBits(bitsToFloat(bits + (1 << 23)) - 6.103515625e-05f); // 2^-14
+        bits = exponent == 0x0F800000 ? special : (exponent == 0 ? subnormal : bits);
+        dst[i] = bits | ((h & 0x8000) << 16);
+    }
+}
+
+void toF32(float *dst, const std::byte *src, llaisysDataType_t dtype, size_t n) {
+    switch (dtype) {
+    case LLAISYS_DTYPE_F32:
+        std::memcpy(dst, src, n * sizeof(float));
+        return;
+    case LLAISYS_DTYPE_BF16:
+        return bf16ToF32(reinterpret_cast<uint32_t *>(dst), reinterpret_cast<const uint16_t *>(src), n);
+    case LLAISYS_DTYPE_F16:
+        return f16ToF32(reinterpret_cast<uint32_t *>(dst), reinterpret_cast<const uint16_t *>(src), n);
+    default:
+        EXCEPTION_UNSUPPORTED_DATATYPE(dtype);
+    }
+}
+
+void fromF32(std::byte *dst, llaisysDataType_t dtype, const float *src, size_t n) {
+    switch (dtype) {
+    case LLAISYS_DTYPE_F32:
+        std::memcpy(dst, src, n * sizeof(float));
+        return;
+    case LLAISYS_DTYPE_BF16:
+        return f32ToBf16(reinterpret_cast<uint16_t *>(dst), reinterpret_cast<const uint32_t *>(src), n);
+    case LLAISYS_DTYPE_F16:
+        for (size_t i = 0; i < n; i++) {
+            reinterpret_cast<fp16_t *>(dst)[i] = utils::cast<fp16_t>(src[i]);
+        }
+        return;
+    default:
+        EXCEPTION_UNSUPPORTED_DATATYPE(dtype);
+    }
+}
+} // namespace
+
+void convertValues(std::byte *dst, llaisysDataType_t dst_dtype,
+                   const std::byte *src, llaisysDataType_t src_dtype, size_t n) {
+    if (dst_dtype == src_dtype) {
+        std::memcpy(dst, src, n * utils::dsize(dst_dtype));
+    } else if (dst_dtype == LLAISYS_DTYPE_F32) {
+        toF32(reinterpret_cast<float *>(dst), src, src_dtype, n);
+    } else if (src_dtype == LLAISYS_DTYPE_F32) {
+        fromF32(dst, dst_dtype, reinterpret_cast<const float *>(src), n);
+    } else {
+        // Between the two 16-bit types, through a small F32 buffer.
+        constexpr size_t kBlock = 1024;
+        float tmp[kBlock];
+        for (size_t i = 0; i < n; i += kBlock) {
+            const size_t m = std::min(kBlock, n - i);
+            toF32(tmp, src + i * utils::dsize(src_dtype), src_dtype, m);
+            fromF32(dst + i * utils::dsize(dst_dtype), dst_dtype, tmp, m);
+        }
+    }
+}
+
+void WeightLoader::add(tensor_t dst, std::shared_ptr<SafetensorsFile> file, const SafetensorsEntry &entry) {
+    CHECK_ARGUMENT(dst->isContiguous(), "WeightLoader: destination must be contiguous");
+    CHECK_ARGUMENT(entry.dtype != LLAISYS_DTYPE_INVALID,
+                   "WeightLoader: unsupported dtype " + entry.dtype_name + " of " + entry.name);
+    CHECK_ARGUMENT(entry.shape == dst->shape(), "WeightLoader: weight shape does not match the checkpoint");
+    _loads.push_back(Load{std::move(dst), std::move(file), &entry, {}});
+}
+
+size_t WeightLoader::size() const {
+    return _loads.size();
+}
+
+void WeightLoader::run() {
+    struct Chunk {
+        Load *load;
+        size_t begin;
+        size_t count;
+    };
+    std::vector<Chunk> chunks;
+    for (Load &load : _loads) {
+        if (load.dst->deviceType() != LLAISYS_DEVICE_CPU) {
+            load.staging.resize(load.dst->numel() * load.dst->elementSize());
+        }
+        const size_t numel = load.dst->numel();
+        for (size_t begin = 0; begin < numel; begin += kChunkElements) {
+            chunks.push_back(Chunk{&load, begin, std::min(kChunkElements, numel - begin)});
+        }
+    }
+
+    // Exceptions must not leave the parallel region; keep the first and rethrow it.
+    std::exception_ptr error;
+#pragma omp parallel for schedule(dynamic)
+    for (ptrdiff_t i = 0; i < static_cast<ptrdiff_t>(chunks.size()); i++) {
+        const Chunk &chunk = chunks[i];
+        Load &load = *chunk.load;
+        const llaisysDataType_t dst_dtype = load.dst->dtype(), src_dtype = load.entry->dtype;
+        std::byte *dst = load.staging.empty() ? load.dst->data() : load.staging.data();
+        try {
+            convertValues(dst + chunk.begin * utils::dsize(dst_dtype), dst_dtype,
+                          load.file->data(*load.entry) + chunk.begin * utils::dsize(src_dtype), src_dtype,
+                          chunk.count);
+        } catch (...) {
+#pragma omp critical
+            if (!error) {
+                error = std::current_exception();
+            }
+        }
+    }
+
+    std::vector<Load> loads;
+    loads.swap(_loads);
+    if (error) {
+        std::rethrow_exception(error);
+    }
+    for (Load &load : loads) {
+        if (!load.staging.empty()) {
+            load.dst->load(load.staging.data());
+        }
+    }
+}
+} // namespace llaisys::models
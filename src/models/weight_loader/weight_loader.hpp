@@ -0,0 +1,41 @@
+#pragma once
+
+#include "../safetensors/safetensors.hpp"
+
+#include <memory>
+#include <vector>
+
+namespace llaisys::models {
+// Convert `n` values from `src_dtype` to `dst_dtype`, both one of F32, F16 and BF16
+// (a plain copy if they are equal). Conversions to F32 and between F32 and BF16
+// are written as branch-free loops the compiler vectorizes.
+void convertValues(std::byte *dst, llaisysDataType_t dst_dtype,
+                   const std::byte *src, llaisysDataType_t src_dtype, size_t n);
+
+// Copies checkpoint tensors into model weights, converting dtypes on the way.
+//
+// Loads are queued with add() and executed by run() on all OpenMP threads. Every
+// tensor is cut into chunks of kChunkElements elements, so a few large tensors
+// spread over all threads as well as many small ones spread over several files.
+// CPU weights are written in place; weights on other devices are converted into a
+// host staging buffer first and then copied over.
+class WeightLoader {
+public:
+    static constexpr size_t kChunkElements = size_t(1) << 20;
+
+private:
+    struct Load {
+        tensor_t dst;
+        std::shared_ptr<SafetensorsFile> file; // keeps the source mapped until run()
+        const SafetensorsEntry *entry;
+        std::vector<std::byte> staging;
+    };
+    std::vector<Load> _loads;
+
+public:
+    void add(tensor_t dst, std::shared_ptr<SafetensorsFile> file, const SafetensorsEntry &entry);
+    size_t size() const;
+    // Run and clear all queued loads.
+    void run();
+};
+} // namespace llaisys::models
@@ -0,0 +1,196 @@
+#include "weight_residency.hpp"
+
+#include "../../device/runtime_api.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <iostream>
+#include <unordered_map>
+#include <utility>
+
+#ifndef _WIN32
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+namespace llaisys::models {
+namespace {
+size_t pageSize() {
+#ifndef _WIN32
+    static const size_t size = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+    return size;
+#else
+    return 4096;
+#endif
+}
+} // namespace
+
+WeightResidency::WeightResidency(std::vector<std::vector<Range>> layers, const std::vector<Range> &shared,
+                                 size_t max_resident_bytes, size_t prefetch)
+    : _max_resident_bytes(max_resident_bytes), _prefetch(prefetch), _resident_bytes(0), _clock(0), _evictable(true),
+      _api(device::getRuntimeAPI(LLAISYS_DEVICE_CPU)), _stream(_api->create_stream()) {
+    const uintptr_t page = pageSize();
+    // madvise works on whole pages, but ranges need not start or end on one. Record the
+    // owner of every partly covered page; a page partly covered by two owners (two
+    // layers, or a layer and a shared weight) is never dropped, so evicting a layer
+    // cannot drop a neighbour's data, and it is not counted against any layer.
+    constexpr size_t kShared = SIZE_MAX;
+    std::unordered_map<uintptr_t, size_t> edge_owner;
+    auto mark_edge = [&](uintptr_t addr, size_t owner) {
+        if (addr % page != 0) {
+            auto [it, inserted] = edge_owner.emplace(addr / page * page, owner);
+            if (!inserted && it->second != owner) {
+                it->second = kShared;
+            }
+        }
+    };
+    auto mark = [&](const Range &range, size_t owner) {
+        mark_edge(reinterpret_cast<uintptr_t>(range.ptr), owner);
+        mark_edge(reinterpret_cast<uintptr_t>(range.ptr) + range.size, owner);
+    };
+    for (size_t i = 0; i < layers.size(); i++) {
+        for (const Range &range : layers[i]) {
+            mark(range, i);
+        }
+    }
+    for (const Range &range : shared) {
+        mark(range, kShared);
+    }
+
+    for (size_t i = 0; i < layers.size(); i++) {
+        Layer layer{{}, {}, 0, State::kResident, 0};
+        std::vector<std::pair<uintptr_t, uintptr_t>> owned;
+        for (const Range &range : layers[i]) {
+            uintptr_t begin = reinterpret_cast<uintptr_t>(range.ptr);
+            uintptr_t end = begin + range.size;
+            layer.ranges.push_back(Range{reinterpret_cast<std::byte *>(begin / page * page),
+                                         (end + page - 1) / page * page - begin / page * page});
+            // Round inward, unless the partly covered page belongs to this layer alone.
+            begin = begin % page == 0 || edge_owner.at(begin / page * page) == i ? begin / page * page
+                                                                               : (begin / page + 1) * page;
+            end = end % page == 0 || edge_owner.at(end / page * page) != i ? end / page * page : (end / page + 1) * page;
+            if (begin < end) {
+                owned.emplace_back(begin, end);
+            }
+        }
+        // Merge the pages shared by ranges of the same layer.
+        std::sort(owned.begin(), owned.end());
+        for (size_t j = 0; j < owned.size(); j++) {
+            if (j + 1 < owned.size() && owned[j + 1].first <= owned[j].second) {
+                owned[j + 1] = {owned[j].first, std::max(owned[j].second, owned[j + 1].second)};
+            } else {
+                layer.owned.push_back(Range{reinterpret_cast<std::byte *>(owned[j].first), owned[j].second - owned[j].first});
+            }
+        }
+        for (const Range &range : layer.owned) {
+            layer.bytes += range.size;
+        }
+        // Whatever was touched while loading counts as resident until evicted.
+        _resident_bytes += layer.bytes;
+        _layers.push_back(std::move(layer));
+    }
+}
+
+WeightResidency::~WeightResidency() {
+    // Waits for the prefetches still queued.
+    _api->destroy_stream(_stream);
+}
+
+void WeightResidency::_load(size_t layer) {
+    const size_t page = pageSize();
+    for (const Range &range : _layers[layer].ranges) {
+#ifndef _WIN32
+        madvise(range.ptr, range.size, MADV_WILLNEED);
+#endif
+        // Fault every page in now rather than in the middle of a matmul.
+        volatile const std::byte *p = range.ptr;
+        for (size_t off = 0; off < range.size; off += page) {
+            (void)p[off];
+        }
+    }
+}
+
+void WeightResidency::_runPrefetch(void *task) {
+    const Prefetch prefetch = *static_cast<Prefetch *>(task);
+    delete static_cast<Prefetch *>(task);
+    WeightResidency &self = *prefetch.residency;
+    std::unique_lock<std::mutex> lock(self._mutex);
+    Layer &layer = self._layers[prefetch.layer];
+    if (layer.state != State::kQueued) {
+        return; // already read in by beforeLayer()
+    }
+    layer.state = State::kLoading;
+    lock.unlock();
+    self._load(prefetch.layer);
+    lock.lock();
+    layer.state = State::kResident;
+    self._cv.notify_all();
+}
+
+bool WeightResidency::_inWindow(size_t layer, size_t current) const {
+    return (layer + _layers.size() - current) % _layers.size() <= _prefetch;
+}
+
+void WeightResidency::_evict(size_t current) {
+    while (_evictable && _resident_bytes > _max_resident_bytes) {
+        size_t victim = _layers.size();
+        for (size_t i = 0; i < _layers.size(); i++) {
+            if (_layers[i].state == State::kResident && !_inWindow(i, current)
+                && (victim == _layers.size() || _layers[i].last_use < _layers[victim].last_use)) {
+                victim = i;
+            }
+        }
+        if (victim == _layers.size()) {
+            return;
+        }
+#ifndef _WIN32
+        for (const Range &range : _layers[victim].owned) {
+            if (madvise(range.ptr, range.size, MADV_DONTNEED) != 0) {
+                // E.g. locked pages. Whatever was dropped is read back on the next use,
+                // but the rest of the layer stays resident, so stop evicting altogether.
+                std::cerr << "[WARNING] WeightResidency: cannot drop weights, residency is no longer bounded"
+                          << std::endl;
+                _evictable = false;
+                return;
+            }
+        }
+#endif
+        _layers[victim].state = State::kCold;
+        _resident_bytes -= _layers[victim].bytes;
+    }
+}
+
+void WeightResidency::beforeLayer(size_t layer) {
+    std::unique_lock<std::mutex> lock(_mutex);
+    Layer &current = _layers[layer];
+    if (current.state == State::kCold || current.state == State::kQueued) {
+        // Not prefetched in time: read it in on this thread. A queued prefetch finds
+        // the layer resident and does nothing.
+        if (current.state == State::kCold) {
+            _resident_bytes += current.bytes;
+        }
+        current.state = State::kLoading;
+        lock.unlock();
+        _load(layer);
+        lock.lock();
+        current.state = State::kResident;
+    }
+    _cv.wait(lock, [&] { return current.state == State::kResident; });
+    current.last_use = ++_clock;
+
+    for (size_t i = 1; i <= _prefetch && i < _layers.size(); i++) {
+        Layer &next = _layers[(layer + i) % _layers.size()];
+        if (next.state == State::kCold) {
+            next.state = State::kQueued;
+            _resident_bytes += next.bytes;
+            _api->launch_host_func(_stream, &WeightResidency::_runPrefetch, new Prefetch{this, (layer + i) % _layers.size()});
+        }
+    }
+    _evict(layer);
+}
+
+size_t WeightResidency::residentBytes() {
+    std::lock_guard<std::mutex> lock(_mutex);
+    return _resident_bytes;
+}
+} // namespace llaisys::models
@@ -0,0 +1,74 @@
+#pragma once
+
+#include "llaisys/runtime.h"
+
+#include <condition_variable>
+#include <cstddef>
+#include <mutex>
+#include <vector>
+
+namespace llaisys::models {
+// Bounds the resident set of file-mapped layer weights.
+//
+// Each layer is a list of memory ranges inside read-only file mappings. Before a
+// layer runs, beforeLayer() makes sure it is resident and queues the next
+// `prefetch` layers (wrapping around to the first layer for the next forward
+// pass) on a CPU runtime stream of its own. The stream advises the kernel to read them
+// ahead (MADV_WILLNEED) and touches every page, so the forward pass does not wait
+// on the disk. When the resident layers exceed `max_resident_bytes`, the least
+// recently used layers outside the prefetch window are dropped (MADV_DONTNEED)
+// and read back from the file on their next use. Only pages holding data of
+// the dropped layer alone are dropped and counted. The mapped pages must never
+// have been written, since dropping private pages discards changes, nor locked.
+class WeightResidency {
+public:
+    struct Range {
+        std::byte *ptr;
+        size_t size;
+    };
+
+private:
+    enum class State { kCold, kQueued, kLoading, kResident };
+    struct Layer {
+        std::vector<Range> ranges; // pages read in, rounded out
+        std::vector<Range> owned;  // pages dropped on eviction: those of no other layer or shared weight
+        size_t bytes;              // of the owned pages
+        State state;
+        uint64_t last_use;
+    };
+
+    std::vector<Layer> _layers;
+    size_t _max_resident_bytes;
+    size_t _prefetch;
+    size_t _resident_bytes; // resident and loading layers
+    uint64_t _clock;
+    bool _evictable; // false once dropping pages failed
+
+    std::mutex _mutex;
+    std::condition_variable _cv;
+    const LlaisysRuntimeAPI *_api;
+    llaisysStream_t _stream;
+
+    struct Prefetch {
+        WeightResidency *residency;
+        size_t layer;
+    };
+    static void _runPrefetch(void *task);
+    // Read a layer in; called without the lock held.
+    void _load(size_t layer);
+    void _evict(size_t current);
+    bool _inWindow(size_t layer, size_t current) const;
+
+public:
+    // `shared` are the other weights mapped from the same files, whose pages are never dropped.
+    WeightResidency(std::vector<std::vector<Range>> layers, const std::vector<Range> &shared, size_t max_resident_bytes,
+                    size_t prefetch);
+    ~WeightResidency();
+
+    WeightResidency(const WeightResidency &) = delete;
+    WeightResidency &operator=(const WeightResidency &) = delete;
+
+    void beforeLayer(size_t layer);
+    size_t residentBytes();
+};
+} // namespace llaisys::models
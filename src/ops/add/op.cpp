@@ -2,11 +2,14 @@
 
 #include "../../core/llaisys_core.hpp"
 #include "../../utils.hpp"
+#include "../capture/capture.hpp"
+#include "../trace/trace.hpp"
 
 #include "cpu/add_cpu.hpp"
 
 namespace llaisys::ops {
 void add(tensor_t c, tensor_t a, tensor_t b) {
+    TraceScope trace(LLAISYS_OP_ADD, c, a, b);
     CHECK_SAME_DEVICE(c, a, b);
     // Only support contiguous inputs with same shape for now.
     CHECK_SAME_SHAPE(c->shape(), a->shape(), b->shape());
@@ -15,14 +18,14 @@ void add(tensor_t c, tensor_t a, tensor_t b) {
 
     // always support cpu calculation
     if (c->deviceType() == LLAISYS_DEVICE_CPU) {
-        return cpu::add(c->data(), a->data(), b->data(), c->dtype(), c->numel());
+        return launch(cpu::add, c->data(), a->data(), b->data(), c->dtype(), c->numel());
     }
 
     llaisys::core::context().setDevice(c->deviceType(), c->deviceId());
 
     switch (c->deviceType()) {
     case LLAISYS_DEVICE_CPU:
-        return cpu::add(c->data(), a->data(), b->data(), c->dtype(), c->numel());
+        return launch(cpu::add, c->data(), a->data(), b->data(), c->dtype(), c->numel());
 #ifdef ENABLE_NVIDIA_API
     case LLAISYS_DEVICE_NVIDIA:
         TO_BE_IMPLEMENTED();
@@ -2,11 +2,14 @@
 
 #include "../../core/llaisys_core.hpp"
 #include "../../utils.hpp"
+#include "../capture/capture.hpp"
+#include "../trace/trace.hpp"
 
 #include "cpu/argmax_cpu.hpp"
 
 namespace llaisys::ops {
 void argmax(tensor_t max_idx, tensor_t max_val, tensor_t vals) {
+    TraceScope trace(LLAISYS_OP_ARGMAX, max_idx, max_val, vals);
     CHECK_SAME_DEVICE(max_idx, max_val, vals);
     // Check that max_idx and max_val are single element tensors
     ASSERT(max_idx->numel() == 1, "Argmax: max_idx must be a single element tensor");
@@ -20,14 +23,14 @@ void argmax(tensor_t max_idx, tensor_t max_val, tensor_t vals) {
 
     // always support cpu calculation
     if (vals->deviceType() == LLAISYS_DEVICE_CPU) {
-        return cpu::argmax(max_idx->data(), max_val->data(), vals->data(), vals->dtype(), vals->numel());
+        return launch(cpu::argmax, max_idx->data(), max_val->data(), vals->data(), vals->dtype(), vals->numel());
     }
 
     llaisys::core::context().setDevice(vals->deviceType(), vals->deviceId());
 
     switch (vals->deviceType()) {
     case LLAISYS_DEVICE_CPU:
-        return cpu::argmax(max_idx->data(), max_val->data(), vals->data(), vals->dtype(), vals->numel());
+        return launch(cpu::argmax, max_idx->data(), max_val->data(), vals->data(), vals->dtype(), vals->numel());
 #ifdef ENABLE_NVIDIA_API
     case LLAISYS_DEVICE_NVIDIA:
         TO_BE_IMPLEMENTED();
@@ -0,0 +1,81 @@
+#include "capture.hpp"
+
+#include <algorithm>
+
+namespace llaisys::ops {
+namespace {
+thread_local OpGraph *current_graph = nullptr;
+} // namespace
+
+OpGraph::OpGraph() : _cost(1.0) {}
+
+void OpGraph::add(std::function<void()> step) {
+    _frontier = {_dag.add(std::move(step), _frontier, _cost)};
+}
+
+void OpGraph::replay() const {
+    _dag.run();
+}
+
+size_t OpGraph::size() const {
+    return _dag.size();
+}
+
+bool OpGraph::empty() const {
+    return _dag.empty();
+}
+
+void OpGraph::clear() {
+    _dag.clear();
+    _frontier.clear();
+}
+
+CaptureScope::CaptureScope(OpGraph *graph) : _previous(current_graph) {
+    current_graph = graph;
+}
+
+CaptureScope::~CaptureScope() {
+    current_graph = _previous;
+}
+
+OpGraph *capturing() {
+    return current_graph;
+}
+
+void runStep(const std::function<void()> &step) {
+    OpGraph *graph = current_graph;
+    if (graph == nullptr) {
+        return step();
+    }
+    graph->add(step);
+    CaptureScope pause(nullptr);
+    step();
+}
+
+void concurrently(const std::vector<std::function<void()>> &branches, const std::vector<double> &costs) {
+    OpGraph *graph = current_graph;
+    if (graph == nullptr) {
+        std::vector<const std::function<void()> *> works;
+        for (const auto &branch : branches) {
+            works.push_back(&branch);
+        }
+        return runConcurrently(works, costs);
+    }
+    // Every branch starts from the launches before the call; the launches after it
+    // wait for the last launch of every branch.
+    const std::vector<OpDag::node_t> fork = graph->_frontier;
+    std::vector<OpDag::node_t> join;
+    for (size_t i = 0; i < branches.size(); i++) {
+        graph->_frontier = fork;
+        graph->_cost = costs.empty() ? 1.0 : costs[i];
+        branches[i]();
+        for (OpDag::node_t node : graph->_frontier) {
+            if (std::find(join.begin(), join.end(), node) == join.end()) {
+                join.push_back(node);
+            }
+        }
+    }
+    graph->_frontier = join;
+    graph->_cost = 1.0;
+}
+} // namespace llaisys::ops
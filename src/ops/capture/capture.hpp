@@ -0,0 +1,81 @@
+#pragma once
+
+#include "../dag/dag.hpp"
+#include "../trace/trace.hpp"
+
+#include <functional>
+#include <vector>
+
+namespace llaisys::ops {
+// A recorded sequence of kernel launches.
+//
+// While a graph captures on the calling thread (see CaptureScope), every op still
+// validates its arguments and runs, and in addition appends its kernel together with
+// the resolved arguments (data pointers, shapes, dtype) to the graph. replay() then
+// repeats the launches without any validation or dispatch. A graph only stays valid
+// while every buffer it refers to is alive and unmoved; inputs that change between
+// replays must be written into the same buffers. Work that cannot be recorded this
+// way (e.g. it depends on a length that grows every step) is added with runStep().
+//
+// Launches depend on the one before them, except for the branches of concurrently(),
+// which are recorded as independent and replayed at the same time.
+class OpGraph {
+private:
+    OpDag _dag;
+    std::vector<OpDag::node_t> _frontier; // nodes the next launch depends on
+    double _cost;                         // of the launches of the current branch
+
+    friend void concurrently(const std::vector<std::function<void()>> &, const std::vector<double> &);
+
+public:
+    OpGraph();
+
+    void add(std::function<void()> step);
+    void replay() const;
+
+    size_t size() const;
+    bool empty() const;
+    void clear();
+};
+
+// Capture the ops run by the calling thread into `graph` for the lifetime of the
+// scope. A scope over a null graph pauses an enclosing capture.
+class CaptureScope {
+private:
+    OpGraph *_previous;
+
+public:
+    explicit CaptureScope(OpGraph *graph);
+    ~CaptureScope();
+
+    CaptureScope(const CaptureScope &) = delete;
+    CaptureScope &operator=(const CaptureScope &) = delete;
+};
+
+// The graph capturing on the calling thread, or null.
+OpGraph *capturing();
+
+// Run `step` and, while capturing, add it to the graph as a whole instead of the ops it
+// runs, so that a replay runs it again with fresh arguments.
+void runStep(const std::function<void()> &step);
+
+// Run `branches`, which must neither read nor write what the others write, at the same
+// time on shares of the CPU threads proportional to `costs` (see runConcurrently). While
+// capturing they run one after the other and their launches are recorded as independent
+// branches of the graph.
+void concurrently(const std::vector<std::function<void()>> &branches, const std::vector<double> &costs = {});
+
+// Run `kernel` on `args` and record the launch if the calling thread captures. The
+// recorded launch is traced as the op that launched it.
+template <typename... Params, typename... Args>
+void launch(void (*kernel)(Params...), Args... args) {
+    if (OpGraph *graph = capturing()) {
+        const TraceInfo *op = currentOp();
+        graph->add([kernel, args..., op = op ? *op : TraceInfo{}] {
+            TraceScope trace(op);
+            kernel(args...);
+        });
+    }
+    kernel(args...);
+}
+} // namespace llaisys::ops
@@ -0,0 +1,143 @@
+#include "dag.hpp"
+
+#include "../../utils.hpp"
+
+#include <algorithm>
+#include <exception>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+namespace llaisys::ops {
+OpDag::node_t OpDag::add(std::function<void()> work, const std::vector<node_t> &deps, double cost) {
+    size_t level = 0;
+    for (node_t dep : deps) {
+        CHECK_ARGUMENT(dep < _nodes.size(), "OpDag: dependency on a node not in the DAG");
+        level = std::max(level, _level[dep] + 1);
+    }
+    const node_t node = _nodes.size();
+    _nodes.push_back(Node{std::move(work), cost});
+    _level.push_back(level);
+    if (level == _levels.size()) {
+        _levels.emplace_back();
+    }
+    _levels[level].push_back(node);
+    return node;
+}
+
+void OpDag::run() const {
+    std::vector<const std::function<void()> *> works;
+    std::vector<double> costs;
+    for (const auto &level : _levels) {
+        if (level.size() == 1) {
+            _nodes[level[0]].work();
+            continue;
+        }
+        works.clear();
+        costs.clear();
+        for (node_t node : level) {
+            works.push_back(&_nodes[node].work);
+            costs.push_back(_nodes[node].cost);
+        }
+        runConcurrently(works, costs);
+    }
+}
+
+size_t OpDag::size() const {
+    return _nodes.size();
+}
+
+bool OpDag::empty() const {
+    return _nodes.empty();
+}
+
+size_t OpDag::width() const {
+    size_t width = 0;
+    for (const auto &level : _levels) {
+        width = std::max(width, level.size());
+    }
+    return width;
+}
+
+void OpDag::clear() {
+    _nodes.clear();
+    _level.clear();
+    _levels.clear();
+}
+
+void runConcurrently(const std::vector<const std::function<void()> *> &works, const std::vector<double> &costs) {
+    const size_t n = works.size();
+#ifdef _OPENMP
+    const int threads = omp_in_parallel() ? 1 : omp_get_max_threads();
+#else
+    const int threads = 1;
+#endif
+    if (n < 2 || threads < 2) {
+        for (const auto *work : works) {
+            (*work)();
+        }
+        return;
+    }
+#ifdef _OPENMP
+    // One outer thread per work (round-robin if there are more works than threads);
+    // the remaining threads are dealt out in proportion to cost for the nested teams
+    // of the kernels.
+    const size_t teams = std::min(n, static_cast<size_t>(threads));
+    std::vector<double> team_cost(teams, 0.0);
+    double total = 0.0;
+    for (size_t i = 0; i < n; i++) {
+        const double cost = costs.empty() ? 1.0 : std::max(costs[i], 0.0);
+        team_cost[i % teams] += cost;
+        total += cost;
+    }
+    std::vector<int> share(teams, 1);
+    int left = threads - static_cast<int>(teams);
+    for (size_t t = 0; t < teams && total > 0.0; t++) {
+        const int extra = static_cast<int>(team_cost[t] / total * (threads - static_cast<int>(teams)));
+        share[t] += extra;
+        left -= extra;
+    }
+    for (size_t t = 0; left > 0; t = (t + 1) % teams, left--) {
+        share[t]++;
+    }
+
+    // The kernels' teams nest inside the outer one. The nesting limit belongs to the
+    // calling thread (libgomp keeps it per thread), so every thread running branches
+    // needs it raised; it is left raised, as nothing here runs deeper.
+    if (omp_get_max_active_levels() < 2) {
+        omp_set_max_active_levels(2);
+    }
+    std::exception_ptr error;
+#pragma omp parallel num_threads(static_cast<int>(teams))
+    {
+        // The runtime may hand out fewer threads than asked for.
+        const size_t t = static_cast<size_t>(omp_get_thread_num());
+        const size_t stride = static_cast<size_t>(omp_get_num_threads());
+        omp_set_num_threads(stride == teams ? share[t] : 1);
+        for (size_t i = t; i < n; i += stride) {
+            try {
+                (*works[i])();
+            } catch (...) {
+#pragma omp critical
+                if (!error) {
+                    error = std::current_exception();
+                }
+            }
+        }
+    }
+    if (error) {
+        std::rethrow_exception(error);
+    }
+#endif
+}
+
+int availableThreads() {
+#ifdef _OPENMP
+    // A parallel region nested beyond the limit runs on its encountering thread alone.
+    return omp_get_active_level() >= omp_get_max_active_levels() ? 1 : omp_get_max_threads();
+#else
+    return 1;
+#endif
+}
+} // namespace llaisys::ops
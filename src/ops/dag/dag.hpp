@@ -0,0 +1,47 @@
+#pragma once
+
+#include <functional>
+#include <vector>
+
+namespace llaisys::ops {
+// Ops (or any host work) with dependencies between them, run in dependency order.
+//
+// Nodes are grouped into levels: a node's level is one more than the highest level
+// of its dependencies, so the nodes of a level never depend on each other. run()
+// runs the levels in order; the nodes of a level run at the same time, splitting
+// the CPU threads between them in proportion to their cost, and the kernels they
+// launch parallelize over their share. A DAG is built once and may be run any
+// number of times.
+class OpDag {
+public:
+    using node_t = size_t;
+
+private:
+    struct Node {
+        std::function<void()> work;
+        double cost;
+    };
+    std::vector<Node> _nodes;
+    std::vector<size_t> _level;              // per node
+    std::vector<std::vector<node_t>> _levels; // nodes of each level
+
+public:
+    // Add a node running `work` after every node of `deps`, which must already be in the DAG.
+    node_t add(std::function<void()> work, const std::vector<node_t> &deps = {}, double cost = 1.0);
+    void run() const;
+
+    size_t size() const;
+    bool empty() const;
+    // Nodes of the widest level.
+    size_t width() const;
+    void clear();
+};
+
+// Run `works` at the same time, giving each a share of the CPU threads proportional
+// to its cost (all equal if `costs` is empty). Rethrows the first failure once all
+// have finished.
+void runConcurrently(const std::vector<const std::function<void()> *> &works, const std::vector<double> &costs);
+
+// Threads a parallel kernel launched by the calling thread would run on (1 without OpenMP).
+int availableThreads();
+} // namespace llaisys::ops
@@ -2,11 +2,14 @@
 
 #include "../../core/llaisys_core.hpp"
 #include "../../utils.hpp"
+#include "../capture/capture.hpp"
+#include "../trace/trace.hpp"
 
 #include "cpu/embedding_cpu.hpp"
 
 namespace llaisys::ops {
 void embedding(tensor_t out, tensor_t index, tensor_t weight) {
+    TraceScope trace(LLAISYS_OP_EMBEDDING, out, index, weight);
     CHECK_SAME_DEVICE(out, index, weight);
     // Check dimensions
     ASSERT(index->ndim() == 1, "Embedding: index must be 1-D tensor");
@@ -26,14 +29,14 @@ void embedding(tensor_t out, tensor_t index, tensor_t weight) {
 
     // always support cpu calculation
     if (out->deviceType() == LLAISYS_DEVICE_CPU) {
-        return cpu::embedding(out->data(), index->data(), weight->data(), out->dtype(), seq_len, embed_dim);
+        return launch(cpu::embedding, out->data(), index->data(), weight->data(), out->dtype(), seq_len, embed_dim);
     }
 
     llaisys::core::context().setDevice(out->deviceType(), out->deviceId());
 
     switch (out->deviceType()) {
     case LLAISYS_DEVICE_CPU:
-        return cpu::embedding(out->data(), index->data(), weight->data(), out->dtype(), seq_len, embed_dim);
+        return launch(cpu::embedding, out->data(), index->data(), weight->data(), out->dtype(), seq_len, embed_dim);
 #ifdef ENABLE_NVIDIA_API
     case LLAISYS_DEVICE_NVIDIA:
         TO_BE_IMPLEMENTED();
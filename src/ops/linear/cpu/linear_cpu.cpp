@@ -10,9 +10,15 @@ void linear_(T *out, const T *in, const T *weight, const T *bias, size_t batch,
     // X: [batch, in_features]
     // W: [out_features, in_features]
     // Y: [batch, out_features]
+    //
+    // Output features are split across threads and every batch row is computed
+    // against a weight row while it is still in cache, so the weights are streamed
+    // from memory once per call regardless of the batch size.
 
-    for (size_t b = 0; b < batch; b++) {
-        for (size_t o = 0; o < out_features; o++) {
+#pragma omp parallel for schedule(static)
+    for (ptrdiff_t o_ = 0; o_ < static_cast<ptrdiff_t>(out_features); o_++) {
+        const size_t o = static_cast<size_t>(o_);
+        for (size_t b = 0; b < batch; b++) {
             float sum = 0.0f;
 
             // Compute dot product of X[b] with W[o] (row o of weight matrix)
@@ -2,11 +2,14 @@
 
 #include "../../core/llaisys_core.hpp"
 #include "../../utils.hpp"
+#include "../capture/capture.hpp"
+#include "../trace/trace.hpp"
 
 #include "cpu/linear_cpu.hpp"
 
 namespace llaisys::ops {
 void linear(tensor_t out, tensor_t in, tensor_t weight, tensor_t bias) {
+    TraceScope trace(LLAISYS_OP_LINEAR, out, in, weight, bias);
     // Check dimensions
     ASSERT(in->ndim() == 2, "Linear: input must be 2-D tensor");
     ASSERT(weight->ndim() == 2, "Linear: weight must be 2-D tensor");
@@ -42,16 +45,16 @@ void linear(tensor_t out, tensor_t in, tensor_t weight, tensor_t bias) {
 
     // always support cpu calculation
     if (out->deviceType() == LLAISYS_DEVICE_CPU) {
-        return cpu::linear(out->data(), in->data(), weight->data(), bias_data,
-                          out->dtype(), batch, in_features, out_features, has_bias);
+        return launch(cpu::linear, out->data(), in->data(), weight->data(), bias_data,
+                      out->dtype(), batch, in_features, out_features, has_bias);
     }
 
     llaisys::core::context().setDevice(out->deviceType(), out->deviceId());
 
     switch (out->deviceType()) {
     case LLAISYS_DEVICE_CPU:
-        return cpu::linear(out->data(), in->data(), weight->data(), bias_data,
-                          out->dtype(), batch, in_features, out_features, has_bias);
+        return launch(cpu::linear, out->data(), in->data(), weight->data(), bias_data,
+                      out->dtype(), batch, in_features, out_features, has_bias);
 #ifdef ENABLE_NVIDIA_API
     case LLAISYS_DEVICE_NVIDIA:
         TO_BE_IMPLEMENTED();
@@ -0,0 +1,79 @@
+#include "linear_argmax_cpu.hpp"
+
+#include "../../../utils.hpp"
+
+#include <cmath>
+#include <limits>
+
+template <typename T>
+void linear_argmax_(int64_t *max_idx, T *max_val, const T *in, const T *weight, const T *bias,
+                    size_t batch, size_t in_features, size_t out_features, bool has_bias) {
+    // For each row b: idx = argmax_o (X[b] @ W[o]^T + bias[o])
+    // Every thread scans a contiguous slice of W and keeps only its local best,
+    // so the [batch, out_features] logits are never materialized.
+    for (size_t b = 0; b < batch; b++) {
+        const T *x = in + b * in_features;
+        float best_val = -std::numeric_limits<float>::infinity();
+        int64_t best_idx = 0;
+
+#pragma omp parallel
+        {
+            float local_val = -std::numeric_limits<float>::infinity();
+            int64_t local_idx = 0;
+
+#pragma omp for schedule(static) nowait
+            for (ptrdiff_t o = 0; o < static_cast<ptrdiff_t>(out_features); o++) {
+                const T *w = weight + o * in_features;
+                float sum = 0.0f;
+                for (size_t i = 0; i < in_features; i++) {
+                    sum += llaisys::utils::cast<float>(x[i]) * llaisys::utils::cast<float>(w[i]);
+                }
+                if (has_bias) {
+                    sum += llaisys::utils::cast<float>(bias[o]);
+                }
+                // Round to the storage type first so that ties are resolved exactly as
+                // `argmax` over the materialized logits would resolve them.
+                float val = llaisys::utils::cast<float>(llaisys::utils::cast<T>(sum));
+                if (val > local_val) {
+                    local_val = val;
+                    local_idx = static_cast<int64_t>(o);
+                }
+            }
+
+#pragma omp critical
+            {
+                if (local_val > best_val || (local_val == best_val && local_idx < best_idx)) {
+                    best_val = local_val;
+                    best_idx = local_idx;
+                }
+            }
+        }
+
+        max_idx[b] = best_idx;
+        max_val[b] = llaisys::utils::cast<T>(best_val);
+    }
+}
+
+namespace llaisys::ops::cpu {
+void linear_argmax(std::byte *max_idx, std::byte *max_val, const std::byte *in, const std::byte *weight, const std::byte *bias,
+                   llaisysDataType_t type, size_t batch, size_t in_features, size_t out_features, bool has_bias) {
+    int64_t *max_idx_ptr = reinterpret_cast<int64_t *>(max_idx);
+
+    switch (type) {
+    case LLAISYS_DTYPE_F32:
+        return linear_argmax_(max_idx_ptr, reinterpret_cast<float *>(max_val), reinterpret_cast<const float *>(in),
+                              reinterpret_cast<const float *>(weight), reinterpret_cast<const float *>(bias),
+                              batch, in_features, out_features, has_bias);
+    case LLAISYS_DTYPE_BF16:
+        return linear_argmax_(max_idx_ptr, reinterpret_cast<llaisys::bf16_t *>(max_val), reinterpret_cast<const llaisys::bf16_t *>(in),
+                              reinterpret_cast<const llaisys::bf16_t *>(weight), reinterpret_cast<const llaisys::bf16_t *>(bias),
+                              batch, in_features, out_features, has_bias);
+    case LLAISYS_DTYPE_F16:
+        return linear_argmax_(max_idx_ptr, reinterpret_cast<llaisys::fp16_t *>(max_val), reinterpret_cast<const llaisys::fp16_t *>(in),
+                              reinterpret_cast<const llaisys::fp16_t *>(weight), reinterpret_cast<const llaisys::fp16_t *>(bias),
+                              batch, in_features, out_features, has_bias);
+    default:
+        EXCEPTION_UNSUPPORTED_DATATYPE(type);
+    }
+}
+} // namespace llaisys::ops::cpu
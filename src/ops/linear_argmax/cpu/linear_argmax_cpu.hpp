@@ -0,0 +1,10 @@
+#pragma once
+
+#include "llaisys.h"
+
+#include <cstddef>
+
+namespace llaisys::ops::cpu {
+void linear_argmax(std::byte *max_idx, std::byte *max_val, const std::byte *in, const std::byte *weight, const std::byte *bias,
+                   llaisysDataType_t type, size_t batch, size_t in_features, size_t out_features, bool has_bias);
+}
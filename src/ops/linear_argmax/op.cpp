@@ -0,0 +1,71 @@
+#include "op.hpp"
+
+#include "../../core/llaisys_core.hpp"
+#include "../../utils.hpp"
+#include "../capture/capture.hpp"
+#include "../trace/trace.hpp"
+
+#include "cpu/linear_argmax_cpu.hpp"
+
+namespace llaisys::ops {
+void linear_argmax(tensor_t max_idx, tensor_t max_val, tensor_t in, tensor_t weight, tensor_t bias) {
+    TraceScope trace(LLAISYS_OP_LINEAR_ARGMAX, max_idx, max_val, in, weight, bias);
+    // Check dimensions
+    ASSERT(in->ndim() == 2, "LinearArgmax: input must be 2-D tensor");
+    ASSERT(weight->ndim() == 2, "LinearArgmax: weight must be 2-D tensor");
+    ASSERT(max_idx->ndim() == 1, "LinearArgmax: max_idx must be 1-D tensor");
+    ASSERT(max_val->ndim() == 1, "LinearArgmax: max_val must be 1-D tensor");
+
+    size_t batch = in->shape()[0];
+    size_t in_features = in->shape()[1];
+    size_t out_features = weight->shape()[0];
+
+    // Check shapes
+    ASSERT(weight->shape()[1] == in_features, "LinearArgmax: weight shape[1] must equal input shape[1]");
+    ASSERT(max_idx->shape()[0] == batch && max_val->shape()[0] == batch,
+           "LinearArgmax: max_idx and max_val must have shape [batch]");
+
+    // Check data types
+    ASSERT(max_idx->dtype() == LLAISYS_DTYPE_I64, "LinearArgmax: max_idx must be Int64");
+
+    // Check bias if provided
+    bool has_bias = (bias != nullptr);
+    if (has_bias) {
+        CHECK_SAME_DEVICE(max_idx, max_val, in, weight, bias);
+        ASSERT(bias->ndim() == 1, "LinearArgmax: bias must be 1-D tensor");
+        ASSERT(bias->shape()[0] == out_features, "LinearArgmax: bias shape must match out_features");
+        CHECK_SAME_DTYPE(max_val->dtype(), in->dtype(), weight->dtype(), bias->dtype());
+        ASSERT(bias->isContiguous(), "LinearArgmax: bias must be contiguous");
+    } else {
+        CHECK_SAME_DEVICE(max_idx, max_val, in, weight);
+        CHECK_SAME_DTYPE(max_val->dtype(), in->dtype(), weight->dtype());
+    }
+
+    // Check contiguous
+    ASSERT(max_idx->isContiguous() && max_val->isContiguous() && in->isContiguous() && weight->isContiguous(),
+           "LinearArgmax: max_idx, max_val, in, weight must be contiguous");
+
+    const std::byte *bias_data = has_bias ? bias->data() : nullptr;
+
+    // always support cpu calculation
+    if (in->deviceType() == LLAISYS_DEVICE_CPU) {
+        return launch(cpu::linear_argmax, max_idx->data(), max_val->data(), in->data(), weight->data(), bias_data,
+                      in->dtype(), batch, in_features, out_features, has_bias);
+    }
+
+    llaisys::core::context().setDevice(in->deviceType(), in->deviceId());
+
+    switch (in->deviceType()) {
+    case LLAISYS_DEVICE_CPU:
+        return launch(cpu::linear_argmax, max_idx->data(), max_val->data(), in->data(), weight->data(), bias_data,
+                      in->dtype(), batch, in_features, out_features, has_bias);
+#ifdef ENABLE_NVIDIA_API
+    case LLAISYS_DEVICE_NVIDIA:
+        TO_BE_IMPLEMENTED();
+        return;
+#endif
+    default:
+        EXCEPTION_UNSUPPORTED_DEVICE;
+    }
+}
+} // namespace llaisys::ops
@@ -0,0 +1,9 @@
+#pragma once
+
+#include "../../tensor/tensor.hpp"
+
+namespace llaisys::ops {
+// Fused `argmax(linear(in, weight, bias))` along the last dimension. The full
+// [batch, out_features] logits are never written out.
+void linear_argmax(tensor_t max_idx, tensor_t max_val, tensor_t in, tensor_t weight, tensor_t bias);
+}
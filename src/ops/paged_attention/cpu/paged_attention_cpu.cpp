@@ -0,0 +1,106 @@
+#include "paged_attention_cpu.hpp"
+
+#include "../../../utils.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <vector>
+
+template <typename T>
+void paged_attention_(T *attn_val, const T *q, const T *k_blocks, const T *v_blocks, const int64_t *block_table,
+                      size_t seqlen, size_t total_len, size_t block_size, size_t nhead, size_t nkvhead,
+                      size_t d, size_t dv, float scale) {
+    // Same as self_attention, except that key / value position t lives in block
+    // block_table[t / block_size] at row t % block_size:
+    // q: [seqlen, nhead, d]
+    // k_blocks: [nblocks, block_size, nkvhead, d]
+    // v_blocks: [nblocks, block_size, nkvhead, dv]
+    // attn_val: [seqlen, nhead, dv]
+
+    // Handle grouped query attention (GQA)
+    size_t n_groups = nhead / nkvhead;
+
+    // Row offset (in tokens) of every position inside the block pools
+    std::vector<size_t> rows(total_len);
+    for (size_t t = 0; t < total_len; t++) {
+        rows[t] = static_cast<size_t>(block_table[t / block_size]) * block_size + t % block_size;
+    }
+
+#pragma omp parallel
+    {
+        std::vector<float> scores(total_len);
+        std::vector<float> output(dv);
+
+#pragma omp for schedule(static)
+        for (ptrdiff_t sh = 0; sh < static_cast<ptrdiff_t>(seqlen * nhead); sh++) {
+            size_t s = static_cast<size_t>(sh) / nhead;
+            size_t h = static_cast<size_t>(sh) % nhead;
+            size_t kv_h = h / n_groups;
+            const T *q_row = q + s * nhead * d + h * d;
+
+            // For position s, only attend to positions 0...(total_len - seqlen + s)
+            size_t causal_end = total_len - seqlen + s + 1;
+
+            float max_score = -std::numeric_limits<float>::infinity();
+            for (size_t t = 0; t < causal_end; t++) {
+                const T *k_row = k_blocks + (rows[t] * nkvhead + kv_h) * d;
+                float score = 0.0f;
+                for (size_t i = 0; i < d; i++) {
+                    score += llaisys::utils::cast<float>(q_row[i]) * llaisys::utils::cast<float>(k_row[i]);
+                }
+                scores[t] = score * scale;
+                max_score = std::max(max_score, scores[t]);
+            }
+
+            float exp_sum = 0.0f;
+            for (size_t t = 0; t < causal_end; t++) {
+                scores[t] = std::exp(scores[t] - max_score);
+                exp_sum += scores[t];
+            }
+
+            std::fill(output.begin(), output.end(), 0.0f);
+            for (size_t t = 0; t < causal_end; t++) {
+                const T *v_row = v_blocks + (rows[t] * nkvhead + kv_h) * dv;
+                float p = scores[t] / exp_sum;
+                for (size_t i = 0; i < dv; i++) {
+                    output[i] += p * llaisys::utils::cast<float>(v_row[i]);
+                }
+            }
+
+            T *out_row = attn_val + s * nhead * dv + h * dv;
+            for (size_t i = 0; i < dv; i++) {
+                out_row[i] = llaisys::utils::cast<T>(output[i]);
+            }
+        }
+    }
+}
+
+namespace llaisys::ops::cpu {
+void paged_attention(std::byte *attn_val, const std::byte *q, const std::byte *k_blocks, const std::byte *v_blocks,
+                     const std::byte *block_table, llaisysDataType_t type, size_t seqlen, size_t total_len,
+                     size_t nblocks, size_t block_size, size_t nhead, size_t nkvhead, size_t d, size_t dv, float scale) {
+    const int64_t *table = reinterpret_cast<const int64_t *>(block_table);
+    for (size_t b = 0; b * block_size < total_len; b++) {
+        CHECK_ARGUMENT(table[b] >= 0 && static_cast<size_t>(table[b]) < nblocks,
+                       "Paged Attention: block index out of range");
+    }
+
+    switch (type) {
+    case LLAISYS_DTYPE_F32:
+        return paged_attention_(reinterpret_cast<float *>(attn_val), reinterpret_cast<const float *>(q),
+                                reinterpret_cast<const float *>(k_blocks), reinterpret_cast<const float *>(v_blocks),
+                                table, seqlen, total_len, block_size, nhead, nkvhead, d, dv, scale);
+    case LLAISYS_DTYPE_BF16:
+        return paged_attention_(reinterpret_cast<llaisys::bf16_t *>(attn_val), reinterpret_cast<const llaisys::bf16_t *>(q),
+                                reinterpret_cast<const llaisys::bf16_t *>(k_blocks), reinterpret_cast<const llaisys::bf16_t *>(v_blocks),
+                                table, seqlen, total_len, block_size, nhead, nkvhead, d, dv, scale);
+    case LLAISYS_DTYPE_F16:
+        return paged_attention_(reinterpret_cast<llaisys::fp16_t *>(attn_val), reinterpret_cast<const llaisys::fp16_t *>(q),
+                                reinterpret_cast<const llaisys::fp16_t *>(k_blocks), reinterpret_cast<const llaisys::fp16_t *>(v_blocks),
+                                table, seqlen, total_len, block_size, nhead, nkvhead, d, dv, scale);
+    default:
+        EXCEPTION_UNSUPPORTED_DATATYPE(type);
+    }
+}
+} // namespace llaisys::ops::cpu
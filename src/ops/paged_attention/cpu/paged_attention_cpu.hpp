@@ -0,0 +1,11 @@
+#pragma once
+
+#include "llaisys.h"
+
+#include <cstddef>
+
+namespace llaisys::ops::cpu {
+void paged_attention(std::byte *attn_val, const std::byte *q, const std::byte *k_blocks, const std::byte *v_blocks,
+                     const std::byte *block_table, llaisysDataType_t type, size_t seqlen, size_t total_len,
+                     size_t nblocks, size_t block_size, size_t nhead, size_t nkvhead, size_t d, size_t dv, float scale);
+}
@@ -0,0 +1,79 @@
+#include "op.hpp"
+
+#include "../../core/llaisys_core.hpp"
+#include "../../utils.hpp"
+#include "../capture/capture.hpp"
+#include "../trace/trace.hpp"
+
+#include "cpu/paged_attention_cpu.hpp"
+
+namespace llaisys::ops {
+void paged_attention(tensor_t attn_val, tensor_t q, tensor_t k_blocks, tensor_t v_blocks, tensor_t block_table,
+                     size_t total_len, float scale) {
+    TraceScope trace(LLAISYS_OP_PAGED_ATTENTION, attn_val, q, k_blocks, v_blocks, block_table);
+    CHECK_SAME_DEVICE(attn_val, q, k_blocks, v_blocks, block_table);
+    // Check dimensions
+    ASSERT(q->ndim() == 3, "Paged Attention: q must be 3-D tensor [seqlen, nhead, d]");
+    ASSERT(k_blocks->ndim() == 4, "Paged Attention: k_blocks must be 4-D tensor [nblocks, block_size, nkvhead, d]");
+    ASSERT(v_blocks->ndim() == 4, "Paged Attention: v_blocks must be 4-D tensor [nblocks, block_size, nkvhead, dv]");
+    ASSERT(attn_val->ndim() == 3, "Paged Attention: attn_val must be 3-D tensor [seqlen, nhead, dv]");
+    ASSERT(block_table->ndim() == 1, "Paged Attention: block_table must be 1-D tensor");
+
+    size_t seqlen = q->shape()[0];
+    size_t nhead = q->shape()[1];
+    size_t d = q->shape()[2];
+
+    size_t nblocks = k_blocks->shape()[0];
+    size_t block_size = k_blocks->shape()[1];
+    size_t nkvhead = k_blocks->shape()[2];
+    ASSERT(k_blocks->shape()[3] == d, "Paged Attention: k dimension must match q dimension");
+
+    ASSERT(v_blocks->shape()[0] == nblocks && v_blocks->shape()[1] == block_size && v_blocks->shape()[2] == nkvhead,
+           "Paged Attention: v_blocks must have the same block layout as k_blocks");
+    size_t dv = v_blocks->shape()[3];
+
+    // Check output shape
+    ASSERT(attn_val->shape()[0] == seqlen && attn_val->shape()[1] == nhead && attn_val->shape()[2] == dv,
+           "Paged Attention: attn_val shape must be [seqlen, nhead, dv]");
+
+    // Check lengths
+    size_t ntable = block_table->shape()[0];
+    ASSERT(total_len >= seqlen, "Paged Attention: total_len must cover the query tokens");
+    ASSERT(ntable * block_size >= total_len, "Paged Attention: block_table does not cover total_len");
+
+    // Check grouped query attention constraint
+    ASSERT(nhead % nkvhead == 0, "Paged Attention: nhead must be divisible by nkvhead for GQA");
+
+    // Check data types
+    ASSERT(block_table->dtype() == LLAISYS_DTYPE_I64, "Paged Attention: block_table must be Int64");
+    CHECK_SAME_DTYPE(attn_val->dtype(), q->dtype(), k_blocks->dtype(), v_blocks->dtype());
+
+    // Check contiguous
+    ASSERT(attn_val->isContiguous() && q->isContiguous() && k_blocks->isContiguous() && v_blocks->isContiguous()
+               && block_table->isContiguous(),
+           "Paged Attention: all tensors must be contiguous");
+
+    // always support cpu calculation
+    if (attn_val->deviceType() == LLAISYS_DEVICE_CPU) {
+        return launch(cpu::paged_attention, attn_val->data(), q->data(), k_blocks->data(), v_blocks->data(), block_table->data(),
+                      attn_val->dtype(), seqlen, total_len, nblocks, block_size, nhead, nkvhead, d, dv,
+                      scale);
+    }
+
+    llaisys::core::context().setDevice(attn_val->deviceType(), attn_val->deviceId());
+
+    switch (attn_val->deviceType()) {
+    case LLAISYS_DEVICE_CPU:
+        return launch(cpu::paged_attention, attn_val->data(), q->data(), k_blocks->data(), v_blocks->data(), block_table->data(),
+                      attn_val->dtype(), seqlen, total_len, nblocks, block_size, nhead, nkvhead, d, dv,
+                      scale);
+#ifdef ENABLE_NVIDIA_API
+    case LLAISYS_DEVICE_NVIDIA:
+        TO_BE_IMPLEMENTED();
+        return;
+#endif
+    default:
+        EXCEPTION_UNSUPPORTED_DEVICE;
+    }
+}
+} // namespace llaisys::ops
@@ -0,0 +1,8 @@
+#pragma once
+
+#include "../../tensor/tensor.hpp"
+
+namespace llaisys::ops {
+void paged_attention(tensor_t attn_val, tensor_t q, tensor_t k_blocks, tensor_t v_blocks, tensor_t block_table,
+                     size_t total_len, float scale);
+}
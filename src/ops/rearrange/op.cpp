@@ -1,7 +1,10 @@
 #include "op.hpp"
 
+#include "../trace/trace.hpp"
+
 namespace llaisys::ops {
 void rearrange(tensor_t out, tensor_t in) {
+    TraceScope trace(LLAISYS_OP_REARRANGE, out, in);
     TO_BE_IMPLEMENTED();
 }
 } // namespace llaisys::ops
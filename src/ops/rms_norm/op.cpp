@@ -2,11 +2,14 @@
 
 #include "../../core/llaisys_core.hpp"
 #include "../../utils.hpp"
+#include "../capture/capture.hpp"
+#include "../trace/trace.hpp"
 
 #include "cpu/rms_norm_cpu.hpp"
 
 namespace llaisys::ops {
 void rms_norm(tensor_t out, tensor_t in, tensor_t weight, float eps) {
+    TraceScope trace(LLAISYS_OP_RMS_NORM, out, in, weight);
     CHECK_SAME_DEVICE(out, in, weight);
     // Check dimensions
     ASSERT(in->ndim() == 2, "RMS Norm: input must be 2-D tensor");
@@ -29,14 +32,14 @@ void rms_norm(tensor_t out, tensor_t in, tensor_t weight, float eps) {
 
     // always support cpu calculation
     if (out->deviceType() == LLAISYS_DEVICE_CPU) {
-        return cpu::rms_norm(out->data(), in->data(), weight->data(), out->dtype(), batch, dim, eps);
+        return launch(cpu::rms_norm, out->data(), in->data(), weight->data(), out->dtype(), batch, dim, eps);
     }
 
     llaisys::core::context().setDevice(out->deviceType(), out->deviceId());
 
     switch (out->deviceType()) {
     case LLAISYS_DEVICE_CPU:
-        return cpu::rms_norm(out->data(), in->data(), weight->data(), out->dtype(), batch, dim, eps);
+        return launch(cpu::rms_norm, out->data(), in->data(), weight->data(), out->dtype(), batch, dim, eps);
 #ifdef ENABLE_NVIDIA_API
     case LLAISYS_DEVICE_NVIDIA:
         TO_BE_IMPLEMENTED();
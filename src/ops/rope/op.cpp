@@ -2,11 +2,14 @@
 
 #include "../../core/llaisys_core.hpp"
 #include "../../utils.hpp"
+#include "../capture/capture.hpp"
+#include "../trace/trace.hpp"
 
 #include "cpu/rope_cpu.hpp"
 
 namespace llaisys::ops {
 void rope(tensor_t out, tensor_t in, tensor_t pos_ids, float theta) {
+    TraceScope trace(LLAISYS_OP_ROPE, out, in, pos_ids);
     CHECK_SAME_DEVICE(out, in, pos_ids);
     // Check dimensions
     ASSERT(in->ndim() == 3, "RoPE: input must be 3-D tensor [seqlen, nhead, d]");
@@ -32,14 +35,14 @@ void rope(tensor_t out, tensor_t in, tensor_t pos_ids, float theta) {
 
     // always support cpu calculation
     if (out->deviceType() == LLAISYS_DEVICE_CPU) {
-        return cpu::rope(out->data(), in->data(), pos_ids->data(), out->dtype(), seqlen, nhead, d, theta);
+        return launch(cpu::rope, out->data(), in->data(), pos_ids->data(), out->dtype(), seqlen, nhead, d, theta);
     }
 
     llaisys::core::context().setDevice(out->deviceType(), out->deviceId());
 
     switch (out->deviceType()) {
     case LLAISYS_DEVICE_CPU:
-        return cpu::rope(out->data(), in->data(), pos_ids->data(), out->dtype(), seqlen, nhead, d, theta);
+        return launch(cpu::rope, out->data(), in->data(), pos_ids->data(), out->dtype(), seqlen, nhead, d, theta);
 #ifdef ENABLE_NVIDIA_API
     case LLAISYS_DEVICE_NVIDIA:
         TO_BE_IMPLEMENTED();
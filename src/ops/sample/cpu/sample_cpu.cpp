@@ -0,0 +1,90 @@
+#include "sample_cpu.hpp"
+
+#include "../../../utils.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+#include <vector>
+
+template <typename T>
+int64_t sample_(const T *logits, size_t numel, float temperature, int top_k, float top_p, float random_val) {
+    // Scratch buffers are kept per thread so repeated calls do not allocate.
+    thread_local std::vector<float> probs;
+    thread_local std::vector<int64_t> order;
+    probs.resize(numel);
+    order.resize(numel);
+
+    for (size_t i = 0; i < numel; i++) {
+        probs[i] = llaisys::utils::cast<float>(logits[i]);
+    }
+    std::iota(order.begin(), order.end(), int64_t(0));
+
+    bool greedy = top_k == 1 || temperature <= 0.0f;
+    if (greedy) {
+        return *std::max_element(order.begin(), order.end(), [&](int64_t a, int64_t b) { return probs[a] < probs[b]; });
+    }
+
+    // Top-k: move the k largest logits to the front, sorted in descending order.
+    size_t k = (top_k <= 0 || static_cast<size_t>(top_k) > numel) ? numel : static_cast<size_t>(top_k);
+    auto greater = [&](int64_t a, int64_t b) { return probs[a] > probs[b] || (probs[a] == probs[b] && a < b); };
+    std::partial_sort(order.begin(), order.begin() + k, order.end(), greater);
+
+    // Softmax over the candidates with temperature.
+    float max_logit = probs[order[0]];
+    float sum = 0.0f;
+    for (size_t i = 0; i < k; i++) {
+        float p = std::exp((probs[order[i]] - max_logit) / temperature);
+        probs[order[i]] = p;
+        sum += p;
+    }
+
+    // Top-p: keep the smallest prefix whose probability mass reaches top_p.
+    size_t n = k;
+    if (top_p < 1.0f) {
+        float cum = 0.0f;
+        for (size_t i = 0; i < k; i++) {
+            cum += probs[order[i]] / sum;
+            if (cum >= top_p) {
+                n = i + 1;
+                break;
+            }
+        }
+    }
+
+    // Inverse CDF over the kept candidates.
+    float kept = 0.0f;
+    for (size_t i = 0; i < n; i++) {
+        kept += probs[order[i]];
+    }
+    float target = random_val * kept;
+    float cum = 0.0f;
+    for (size_t i = 0; i < n; i++) {
+        cum += probs[order[i]];
+        if (target < cum) {
+            return order[i];
+        }
+    }
+    return order[n - 1];
+}
+
+namespace llaisys::ops::cpu {
+void sample(std::byte *out_idx, const std::byte *logits, llaisysDataType_t type, size_t numel,
+            float temperature, int top_k, float top_p, float random_val) {
+    int64_t *out_idx_ptr = reinterpret_cast<int64_t *>(out_idx);
+
+    switch (type) {
+    case LLAISYS_DTYPE_F32:
+        *out_idx_ptr = sample_(reinterpret_cast<const float *>(logits), numel, temperature, top_k, top_p, random_val);
+        return;
+    case LLAISYS_DTYPE_BF16:
+        *out_idx_ptr = sample_(reinterpret_cast<const llaisys::bf16_t *>(logits), numel, temperature, top_k, top_p, random_val);
+        return;
+    case LLAISYS_DTYPE_F16:
+        *out_idx_ptr = sample_(reinterpret_cast<const llaisys::fp16_t *>(logits), numel, temperature, top_k, top_p, random_val);
+        return;
+    default:
+        EXCEPTION_UNSUPPORTED_DATATYPE(type);
+    }
+}
+} // namespace llaisys::ops::cpu
@@ -0,0 +1,42 @@
+#include "op.hpp"
+
+#include "../../core/llaisys_core.hpp"
+#include "../../utils.hpp"
+#include "../capture/capture.hpp"
+#include "../trace/trace.hpp"
+
+#include "cpu/sample_cpu.hpp"
+
+namespace llaisys::ops {
+void sample(tensor_t out_idx, tensor_t logits, float temperature, int top_k, float top_p, float random_val) {
+    TraceScope trace(LLAISYS_OP_SAMPLE, out_idx, logits);
+    CHECK_SAME_DEVICE(out_idx, logits);
+    ASSERT(out_idx->numel() == 1, "Sample: out_idx must be a single element tensor");
+    ASSERT(out_idx->dtype() == LLAISYS_DTYPE_I64, "Sample: out_idx must be Int64");
+    ASSERT(logits->numel() > 0, "Sample: logits must not be empty");
+    ASSERT(out_idx->isContiguous() && logits->isContiguous(), "Sample: all tensors must be contiguous");
+    CHECK_ARGUMENT(top_p > 0.0f, "Sample: top_p must be positive");
+    CHECK_ARGUMENT(random_val >= 0.0f && random_val < 1.0f, "Sample: random_val must be in [0, 1)");
+
+    // always support cpu calculation
+    if (logits->deviceType() == LLAISYS_DEVICE_CPU) {
+        return launch(cpu::sample, out_idx->data(), logits->data(), logits->dtype(), logits->numel(),
+                      temperature, top_k, top_p, random_val);
+    }
+
+    llaisys::core::context().setDevice(logits->deviceType(), logits->deviceId());
+
+    switch (logits->deviceType()) {
+    case LLAISYS_DEVICE_CPU:
+        return launch(cpu::sample, out_idx->data(), logits->data(), logits->dtype(), logits->numel(),
+                      temperature, top_k, top_p, random_val);
+#ifdef ENABLE_NVIDIA_API
+    case LLAISYS_DEVICE_NVIDIA:
+        TO_BE_IMPLEMENTED();
+        return;
+#endif
+    default:
+        EXCEPTION_UNSUPPORTED_DEVICE;
+    }
+}
+} // namespace llaisys::ops
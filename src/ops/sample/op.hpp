@@ -0,0 +1,11 @@
+#pragma once
+
+#include "../../tensor/tensor.hpp"
+
+namespace llaisys::ops {
+// Draw a token id from `logits` after temperature scaling and top-k / top-p
+// filtering. `random_val` is a uniform sample in [0, 1) supplied by the caller so
+// the op itself is deterministic. `top_k <= 0` and `top_p >= 1` disable the
+// respective filter; `top_k == 1` or `temperature <= 0` degrade to argmax.
+void sample(tensor_t out_idx, tensor_t logits, float temperature, int top_k, float top_p, float random_val);
+}
@@ -0,0 +1,18 @@
+#include "select_rows_cpu.hpp"
+
+#include "../../../utils.hpp"
+
+#include <cstring>
+
+namespace llaisys::ops::cpu {
+void select_rows(std::byte *out, const std::byte *in, const std::byte *index,
+                 size_t nindex, size_t nrows, size_t row_bytes, size_t in_row_stride_bytes) {
+    // Rows are copied as raw bytes, so every data type is supported.
+    const int64_t *index_ptr = reinterpret_cast<const int64_t *>(index);
+    for (size_t i = 0; i < nindex; i++) {
+        int64_t row = index_ptr[i];
+        CHECK_ARGUMENT(row >= 0 && static_cast<size_t>(row) < nrows, "SelectRows: index out of range");
+        std::memcpy(out + i * row_bytes, in + row * in_row_stride_bytes, row_bytes);
+    }
+}
+} // namespace llaisys::ops::cpu
@@ -0,0 +1,10 @@
+#pragma once
+
+#include "llaisys.h"
+
+#include <cstddef>
+
+namespace llaisys::ops::cpu {
+void select_rows(std::byte *out, const std::byte *in, const std::byte *index,
+                 size_t nindex, size_t nrows, size_t row_bytes, size_t in_row_stride_bytes);
+}
@@ -0,0 +1,58 @@
+#include "op.hpp"
+
+#include "../../core/llaisys_core.hpp"
+#include "../../utils.hpp"
+#include "../capture/capture.hpp"
+#include "../trace/trace.hpp"
+
+#include "cpu/select_rows_cpu.hpp"
+
+namespace llaisys::ops {
+void select_rows(tensor_t out, tensor_t in, tensor_t index) {
+    TraceScope trace(LLAISYS_OP_SELECT_ROWS, out, in, index);
+    CHECK_SAME_DEVICE(out, in, index);
+    // Check dimensions
+    ASSERT(in->ndim() == 2, "SelectRows: input must be 2-D tensor");
+    ASSERT(out->ndim() == 2, "SelectRows: output must be 2-D tensor");
+    ASSERT(index->ndim() == 1, "SelectRows: index must be 1-D tensor");
+
+    size_t nindex = index->shape()[0];
+    size_t nrows = in->shape()[0];
+    size_t dim = in->shape()[1];
+
+    // Check shapes
+    ASSERT(out->shape()[0] == nindex && out->shape()[1] == dim,
+           "SelectRows: output shape must be [nindex, dim]");
+
+    // Check data types
+    ASSERT(index->dtype() == LLAISYS_DTYPE_I64, "SelectRows: index must be Int64");
+    CHECK_SAME_DTYPE(out->dtype(), in->dtype());
+
+    // Check layout: rows of `in` must be dense, rows may be strided
+    ASSERT(out->isContiguous() && index->isContiguous(), "SelectRows: out and index must be contiguous");
+    ASSERT(in->strides()[1] == 1 && in->strides()[0] >= static_cast<ptrdiff_t>(dim),
+           "SelectRows: input rows must be contiguous");
+
+    size_t row_bytes = dim * in->elementSize();
+    size_t in_row_stride_bytes = in->strides()[0] * in->elementSize();
+
+    // always support cpu calculation
+    if (out->deviceType() == LLAISYS_DEVICE_CPU) {
+        return launch(cpu::select_rows, out->data(), in->data(), index->data(), nindex, nrows, row_bytes, in_row_stride_bytes);
+    }
+
+    llaisys::core::context().setDevice(out->deviceType(), out->deviceId());
+
+    switch (out->deviceType()) {
+    case LLAISYS_DEVICE_CPU:
+        return launch(cpu::select_rows, out->data(), in->data(), index->data(), nindex, nrows, row_bytes, in_row_stride_bytes);
+#ifdef ENABLE_NVIDIA_API
+    case LLAISYS_DEVICE_NVIDIA:
+        TO_BE_IMPLEMENTED();
+        return;
+#endif
+    default:
+        EXCEPTION_UNSUPPORTED_DEVICE;
+    }
+}
+} // namespace llaisys::ops
@@ -0,0 +1,9 @@
+#pragma once
+
+#include "../../tensor/tensor.hpp"
+
+namespace llaisys::ops {
+// Gather rows: out[i, :] = in[index[i], :]. `in` may be a row-strided view as long
+// as each row is contiguous.
+void select_rows(tensor_t out, tensor_t in, tensor_t index);
+}
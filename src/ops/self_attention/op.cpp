@@ -2,11 +2,14 @@
 
 #include "../../core/llaisys_core.hpp"
 #include "../../utils.hpp"
+#include "../capture/capture.hpp"
+#include "../trace/trace.hpp"
 
 #include "cpu/self_attention_cpu.hpp"
 
 namespace llaisys::ops {
 void self_attention(tensor_t attn_val, tensor_t q, tensor_t k, tensor_t v, float scale) {
+    TraceScope trace(LLAISYS_OP_SELF_ATTENTION, attn_val, q, k, v);
     CHECK_SAME_DEVICE(attn_val, q, k, v);
     // Check dimensions
     ASSERT(q->ndim() == 3, "Self Attention: q must be 3-D tensor [seqlen, nhead, d]");
@@ -42,16 +45,16 @@ void self_attention(tensor_t attn_val, tensor_t q, tensor_t k, tensor_t v, float
 
     // always support cpu calculation
     if (attn_val->deviceType() == LLAISYS_DEVICE_CPU) {
-        return cpu::self_attention(attn_val->data(), q->data(), k->data(), v->data(),
-                                  attn_val->dtype(), seqlen, total_len, nhead, nkvhead, d, dv, scale);
+        return launch(cpu::self_attention, attn_val->data(), q->data(), k->data(), v->data(),
+                      attn_val->dtype(), seqlen, total_len, nhead, nkvhead, d, dv, scale);
     }
 
     llaisys::core::context().setDevice(attn_val->deviceType(), attn_val->deviceId());
 
     switch (attn_val->deviceType()) {
     case LLAISYS_DEVICE_CPU:
-        return cpu::self_attention(attn_val->data(), q->data(), k->data(), v->data(),
-                                  attn_val->dtype(), seqlen, total_len, nhead, nkvhead, d, dv, scale);
+        return launch(cpu::self_attention, attn_val->data(), q->data(), k->data(), v->data(),
+                      attn_val->dtype(), seqlen, total_len, nhead, nkvhead, d, dv, scale);
 #ifdef ENABLE_NVIDIA_API
     case LLAISYS_DEVICE_NVIDIA:
         TO_BE_IMPLEMENTED();
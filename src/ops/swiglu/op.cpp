@@ -2,11 +2,14 @@
 
 #include "../../core/llaisys_core.hpp"
 #include "../../utils.hpp"
+#include "../capture/capture.hpp"
+#include "../trace/trace.hpp"
 
 #include "cpu/swiglu_cpu.hpp"
 
 namespace llaisys::ops {
 void swiglu(tensor_t out, tensor_t gate, tensor_t up) {
+    TraceScope trace(LLAISYS_OP_SWIGLU, out, gate, up);
     CHECK_SAME_DEVICE(out, gate, up);
     // Check shapes match
     CHECK_SAME_SHAPE(out->shape(), gate->shape(), up->shape());
@@ -20,14 +23,14 @@ void swiglu(tensor_t out, tensor_t gate, tensor_t up) {
 
     // always support cpu calculation
     if (out->deviceType() == LLAISYS_DEVICE_CPU) {
-        return cpu::swiglu(out->data(), gate->data(), up->data(), out->dtype(), numel);
+        return launch(cpu::swiglu, out->data(), gate->data(), up->data(), out->dtype(), numel);
     }
 
     llaisys::core::context().setDevice(out->deviceType(), out->deviceId());
 
     switch (out->deviceType()) {
     case LLAISYS_DEVICE_CPU:
-        return cpu::swiglu(out->data(), gate->data(), up->data(), out->dtype(), numel);
+        return launch(cpu::swiglu, out->data(), gate->data(), up->data(), out->dtype(), numel);
 #ifdef ENABLE_NVIDIA_API
     case LLAISYS_DEVICE_NVIDIA:
         TO_BE_IMPLEMENTED();
@@ -0,0 +1,227 @@
+#include "trace.hpp"
+
+#include "../../core/metrics/metrics.hpp"
+#include "../../utils.hpp"
+#include "../capture/capture.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace llaisys::ops {
+namespace {
+struct TraceEvent {
+    TraceInfo info;
+    uint64_t start;    // ns of the metrics clock
+    uint64_t duration; // ns
+};
+
+constexpr size_t kChunkEvents = 1024;
+constexpr size_t kRingChunks = 32;
+constexpr size_t kRingEvents = kChunkEvents * kRingChunks;
+
+// Written by its own thread only; `head` publishes the events (and the chunks
+// holding them) to dumpTrace(). Chunks are allocated as the ring first fills
+// them, since OpenMP can run ops on many short-lived threads.
+struct Ring {
+    std::unique_ptr<TraceEvent[]> chunks[kRingChunks];
+    std::atomic<uint64_t> head; // events ever recorded
+    std::atomic<uint64_t> tail; // first event not cleared
+    size_t tid;
+
+    TraceEvent &at(uint64_t i) {
+        return chunks[i % kRingEvents / kChunkEvents][i % kChunkEvents];
+    }
+};
+
+std::atomic<bool> enabled{false};
+
+// Never destroyed: threads may record while the process exits.
+std::mutex &ringsMutex() {
+    static auto *mutex = new std::mutex();
+    return *mutex;
+}
+
+std::vector<std::shared_ptr<Ring>> &rings() {
+    static auto *rings = new std::vector<std::shared_ptr<Ring>>();
+    return *rings;
+}
+
+// Rings of exited threads, taken over by the next threads to record, so that
+// short-lived threads (OpenMP teams, request threads) do not add a ring each.
+std::vector<std::shared_ptr<Ring>> &freeRings() {
+    static auto *rings = new std::vector<std::shared_ptr<Ring>>();
+    return *rings;
+}
+
+// Hands the ring of its thread back when the thread exits.
+struct RingOwner {
+    std::shared_ptr<Ring> ring;
+
+    ~RingOwner() {
+        if (ring) {
+            std::lock_guard<std::mutex> lock(ringsMutex());
+            freeRings().push_back(std::move(ring));
+        }
+    }
+};
+
+thread_local RingOwner thread_ring;
+thread_local const TraceInfo *current_op = nullptr;
+
+Ring &threadRing() {
+    if (!thread_ring.ring) {
+        std::lock_guard<std::mutex> lock(ringsMutex());
+        if (!freeRings().empty()) {
+            // Keeps the events of the exited thread until they are overwritten.
+            thread_ring.ring = std::move(freeRings().back());
+            freeRings().pop_back();
+        } else {
+            auto ring = std::make_shared<Ring>();
+            ring->head = 0;
+            ring->tail = 0;
+            ring->tid = rings().size();
+            rings().push_back(ring);
+            thread_ring.ring = std::move(ring);
+        }
+    }
+    return *thread_ring.ring;
+}
+
+void record(const TraceInfo &info, uint64_t start, uint64_t end) {
+    Ring &ring = threadRing();
+    const uint64_t head = ring.head.load(std::memory_order_relaxed);
+    auto &chunk = ring.chunks[head % kRingEvents / kChunkEvents];
+    if (!chunk) {
+        chunk.reset(new TraceEvent[kChunkEvents]);
+    }
+    ring.at(head) = TraceEvent{info, start, end - start};
+    ring.head.store(head + 1, std::memory_order_release);
+}
+
+bool isIndex(llaisysDataType_t dtype) {
+    return dtype == LLAISYS_DTYPE_I32 || dtype == LLAISYS_DTYPE_I64;
+}
+} // namespace
+
+const char *opName(llaisysOpType_t op) {
+    static const char *const names[LLAISYS_OP_COUNT] = {
+        "add", "argmax", "embedding", "linear", "linear_argmax", "paged_attention", "rearrange",
+        "rms_norm", "rope", "sample", "select_rows", "self_attention", "swiglu",
+    };
+    return op < LLAISYS_OP_COUNT ? names[op] : "unknown";
+}
+
+void setTracing(bool on) {
+    enabled.store(on, std::memory_order_relaxed);
+}
+
+bool tracing() {
+    return enabled.load(std::memory_order_relaxed);
+}
+
+void clearTrace() {
+    std::lock_guard<std::mutex> lock(ringsMutex());
+    for (const auto &ring : rings()) {
+        ring->tail.store(ring->head.load(std::memory_order_acquire));
+    }
+}
+
+size_t dumpTrace(const std::string &path) {
+    std::ofstream file(path, std::ios::trunc);
+    CHECK_ARGUMENT(file.good(), "Trace: cannot create file");
+    file << "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[";
+    size_t count = 0;
+    char buffer[384];
+    std::lock_guard<std::mutex> lock(ringsMutex());
+    for (const auto &ring : rings()) {
+        const uint64_t head = ring->head.load(std::memory_order_acquire);
+        uint64_t first = ring->tail.load();
+        if (head - first > kRingEvents) {
+            first = head - kRingEvents;
+        }
+        for (uint64_t i = first; i < head; i++) {
+            const TraceEvent &event = ring->at(i);
+            const char *dtype = event.info.dtype == LLAISYS_DTYPE_INVALID ? "" : utils::dtype_to_str(event.info.dtype);
+            std::snprintf(buffer, sizeof(buffer),
+                          "%s\n{\"name\":\"%s\",\"cat\":\"op\",\"ph\":\"X\",\"pid\":0,\"tid\":%zu,"
+                          "\"ts\":%.3f,\"dur\":%.3f,\"args\":{\"dtype\":\"%s\",\"tensors\":\"%.*s\"}}",
+                          count == 0 ? "" : ",", opName(event.info.op), ring->tid, event.start / 1e3,
+                          event.duration / 1e3, dtype, static_cast<int>(sizeof(event.info.tensors)),
+                          event.info.tensors);
+            file << buffer;
+            count++;
+        }
+    }
+    file << "\n]}\n";
+    file.close();
+    ASSERT(file.good(), "Trace: write failed");
+    return count;
+}
+
+const TraceInfo *currentOp() {
+    return current_op;
+}
+
+uint64_t TraceScope::_now() {
+    return core::metricsClock();
+}
+
+bool TraceScope::_wanted() {
+    return tracing() || capturing() != nullptr;
+}
+
+void TraceScope::_describe(const tensor_t &tensor) {
+    if (!tensor) {
+        return;
+    }
+    // The dtype of an op is that of its first non-index tensor.
+    if (_info.dtype == LLAISYS_DTYPE_INVALID || (isIndex(_info.dtype) && !isIndex(tensor->dtype()))) {
+        _info.dtype = tensor->dtype();
+    }
+    // Appended as "dtype[d0,d1,...]", cut short if the buffer fills up.
+    const size_t size = sizeof(_info.tensors);
+    size_t len = std::strlen(_info.tensors);
+    auto advance = [&](int written) { len = std::min(len + static_cast<size_t>(std::max(written, 0)), size - 1); };
+    advance(std::snprintf(_info.tensors + len, size - len, "%s%s[", len == 0 ? "" : " ",
+                          utils::dtype_to_str(tensor->dtype())));
+    for (size_t i = 0; i < tensor->ndim(); i++) {
+        advance(std::snprintf(_info.tensors + len, size - len, i == 0 ? "%zu" : ",%zu", tensor->shape()[i]));
+    }
+    advance(std::snprintf(_info.tensors + len, size - len, "]"));
+}
+
+void TraceScope::_begin(const TraceInfo *info) {
+    _described = true;
+    _previous = current_op;
+    current_op = info;
+    if (tracing()) {
+        _traced = info;
+    }
+}
+
+TraceScope::TraceScope(const TraceInfo &recorded)
+    : _op(recorded.op), _traced(nullptr), _previous(nullptr), _described(false), _start(_now()) {
+    if (recorded.op != LLAISYS_OP_COUNT && tracing()) {
+        _traced = &recorded;
+    }
+}
+
+TraceScope::~TraceScope() {
+    const uint64_t end = _now();
+    if (_described) {
+        current_op = _previous;
+    }
+    if (_op != LLAISYS_OP_COUNT) {
+        core::metrics().recordOp(_op, end - _start);
+    }
+    if (_traced != nullptr) {
+        record(*_traced, _start, end);
+    }
+}
+} // namespace llaisys::ops
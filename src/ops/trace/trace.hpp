@@ -0,0 +1,77 @@
+#pragma once
+
+#include "../../tensor/tensor.hpp"
+#include "llaisys/metrics.h"
+
+#include <cstdint>
+#include <string>
+
+namespace llaisys::ops {
+// Op timing and tracing.
+//
+// Every op call is timed into the latency histogram of its op (see core::Metrics).
+// While tracing is on, it is also recorded with its name, the dtypes and shapes of
+// its tensors and the calling thread. Each thread records into a ring buffer of its
+// own, so recording takes no lock; a full ring overwrites its oldest events. A
+// thread's ring is handed to the next new thread once it exits, so there are never
+// more rings than threads recording at once. Launches replayed from an OpGraph are
+// recorded under the op that captured them. dumpTrace() writes the recorded events in the
+// Chrome trace event format (chrome://tracing, Perfetto).
+
+// What a trace event says about an op call.
+struct TraceInfo {
+    llaisysOpType_t op = LLAISYS_OP_COUNT; // LLAISYS_OP_COUNT if not described
+    llaisysDataType_t dtype = LLAISYS_DTYPE_INVALID;
+    char tensors[112] = {};                // e.g. "bfloat16[1,1536] bfloat16[8960,1536]"
+};
+
+const char *opName(llaisysOpType_t op);
+
+void setTracing(bool enabled);
+bool tracing();
+// Drop the events recorded so far.
+void clearTrace();
+// Write the recorded events to `path`; returns how many were written. Events
+// recorded while it runs may be torn, so call it while no op is running.
+size_t dumpTrace(const std::string &path);
+
+// The op being described on the calling thread (null if none), for OpGraph to
+// record along with the launches of the op.
+const TraceInfo *currentOp();
+
+// Times the op call it lives in and, while tracing or capturing, describes it.
+// Ops open one before anything else, with their tensors (which may be null).
+class TraceScope {
+private:
+    TraceInfo _info;
+    llaisysOpType_t _op;
+    const TraceInfo *_traced; // event to record on exit, if tracing
+    const TraceInfo *_previous;
+    bool _described;
+    uint64_t _start;
+
+    // Whether ops need describing: while tracing or capturing.
+    static bool _wanted();
+    static uint64_t _now();
+    void _describe(const tensor_t &tensor);
+    void _begin(const TraceInfo *info);
+
+public:
+    template <typename... Tensors>
+    TraceScope(llaisysOpType_t op, const Tensors &...tensors)
+        : _op(op), _traced(nullptr), _previous(nullptr), _described(false), _start(_now()) {
+        if (!_wanted()) {
+            return;
+        }
+        _info.op = op;
+        (_describe(tensors), ...);
+        _begin(&_info);
+    }
+    // Times a launch replayed from a graph as the op that recorded it.
+    explicit TraceScope(const TraceInfo &recorded);
+    ~TraceScope();
+
+    TraceScope(const TraceScope &) = delete;
+    TraceScope &operator=(const TraceScope &) = delete;
+};
+} // namespace llaisys::ops
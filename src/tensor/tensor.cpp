@@ -36,6 +36,22 @@ tensor_t Tensor::create(const std::vector<size_t> &shape,
     }
 }
 
+tensor_t Tensor::create(const std::vector<size_t> &shape,
+                        llaisysDataType_t dtype,
+                        core::storage_t storage,
+                        size_t offset) {
+    size_t ndim_ = shape.size();
+    std::vector<ptrdiff_t> strides(ndim_);
+    size_t stride = 1;
+    for (size_t i = 1; i <= ndim_; i++) {
+        strides[ndim_ - i] = stride;
+        stride *= shape[ndim_ - i];
+    }
+    CHECK_ARGUMENT(offset + stride * utils::dsize(dtype) <= storage->size(), "Tensor exceeds its storage");
+    TensorMeta meta{dtype, shape, strides};
+    return std::shared_ptr<Tensor>(new Tensor(meta, std::move(storage), offset));
+}
+
 std::byte *Tensor::data() {
     return _storage->memory() + _offset;
 }
@@ -163,6 +179,10 @@ void Tensor::debug() const {
     }
 }
 
+bool Tensor::isExternal() const {
+    return _storage->isExternal();
+}
+
 bool Tensor::isContiguous() const {
     // An empty tensor or scalar is always contiguous
     if (_meta.shape.empty() || numel() == 1) {
@@ -235,6 +255,23 @@ tensor_t Tensor::view(const std::vector<size_t> &new_shape) const {
     return std::shared_ptr<Tensor>(new Tensor(new_meta, _storage, _offset));
 }
 
+tensor_t Tensor::reinterpret(const std::vector<size_t> &new_shape, llaisysDataType_t dtype, size_t offset) const {
+    CHECK_ARGUMENT(this->isContiguous(), "Tensor must be contiguous for reinterpret operation");
+
+    size_t ndim = new_shape.size();
+    std::vector<ptrdiff_t> new_strides(ndim);
+    size_t stride = 1;
+    for (size_t i = 1; i <= ndim; i++) {
+        new_strides[ndim - i] = stride;
+        stride *= new_shape[ndim - i];
+    }
+    CHECK_ARGUMENT(offset + stride * utils::dsize(dtype) <= this->numel() * this->elementSize(),
+                   "Reinterpreted tensor exceeds the original memory");
+
+    TensorMeta new_meta{dtype, new_shape, new_strides};
+    return std::shared_ptr<Tensor>(new Tensor(new_meta, _storage, _offset + offset));
+}
+
 tensor_t Tensor::slice(size_t dim, size_t start, size_t end) const {
     // Validate dimension
     CHECK_ARGUMENT(dim < this->ndim(), "Dimension out of range");
@@ -25,6 +25,12 @@ public:
         llaisysDataType_t dtype,
         llaisysDeviceType_t device_type = LLAISYS_DEVICE_CPU,
         int device = 0);
+    // Contiguous tensor over existing storage, starting `offset` bytes in.
+    static tensor_t create(
+        const std::vector<size_t> &shape,
+        llaisysDataType_t dtype,
+        core::storage_t storage,
+        size_t offset = 0);
     ~Tensor() = default;
     // Info
     std::byte *data();
@@ -42,11 +48,15 @@ public:
     void debug() const;
 
     bool isContiguous() const;
+    // Whether the data lives in memory the runtime did not allocate, e.g. a mapped file.
+    bool isExternal() const;
 
     // Meta Transform
     tensor_t permute(const std::vector<size_t> &order) const;
     tensor_t slice(size_t dim, size_t start, size_t end) const;
     tensor_t view(const std::vector<size_t> &shape) const;
+    // Contiguous tensor of another shape and dtype over this tensor's memory, starting `offset` bytes in.
+    tensor_t reinterpret(const std::vector<size_t> &shape, llaisysDataType_t dtype, size_t offset = 0) const;
 
     // Load data from host memory
     void load(const void *src);
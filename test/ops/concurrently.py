@@ -0,0 +1,36 @@
+import sys
+import os
+
+parent_dir = os.path.abspath(os.path.join(os.path.dirname(__file__), ".."))
+sys.path.insert(0, parent_dir)
+import llaisys
+import threading
+
+
+def check_split(nbranch):
+    total, threads = llaisys.Ops.concurrent_threads(nbranch)
+    if total >= nbranch:
+        # Every branch gets a share of the threads and together they use all of them.
+        assert sum(threads) == total and min(threads) >= 1, (total, threads)
+    return total, threads
+
+
+def test_concurrent_threads(nbranch):
+    print(f"   branches {nbranch}")
+    answer = check_split(nbranch)
+    # Threads other than the first to run branches (scheduler workers, Python threads)
+    # must split the threads the same way.
+    results = []
+    for _ in range(2):
+        thread = threading.Thread(target=lambda: results.append(check_split(nbranch)))
+        thread.start()
+        thread.join()
+    assert results == [answer, answer], (answer, results)
+
+
+if __name__ == "__main__":
+    print("Testing concurrent ops on cpu")
+    for nbranch in [2, 3]:
+        test_concurrent_threads(nbranch)
+
+    print("\033[92mTest passed!\033[0m\n")
@@ -0,0 +1,91 @@
+import sys
+import os
+
+parent_dir = os.path.abspath(os.path.join(os.path.dirname(__file__), ".."))
+sys.path.insert(0, parent_dir)
+import llaisys
+import torch
+from test_utils import random_tensor, check_equal, benchmark, zero_tensor
+
+
+def torch_linear_argmax(max_idx, max_val, x, w, bias):
+    logits = torch.nn.functional.linear(x, w, bias)
+    torch.max(logits, dim=-1, out=(max_val, max_idx))
+    return logits
+
+
+def to_torch(llaisys_tensor, torch_dtype):
+    result = torch.zeros(llaisys_tensor.shape(), dtype=torch_dtype)
+    api = llaisys.RuntimeAPI(llaisys_tensor.device_type())
+    api.memcpy_sync(
+        result.data_ptr(),
+        llaisys_tensor.data_ptr(),
+        result.numel() * result.element_size(),
+        llaisys.MemcpyKind.D2D,
+    )
+    return result
+
+
+def test_op_linear_argmax(
+    x_shape,
+    w_shape,
+    use_bias=True,
+    dtype_name="f32",
+    atol=1e-5,
+    rtol=1e-5,
+    device_name="cpu",
+    profile=False,
+):
+    print(f"   x {x_shape}, w {w_shape}, bias {use_bias}, dtype <{dtype_name}>")
+    x, x_ = random_tensor(x_shape, dtype_name, device_name, scale=0.1)
+    w, w_ = random_tensor(w_shape, dtype_name, device_name, scale=0.01)
+
+    bias, bias_ = None, None
+    if use_bias:
+        bias, bias_ = random_tensor((w_shape[0],), dtype_name, device_name)
+
+    max_idx, max_idx_ = zero_tensor((x_shape[0],), "i64", device_name)
+    max_val, max_val_ = zero_tensor((x_shape[0],), dtype_name, device_name)
+
+    logits = torch_linear_argmax(max_idx, max_val, x, w, bias)
+    llaisys.Ops.linear_argmax(max_idx_, max_val_, x_, w_, bias_)
+
+    assert check_equal(max_val_, max_val, atol=atol, rtol=rtol)
+    # Logits tie, exactly in half precision or up to the summation order otherwise,
+    # and either side may pick any of the tied indices: accept any index whose
+    # reference logit is the maximum.
+    for row, idx in enumerate(to_torch(max_idx_, torch.int64).tolist()):
+        assert torch.allclose(logits[row][idx], max_val[row], atol=atol, rtol=rtol), (row, idx, max_idx[row])
+
+    if profile:
+        benchmark(
+            lambda: torch_linear_argmax(max_idx, max_val, x, w, bias),
+            lambda: llaisys.Ops.linear_argmax(max_idx_, max_val_, x_, w_, bias_),
+            device_name,
+        )
+
+
+if __name__ == "__main__":
+    import argparse
+
+    parser = argparse.ArgumentParser()
+    parser.add_argument("--device", default="cpu", choices=["cpu", "nvidia"], type=str)
+    parser.add_argument("--profile", action="store_true")
+    args = parser.parse_args()
+    testShapes = [
+        ((1, 4), (3, 4), True),
+        ((1, 1536), (32000, 1536), False),
+        ((4, 1536), (4096, 1536), True),
+    ]
+    testDtypePrec = [
+        # type, atol, rtol
+        ("f32", 1e-5, 1e-5),
+        ("f16", 1e-3, 1e-3),
+        ("bf16", 1e-2, 1e-2),
+    ]
+    print(f"Testing Ops.linear_argmax on {args.device}")
+    for shapes in testShapes:
+        for dtype_name, atol, rtol in testDtypePrec:
+            test_op_linear_argmax(*shapes, dtype_name, atol, rtol, args.device, args.profile)
+
+    print("\033[92mTest passed!\033[0m\n")
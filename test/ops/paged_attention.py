@@ -0,0 +1,82 @@
+import sys
+import os
+
+parent_dir = os.path.abspath(os.path.join(os.path.dirname(__file__), ".."))
+sys.path.insert(0, parent_dir)
+import llaisys
+import torch
+from test_utils import random_int_tensor, random_tensor, check_equal, benchmark
+from self_attention import torch_self_attention
+
+
+def torch_paged_attention(attn_val, query, k_blocks, v_blocks, block_table, total_len, scale):
+    key = k_blocks[block_table].flatten(0, 1)[:total_len]
+    value = v_blocks[block_table].flatten(0, 1)[:total_len]
+    torch_self_attention(attn_val, query, key, value, scale)
+
+
+def test_op_paged_attention(
+    qlen,
+    kvlen,
+    nh,
+    nkvh,
+    hd,
+    nblocks,
+    block_size,
+    dtype_name="f32",
+    atol=1e-5,
+    rtol=1e-5,
+    device_name="cpu",
+    profile=False,
+):
+    print(
+        f"   qlen={qlen} kvlen={kvlen} nh={nh} nkvh={nkvh} hd={hd} "
+        f"nblocks={nblocks} block_size={block_size} dtype <{dtype_name}>"
+    )
+    ntable = (kvlen + block_size - 1) // block_size
+    q, q_ = random_tensor((qlen, nh, hd), dtype_name, device_name)
+    k, k_ = random_tensor((nblocks, block_size, nkvh, hd), dtype_name, device_name)
+    v, v_ = random_tensor((nblocks, block_size, nkvh, hd), dtype_name, device_name)
+    table, table_ = random_int_tensor((ntable,), device_name, high=nblocks)
+    scale = 1.0 / (hd**0.5)
+
+    attn_val, attn_val_ = random_tensor((qlen, nh, hd), dtype_name, device_name)
+    torch_paged_attention(attn_val, q, k, v, table, kvlen, scale)
+    llaisys.Ops.paged_attention(attn_val_, q_, k_, v_, table_, kvlen, scale)
+    assert check_equal(attn_val_, attn_val, atol=atol, rtol=rtol)
+
+    if profile:
+        benchmark(
+            lambda: torch_paged_attention(attn_val, q, k, v, table, kvlen, scale),
+            lambda: llaisys.Ops.paged_attention(attn_val_, q_, k_, v_, table_, kvlen, scale),
+            device_name,
+        )
+
+
+if __name__ == "__main__":
+    import argparse
+
+    parser = argparse.ArgumentParser()
+    parser.add_argument("--device", default="cpu", choices=["cpu", "nvidia"], type=str)
+    parser.add_argument("--profile", action="store_true")
+    args = parser.parse_args()
+    testShapes = [
+        # qlen, kvlen, nh, nkvh, hd, nblocks, block_size
+        (2, 2, 1, 1, 4, 1, 2),
+        (5, 11, 4, 2, 8, 6, 4),
+        (1, 37, 12, 2, 128, 8, 16),
+    ]
+    testDtypePrec = [
+        # type, atol, rtol
+        ("f32", 1e-5, 1e-5),
+        ("f16", 1e-3, 1e-3),
+        ("bf16", 1e-2, 1e-2),
+    ]
+    print(f"Testing Ops.paged_attention on {args.device}")
+    for shape in testShapes:
+        for dtype_name, atol, rtol in testDtypePrec:
+            test_op_paged_attention(
+                *shape, dtype_name, atol, rtol, args.device, args.profile
+            )
+
+    print("\033[92mTest passed!\033[0m\n")
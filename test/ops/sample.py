@@ -0,0 +1,79 @@
+import sys
+import os
+
+parent_dir = os.path.abspath(os.path.join(os.path.dirname(__file__), ".."))
+sys.path.insert(0, parent_dir)
+import llaisys
+import torch
+from test_utils import random_tensor, check_equal, benchmark, zero_tensor
+
+
+def torch_sample(out_idx, logits, temperature, top_k, top_p, random_val):
+    logits = logits.float()
+    if top_k == 1 or temperature <= 0:
+        out_idx[0] = torch.argmax(logits)
+        return
+    k = logits.numel() if top_k <= 0 else min(top_k, logits.numel())
+    # Stable sort so ties are broken by index, like the llaisys kernel.
+    values, indices = torch.sort(logits, descending=True, stable=True)
+    values, indices = values[:k], indices[:k]
+    probs = torch.softmax(values / temperature, dim=-1)
+    n = k
+    if top_p < 1.0:
+        cum = torch.cumsum(probs, dim=-1)
+        n = int(torch.searchsorted(cum, torch.tensor(top_p)).item()) + 1
+        n = min(n, k)
+    probs = probs[:n]
+    cdf = torch.cumsum(probs, dim=-1)
+    pick = int(torch.searchsorted(cdf, random_val * cdf[-1], right=True).item())
+    out_idx[0] = indices[min(pick, n - 1)]
+
+
+def test_op_sample(
+    shape,
+    temperature,
+    top_k,
+    top_p,
+    random_val,
+    dtype_name="f32",
+    device_name="cpu",
+    profile=False,
+):
+    print(f"   shape {shape} T={temperature} top_k={top_k} top_p={top_p} u={random_val} dtype <{dtype_name}>")
+    logits, logits_ = random_tensor(shape, dtype_name, device_name, scale=10.0)
+    out_idx, out_idx_ = zero_tensor((1,), "i64", device_name)
+
+    torch_sample(out_idx, logits, temperature, top_k, top_p, random_val)
+    llaisys.Ops.sample(out_idx_, logits_, temperature, top_k, top_p, random_val)
+
+    assert check_equal(out_idx_, out_idx, strict=True)
+
+    if profile:
+        benchmark(
+            lambda: torch_sample(out_idx, logits, temperature, top_k, top_p, random_val),
+            lambda: llaisys.Ops.sample(out_idx_, logits_, temperature, top_k, top_p, random_val),
+            device_name,
+        )
+
+
+if __name__ == "__main__":
+    import argparse
+
+    parser = argparse.ArgumentParser()
+    parser.add_argument("--device", default="cpu", choices=["cpu", "nvidia"], type=str)
+    parser.add_argument("--profile", action="store_true")
+    args = parser.parse_args()
+    testCases = [
+        # shape, temperature, top_k, top_p, random_val
+        ((16,), 1.0, 1, 1.0, 0.5),
+        ((4096,), 0.8, 50, 1.0, 0.3),
+        ((4096,), 1.0, 0, 0.8, 0.9),
+        ((151936,), 0.7, 20, 0.9, 0.1),
+    ]
+    testDtype = ["f32", "f16", "bf16"]
+    print(f"Testing Ops.sample on {args.device}")
+    for case in testCases:
+        for dtype_name in testDtype:
+            test_op_sample(*case, dtype_name, args.device, args.profile)
+
+    print("\033[92mTest passed!\033[0m\n")
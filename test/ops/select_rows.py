@@ -0,0 +1,68 @@
+import sys
+import os
+
+parent_dir = os.path.abspath(os.path.join(os.path.dirname(__file__), ".."))
+sys.path.insert(0, parent_dir)
+import llaisys
+from test_utils import random_int_tensor, random_tensor, check_equal, benchmark
+
+
+def torch_select_rows(out, inp, idx):
+    out[:] = inp[idx]
+
+
+def test_op_select_rows(
+    idx_shape,
+    in_shape,
+    col_slice=None,
+    dtype_name="f32",
+    device_name="cpu",
+    profile=False,
+):
+    print(f"   idx_shape {idx_shape} in_shape {in_shape} col_slice {col_slice} dtype <{dtype_name}>")
+    inp, inp_ = random_tensor(in_shape, dtype_name, device_name)
+    if col_slice is not None:
+        # Row-strided input: every row is dense but rows are further apart.
+        inp = inp[:, col_slice[0] : col_slice[1]]
+        inp_ = inp_.slice(1, col_slice[0], col_slice[1])
+    idx, idx_ = random_int_tensor(idx_shape, device_name, high=in_shape[0])
+    out, out_ = random_tensor((idx_shape[0], inp.shape[1]), dtype_name, device_name)
+    torch_select_rows(out, inp, idx)
+    llaisys.Ops.select_rows(out_, inp_, idx_)
+
+    assert check_equal(out_, out, strict=True)
+
+    if profile:
+        benchmark(
+            lambda: torch_select_rows(out, inp, idx),
+            lambda: llaisys.Ops.select_rows(out_, inp_, idx_),
+            device_name,
+        )
+
+
+if __name__ == "__main__":
+    import argparse
+
+    parser = argparse.ArgumentParser()
+    parser.add_argument("--device", default="cpu", choices=["cpu", "nvidia"], type=str)
+    parser.add_argument("--profile", action="store_true")
+    args = parser.parse_args()
+    testShapes = [
+        ((1,), (2, 3), None),
+        ((4,), (2048, 1536), None),
+        ((3,), (16, 64), (8, 40)),
+    ]
+    testDtype = [
+        # type
+        "f32",
+        "f16",
+        "bf16",
+    ]
+    print(f"Testing Ops.select_rows on {args.device}")
+    for idx_shape, in_shape, col_slice in testShapes:
+        for dtype_name in testDtype:
+            test_op_select_rows(
+                idx_shape, in_shape, col_slice, dtype_name, args.device, args.profile
+            )
+
+    print("\033[92mTest passed!\033[0m\n")
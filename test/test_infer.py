@@ -54,9 +54,13 @@ def hf_infer(
     return outputs[0].tolist(), result
 
 
-def load_llaisys_model(model_path, device_name):
-    model = llaisys.models.Qwen2(model_path, llaisys_device(device_name))
-    return model
+def load_llaisys_model(model_path, device_name, image=None):
+    if image is None:
+        return llaisys.models.Qwen2(model_path, llaisys_device(device_name))
+    # Convert the checkpoint to a model image once, then always start from the image.
+    if not os.path.exists(image):
+        llaisys.models.Qwen2(model_path, llaisys_device(device_name)).save_image(image)
+    return llaisys.models.Qwen2(image, llaisys_device(device_name))
 
 
 def llaisys_infer(
@@ -89,6 +93,9 @@ if __name__ == "__main__":
     parser.add_argument("--top_k", default=50, type=int)
     parser.add_argument("--temperature", default=1.0, type=float)
     parser.add_argument("--test", action="store_true")
+    parser.add_argument("--image", default=None, type=str, help="model image to load from, created if missing")
+    parser.add_argument("--no-op-capture", action="store_true", help="run every decode step op by op")
+    parser.add_argument("--trace", default=None, type=str, help="write a Chrome trace of the llaisys ops to this file")
 
     args = parser.parse_args()
 
@@ -122,7 +129,11 @@ if __name__ == "__main__":
     print("\n")
     print(f"Time elapsed: {(end_time - start_time):.2f}s\n")
 
-    model = load_llaisys_model(model_path, args.device)
+    model = load_llaisys_model(model_path, args.device, args.image)
+    model.set_op_capture(not args.no_op_capture)
+    llaisys.reset_metrics()
+    if args.trace:
+        llaisys.Ops.set_tracing(True)
     start_time = time.time()
     llaisys_tokens, llaisys_output = llaisys_infer(
         args.prompt,
@@ -135,6 +146,9 @@ if __name__ == "__main__":
     )
 
     end_time = time.time()
+    if args.trace:
+        llaisys.Ops.set_tracing(False)
+        print(f"Traced {llaisys.Ops.dump_trace(args.trace)} op calls to {args.trace}")
 
     print("\n=== Your Result ===\n")
     print("Tokens:")
@@ -142,7 +156,12 @@ if __name__ == "__main__":
     print("\nContents:")
     print(llaisys_output)
     print("\n")
-    print(f"Time elapsed: {(end_time - start_time):.2f}s\n")
+    print(f"Time elapsed: {(end_time - start_time):.2f}s")
+    metrics = llaisys.metrics()
+    print(
+        f"Prefill: {metrics['prefill_tokens_per_second']:.1f} tokens/s, "
+        f"decode: {metrics['decode_tokens_per_second']:.1f} tokens/s\n"
+    )
 
     if args.test:
         assert llaisys_tokens == tokens
@@ -0,0 +1,83 @@
+import llaisys
+from test_utils import *
+import argparse
+import random
+
+
+ALIGNMENT = 256
+
+
+def check_plan(planner, buffers):
+    """`buffers` holds (id, first, last) of every requested buffer."""
+    for i, (a, a_first, a_last) in enumerate(buffers):
+        assert planner.offset(a) % ALIGNMENT == 0
+        assert planner.offset(a) + planner.bytes(a) <= planner.arena_bytes()
+        for b, b_first, b_last in buffers[i + 1 :]:
+            if a_first <= b_last and b_first <= a_last:
+                # Live at the same time: the byte ranges must be disjoint.
+                assert (
+                    planner.offset(a) + planner.bytes(a) <= planner.offset(b)
+                    or planner.offset(b) + planner.bytes(b) <= planner.offset(a)
+                )
+    assert planner.arena_bytes() <= planner.total_bytes()
+    assert planner.total_bytes() == sum(planner.bytes(id) for id, _, _ in buffers)
+
+
+def test_disjoint_lifetimes(device_name: str = "cpu"):
+    print("===Test buffers that are never live together===")
+    planner = llaisys.models.MemoryPlanner()
+    buffers = []
+    for step, numel in enumerate([100, 700, 64, 1000, 3]):
+        buffers.append((planner.request([numel], llaisys.DataType.F32, step, step), step, step))
+    planner.plan(llaisys_device(device_name))
+    check_plan(planner, buffers)
+    # All buffers reuse the memory of the largest one.
+    assert planner.arena_bytes() == max(planner.bytes(id) for id, _, _ in buffers)
+    print("     Passed")
+
+
+def test_overlapping_lifetimes(device_name: str = "cpu"):
+    print("===Test buffers that are all live together===")
+    planner = llaisys.models.MemoryPlanner()
+    buffers = []
+    for numel in [100, 700, 64, 1000, 3]:
+        buffers.append((planner.request([numel, 2], llaisys.DataType.BF16, 0, 4), 0, 4))
+    planner.plan(llaisys_device(device_name))
+    check_plan(planner, buffers)
+    assert planner.arena_bytes() == planner.total_bytes()
+    print("     Passed")
+
+
+def test_random_lifetimes(device_name: str = "cpu"):
+    print("===Test random buffer lifetimes===")
+    rng = random.Random(0)
+    dtypes = [llaisys.DataType.F32, llaisys.DataType.BF16, llaisys.DataType.I64]
+    for _ in range(20):
+        planner = llaisys.models.MemoryPlanner()
+        buffers = []
+        nstep = rng.randint(1, 30)
+        for _ in range(rng.randint(1, 40)):
+            first = rng.randrange(nstep)
+            last = rng.randint(first, min(nstep - 1, first + rng.randint(0, 5)))
+            shape = [rng.randint(1, 64), rng.randint(1, 300)]
+            buffers.append((planner.request(shape, rng.choice(dtypes), first, last), first, last))
+        planner.plan(llaisys_device(device_name))
+        check_plan(planner, buffers)
+        # No placement can be smaller than the buffers live at the busiest step.
+        peak = max(
+            sum(planner.bytes(id) for id, first, last in buffers if first <= step <= last)
+            for step in range(nstep)
+        )
+        assert planner.arena_bytes() >= peak
+    print("     Passed")
+
+
+if __name__ == "__main__":
+    parser = argparse.ArgumentParser()
+    parser.add_argument("--device", default="cpu", choices=["cpu", "nvidia"], type=str)
+    args = parser.parse_args()
+    test_disjoint_lifetimes(args.device)
+    test_overlapping_lifetimes(args.device)
+    test_random_lifetimes(args.device)
+
+    print("\033[92mTest passed!\033[0m\n")
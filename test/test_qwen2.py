@@ -0,0 +1,396 @@
+import llaisys
+from llaisys.libllaisys import LIB_LLAISYS
+import torch
+from test_utils import *
+import argparse
+import ctypes
+import os
+import subprocess
+import sys
+import tempfile
+from transformers import Qwen2Config, Qwen2ForCausalLM
+
+
+PROMPT = [3, 141, 59, 26, 53, 58, 97, 93, 23, 84, 62, 64, 33, 83, 27, 95, 2, 88, 41]
+END_TOKEN = 255
+
+
+def create_tiny_model(path, dtype_name="f32"):
+    """Save a randomly initialised two-layer Qwen2 checkpoint to `path` and return it."""
+    torch.manual_seed(0)
+    config = Qwen2Config(
+        vocab_size=256,
+        hidden_size=64,
+        intermediate_size=128,
+        num_hidden_layers=2,
+        num_attention_heads=4,
+        num_key_value_heads=2,
+        max_position_embeddings=256,
+        rms_norm_eps=1e-6,
+        rope_theta=10000.0,
+        tie_word_embeddings=False,
+        eos_token_id=END_TOKEN,
+    )
+    model = Qwen2ForCausalLM(config)
+    # The default initialisation gives almost uniform logits; spread them so that the
+    # greedy choices are well separated. Biases are random too, norm weights stay near 1.
+    with torch.no_grad():
+        for name, param in model.named_parameters():
+            param.normal_(1.0 if "norm" in name else 0.0, 0.1)
+    model = model.to(torch_dtype(dtype_name)).eval()
+    model.save_pretrained(path)
+    return model
+
+
+def hf_next(model, tokens):
+    """Greedy next token and float logits of the last position, without a KV cache."""
+    with torch.no_grad():
+        logits = model(torch.tensor([tokens])).logits[0, -1].float()
+    return int(logits.argmax()), logits
+
+
+def hf_generate(model, tokens, max_new_tokens):
+    tokens = list(tokens)
+    for _ in range(max_new_tokens):
+        token, _ = hf_next(model, tokens)
+        tokens.append(token)
+        if token == END_TOKEN:
+            break
+    return tokens
+
+
+def check_logits(logits, answer, atol=1e-4, rtol=1e-4):
+    return torch.allclose(torch.tensor(logits, dtype=torch.float32), answer, atol=atol, rtol=rtol)
+
+
+def test_reference(device_name: str = "cpu"):
+    print("===Test Qwen2 against the reference===")
+    with tempfile.TemporaryDirectory() as path:
+        hf_model = create_tiny_model(path)
+        model = llaisys.models.Qwen2(path, llaisys_device(device_name))
+
+        # Prefill, then decode steps reading the KV cache
+        sequence = model.sequence()
+        tokens, inputs = list(PROMPT), PROMPT
+        for _ in range(8):
+            token, logits = sequence.infer(inputs, return_logits=True)
+            answer, answer_logits = hf_next(hf_model, tokens)
+            assert token == answer
+            assert check_logits(logits, answer_logits)
+            tokens.append(token)
+            inputs = [token]
+        del sequence
+
+        # Native generate loop
+        assert model.generate(PROMPT, max_new_tokens=16, top_k=1) == hf_generate(hf_model, PROMPT, 16)
+        del model
+    print("     Passed")
+
+
+def test_prefill_chunk(device_name: str = "cpu"):
+    print("===Test chunked prefill===")
+    for dtype_name in ["f32", "bf16"]:
+        with tempfile.TemporaryDirectory() as path:
+            create_tiny_model(path, dtype_name)
+            model = llaisys.models.Qwen2(path, llaisys_device(device_name))
+            # The default chunk holds the whole prompt.
+            sequence = model.sequence()
+            answer, answer_logits = sequence.infer(PROMPT, return_logits=True)
+            del sequence
+            answer_tokens = model.generate(PROMPT, max_new_tokens=8, top_k=1)
+
+            for chunk in [1, 3, 8, len(PROMPT) - 1, len(PROMPT), len(PROMPT) + 5]:
+                model.set_prefill_chunk(chunk)
+                sequence = model.sequence()
+                token, logits = sequence.infer(PROMPT, return_logits=True)
+                del sequence
+                assert token == answer
+                assert check_logits(logits, torch.tensor(answer_logits), atol=1e-5, rtol=1e-5)
+                assert model.generate(PROMPT, max_new_tokens=8, top_k=1) == answer_tokens
+            del model
+    print("     Passed")
+
+
+def weight_bytes(model):
+    """Name -> (dtype, shape, raw bytes) of every weight of a CPU model."""
+    sizes = {llaisys.DataType.F32: 4, llaisys.DataType.F16: 2, llaisys.DataType.BF16: 2}
+    weights = model._weights
+    handles = {name: getattr(weights, name) for name in ["in_embed", "out_embed", "out_norm_w"]}
+    for name, _ in type(weights)._fields_[3:]:
+        for layer in range(model._meta.nlayer):
+            handles[f"{name}.{layer}"] = getattr(weights, name)[layer]
+
+    result = {}
+    for name, handle in handles.items():
+        shape = (ctypes.c_size_t * LIB_LLAISYS.tensorGetNdim(handle))()
+        LIB_LLAISYS.tensorGetShape(handle, shape)
+        dtype = llaisys.DataType(LIB_LLAISYS.tensorGetDataType(handle))
+        nbytes = sizes[dtype]
+        for d in shape:
+            nbytes *= d
+        data = ctypes.string_at(LIB_LLAISYS.tensorGetData(handle), nbytes)
+        result[name] = (dtype, list(shape), data)
+    return result
+
+
+def test_image(device_name: str = "cpu"):
+    print("===Test model image round trip===")
+    for dtype_name in ["f32", "bf16"]:
+        with tempfile.TemporaryDirectory() as path:
+            create_tiny_model(path, dtype_name)
+            model = llaisys.models.Qwen2(path, llaisys_device(device_name), max_seq_len=128)
+            answer = model.generate(PROMPT, max_new_tokens=8, top_k=1)
+            image = os.path.join(path, "model.llsimg")
+            model.save_image(image)
+
+            loaded = llaisys.models.Qwen2(image, llaisys_device(device_name))
+            for name, _ in type(model._meta)._fields_:
+                assert getattr(loaded._meta, name) == getattr(model._meta, name), name
+            if device_name == "cpu":
+                assert weight_bytes(loaded) == weight_bytes(model)
+            assert loaded.generate(PROMPT, max_new_tokens=8, top_k=1) == answer
+            del loaded
+
+            # The stored max_seq_len only bounds that of models loaded from the image.
+            loaded = llaisys.models.Qwen2(image, llaisys_device(device_name), max_seq_len=64)
+            assert loaded._meta.maxseq == 64
+            del loaded
+            del model
+    print("     Passed")
+
+
+def test_weight_residency(device_name: str = "cpu"):
+    print("===Test weight residency===")
+    if device_name != "cpu":
+        print("     Skipped")
+        return
+    with tempfile.TemporaryDirectory() as path:
+        create_tiny_model(path)
+        model = llaisys.models.Qwen2(path, llaisys_device(device_name))
+        answer = model.generate(PROMPT, max_new_tokens=8, top_k=1)
+        layer_bytes = sum(len(data) for name, (_, _, data) in weight_bytes(model).items() if name[-2:] in (".0", ".1"))
+
+        # The checkpoint packs the weights, so layers share pages; those are counted once at most.
+        model.set_weight_residency(1 << 40, 0)
+        everything = model.resident_weight_bytes()
+        assert 0 < everything <= layer_bytes
+        for prefetch in [0, 1]:
+            model.set_weight_residency(1, prefetch)
+            assert model.generate(PROMPT, max_new_tokens=8, top_k=1) == answer
+            if prefetch == 0:
+                assert model.resident_weight_bytes() < everything
+        del model
+
+        # Locked weights cannot be dropped.
+        code = (
+            f"import llaisys; model = llaisys.models.Qwen2({path!r}, lock_weights=True); "
+            "model.set_weight_residency(1, 0)"
+        )
+        result = subprocess.run([sys.executable, "-c", code], capture_output=True, text=True)
+        assert result.returncode != 0 and "weight residency needs weights that are not locked" in result.stderr
+    print("     Passed")
+
+
+def test_op_capture(device_name: str = "cpu"):
+    print("===Test decode op capture===")
+    with tempfile.TemporaryDirectory() as path:
+        create_tiny_model(path)
+        model = llaisys.models.Qwen2(path, llaisys_device(device_name))
+
+        def decode():
+            greedy = model.generate(PROMPT, max_new_tokens=12, top_k=1)
+            sampled = model.generate(PROMPT, max_new_tokens=12, top_k=8, temperature=1.0, seed=3)
+            return greedy, sampled
+
+        # Each reconfiguration replaces the buffers a recorded decode step points into.
+        reconfigure = [
+            ("default", lambda: None),
+            ("prefill chunk", lambda: model.set_prefill_chunk(3)),
+            ("kv cache", lambda: LIB_LLAISYS.llaisysQwen2ModelConfigureKVCache(model._model, 4, 256)),
+            ("prefill chunk", lambda: model.set_prefill_chunk(64)),
+        ]
+        for name, apply in reconfigure:
+            model.set_op_capture(True)
+            # Record a decode step before reconfiguring, then replay what is recorded after.
+            model.generate(PROMPT, max_new_tokens=4, top_k=1)
+            assert model.captured_ops() > 0
+            apply()
+            captured = decode()
+            assert model.captured_ops() > 0
+            model.set_op_capture(False)
+            assert decode() == captured, name
+            assert model.captured_ops() == 0
+        del model
+    print("     Passed")
+
+
+def test_op_concurrency(device_name: str = "cpu"):
+    print("===Test concurrent projections===")
+    for dtype_name in ["f32", "bf16"]:
+        with tempfile.TemporaryDirectory() as path:
+            create_tiny_model(path, dtype_name)
+            # Chunks of at most 16 rows run their independent projections side by side.
+            model = llaisys.models.Qwen2(path, llaisys_device(device_name), prefill_chunk=8)
+            results = []
+            for concurrency in [True, False]:
+                model.set_op_concurrency(concurrency)
+                sequence = model.sequence()
+                token, logits = sequence.infer(PROMPT, return_logits=True)
+                del sequence
+                tokens = model.generate(PROMPT, max_new_tokens=12, top_k=1)
+                results.append((token, logits, tokens))
+            (token, logits, tokens), (answer, answer_logits, answer_tokens) = results
+            assert token == answer and tokens == answer_tokens
+            assert check_logits(logits, torch.tensor(answer_logits), atol=1e-5, rtol=1e-5)
+            del model
+    print("     Passed")
+
+
+def test_fork(device_name: str = "cpu"):
+    print("===Test sequence fork===")
+    with tempfile.TemporaryDirectory() as path:
+        create_tiny_model(path)
+        # 4-token blocks: the prompt ends in a partly filled block.
+        model = llaisys.models.Qwen2(
+            path, llaisys_device(device_name), kv_cache_tokens=256, kv_block_size=4
+        )
+
+        def reference(tokens):
+            sequence = model.sequence()
+            result = sequence.infer(tokens, return_logits=True)
+            del sequence
+            return result
+
+        parent = model.sequence()
+        parent.infer(PROMPT)
+        used = model.kv_blocks_used()
+        assert used == (len(PROMPT) + 3) // 4
+
+        # The fork shares all blocks of the parent.
+        child = parent.fork()
+        assert len(child) == len(PROMPT) and model.kv_blocks_used() == used
+
+        # Writing into the shared tail copies it for the writer only; afterwards the
+        # other sequence owns its tail and writes in place.
+        child_tokens, parent_tokens = PROMPT + [7], PROMPT + [11]
+        child_token, child_logits = child.infer([7], return_logits=True)
+        assert model.kv_blocks_used() == used + 1
+        parent_token, parent_logits = parent.infer([11], return_logits=True)
+        assert model.kv_blocks_used() == used + 1
+
+        # Both continue as if they had never been forked.
+        for _ in range(6):
+            answer, answer_logits = reference(child_tokens)
+            assert child_token == answer
+            assert check_logits(child_logits, torch.tensor(answer_logits), atol=1e-5, rtol=1e-5)
+            answer, answer_logits = reference(parent_tokens)
+            assert parent_token == answer
+            assert check_logits(parent_logits, torch.tensor(answer_logits), atol=1e-5, rtol=1e-5)
+            child_tokens.append(child_token)
+            parent_tokens.append(parent_token)
+            child_token, child_logits = child.infer([child_token], return_logits=True)
+            parent_token, parent_logits = parent.infer([parent_token], return_logits=True)
+
+        # Freeing one sequence keeps the blocks still used by the other.
+        blocks = (len(parent) + 3) // 4
+        shared = len(PROMPT) // 4
+        assert model.kv_blocks_used() == 2 * blocks - shared
+        del child
+        assert model.kv_blocks_used() == blocks
+        del parent
+        assert model.kv_blocks_used() == 0
+        del model
+    print("     Passed")
+
+
+def test_scheduler(device_name: str = "cpu"):
+    print("===Test continuous batching===")
+    # Prompts longer than the prefill chunk, more requests than batch slots
+    prompts = [PROMPT, PROMPT[:5], PROMPT[3:15], [7], PROMPT[::-1], PROMPT[8:]]
+    with tempfile.TemporaryDirectory() as path:
+        create_tiny_model(path)
+        model = llaisys.models.Qwen2(
+            path, llaisys_device(device_name), prefill_chunk=16, kv_cache_tokens=1024
+        )
+        answers = [model.generate(prompt, max_new_tokens=12, top_k=1) for prompt in prompts]
+
+        scheduler = llaisys.models.Qwen2Scheduler(model, max_batch_seqs=4)
+        ids = [scheduler.submit(prompt, max_new_tokens=12) for prompt in prompts]
+        for prompt, request_id, answer in zip(prompts, ids, answers):
+            assert prompt + list(scheduler.stream(request_id)) == answer
+        assert scheduler.pending() == 0
+        del scheduler
+        del model
+    print("     Passed")
+
+
+def test_scheduler_preemption(device_name: str = "cpu"):
+    print("===Test scheduler preemption===")
+    prompts = [PROMPT, PROMPT[:7], PROMPT[4:16], PROMPT[::-1]]
+    with tempfile.TemporaryDirectory() as path:
+        create_tiny_model(path)
+        # 16 blocks of 4 tokens: each request fits alone, but not all of them at once.
+        model = llaisys.models.Qwen2(
+            path, llaisys_device(device_name), kv_cache_tokens=64, kv_block_size=4
+        )
+        answers = [model.generate(prompt, max_new_tokens=20, top_k=1) for prompt in prompts]
+
+        for mode in [llaisys.models.Qwen2PreemptionMode.RECOMPUTE, llaisys.models.Qwen2PreemptionMode.SWAP]:
+            scheduler = llaisys.models.Qwen2Scheduler(model, max_batch_seqs=4)
+            scheduler.set_preemption_mode(mode)
+            ids = [scheduler.submit(prompt, max_new_tokens=20) for prompt in prompts]
+            for prompt, request_id, answer in zip(prompts, ids, answers):
+                assert prompt + list(scheduler.stream(request_id)) == answer
+
+            stats = scheduler.stats()
+            assert stats["preemptions"] > 0
+            if mode == llaisys.models.Qwen2PreemptionMode.SWAP:
+                assert stats["swap_outs"] > 0
+            else:
+                assert stats["recomputed_tokens"] > 0
+            del scheduler
+        del model
+    print("     Passed")
+
+
+def test_scheduler_cancel(device_name: str = "cpu"):
+    print("===Test cancelling queued requests===")
+    with tempfile.TemporaryDirectory() as path:
+        create_tiny_model(path)
+        model = llaisys.models.Qwen2(path, llaisys_device(device_name))
+        answer = model.generate(PROMPT[:5], max_new_tokens=4, top_k=1)
+
+        # One batch slot: `queued` waits behind `later`, which has a higher priority.
+        scheduler = llaisys.models.Qwen2Scheduler(model, max_batch_seqs=1)
+        running = scheduler.submit(PROMPT, priority=2)
+        later = scheduler.submit(PROMPT[:5], max_new_tokens=4, priority=1)
+        queued = scheduler.submit(PROMPT[:9])
+        # A cancelled request is retired at once, not when it reaches the front.
+        scheduler.cancel(queued)
+        assert scheduler.poll(queued) == ([], llaisys.models.Qwen2RequestStatus.FINISHED)
+
+        scheduler.cancel(running)
+        list(scheduler.stream(running))
+        assert PROMPT[:5] + list(scheduler.stream(later)) == answer
+        assert scheduler.pending() == 0
+        del scheduler
+        del model
+    print("     Passed")
+
+
+if __name__ == "__main__":
+    parser = argparse.ArgumentParser()
+    parser.add_argument("--device", default="cpu", choices=["cpu", "nvidia"], type=str)
+    args = parser.parse_args()
+    test_reference(args.device)
+    test_prefill_chunk(args.device)
+    test_image(args.device)
+    test_weight_residency(args.device)
+    test_op_capture(args.device)
+    test_op_concurrency(args.device)
+    test_fork(args.device)
+    test_scheduler(args.device)
+    test_scheduler_preemption(args.device)
+    test_scheduler_cancel(args.device)
+
+    print("\033[92mTest passed!\033[0m\n")
@@ -2,6 +2,11 @@ import llaisys
 import torch
 from test_utils import *
 import argparse
+import ctypes
+import json
+import os
+import tempfile
+import threading
 
 
 def test_basic_runtime_api(device_name: str = "cpu"):
@@ -18,6 +23,8 @@ def test_basic_runtime_api(device_name: str = "cpu"):
         print("Testing device {i}...")
         api.set_device(i)
         test_memcpy(api, 1024 * 1024)
+        test_memcpy_async(api, 1024 * 1024)
+        test_events(api, 1024 * 1024)
 
         print("     Passed")
 
@@ -53,10 +60,230 @@ def test_memcpy(api, size_bytes: int):
     torch.testing.assert_close(a, b)
 
 
+def test_memcpy_async(api, size_bytes: int):
+    a = torch.arange(size_bytes, dtype=torch.int64).to(torch.uint8)
+    b = torch.zeros_like(a)
+    device_a = api.malloc_device(size_bytes)
+    stream = api.create_stream()
+
+    # Copies on one stream run in order.
+    api.memcpy_async(device_a, a.data_ptr(), size_bytes, llaisys.MemcpyKind.H2D, stream)
+    api.memcpy_async(b.data_ptr(), device_a, size_bytes, llaisys.MemcpyKind.D2H, stream)
+    api.stream_synchronize(stream)
+    torch.testing.assert_close(a, b)
+
+    api.destroy_stream(stream)
+    api.free_device(device_a)
+
+
+def test_events(api, size_bytes: int):
+    a = torch.arange(size_bytes, dtype=torch.int64).to(torch.uint8)
+    b = torch.zeros_like(a)
+    device_a = api.malloc_device(size_bytes)
+    copy_in = api.create_stream()
+    copy_out = api.create_stream()
+    start = api.create_event()
+    ready = api.create_event()
+
+    # copy_out only reads device_a once copy_in has written it.
+    api.event_record(start, copy_in)
+    api.memcpy_async(device_a, a.data_ptr(), size_bytes, llaisys.MemcpyKind.H2D, copy_in)
+    api.event_record(ready, copy_in)
+    api.stream_wait_event(copy_out, ready)
+    api.memcpy_async(b.data_ptr(), device_a, size_bytes, llaisys.MemcpyKind.D2H, copy_out)
+    api.stream_synchronize(copy_out)
+    torch.testing.assert_close(a, b)
+
+    api.event_synchronize(ready)
+    assert api.event_elapsed_time(start, ready) >= 0.0
+
+    api.destroy_event(ready)
+    api.destroy_event(start)
+    api.destroy_stream(copy_out)
+    api.destroy_stream(copy_in)
+    api.free_device(device_a)
+
+
+def test_caching_allocator(device_name: str = "cpu"):
+    print("===Test caching allocator===")
+    shape = (256, 1024)
+    torch_tensor = torch.arange(shape[0] * shape[1], dtype=torch.float32).reshape(shape)
+
+    tensor = llaisys.Tensor(shape, dtype=llaisys.DataType.F32, device=llaisys_device(device_name))
+    ptr = tensor.data_ptr()
+    del tensor
+    # Freed memory is reused by the next allocation of the same size.
+    tensor = llaisys.Tensor(shape, dtype=llaisys.DataType.F32, device=llaisys_device(device_name))
+    assert tensor.data_ptr() == ptr
+    tensor.load(torch_tensor.data_ptr())
+    assert check_equal(tensor, torch_tensor)
+
+    # Small tensors are carved out of shared segments without overlapping.
+    small = [
+        llaisys.Tensor((i + 1, 7), dtype=llaisys.DataType.F32, device=llaisys_device(device_name))
+        for i in range(16)
+    ]
+    for i, t in enumerate(small):
+        t.load(torch_tensor[: i + 1, :7].contiguous().data_ptr())
+    for i, t in enumerate(small):
+        assert check_equal(t, torch_tensor[: i + 1, :7])
+    del small, tensor
+    llaisys.empty_cache()
+    print("     Passed")
+
+
+def test_shared_runtime(device_name: str = "cpu"):
+    print("===Test shared runtime===")
+    llaisys.set_shared_runtime(True)
+    shape = (512, 1024)
+    ptrs = []
+
+    def work():
+        tensor = llaisys.Tensor(shape, dtype=llaisys.DataType.F32, device=llaisys_device(device_name))
+        ptrs.append(tensor.data_ptr())
+        del tensor
+
+    # Memory freed by one thread is reused by the next one.
+    for _ in range(2):
+        thread = threading.Thread(target=work)
+        thread.start()
+        thread.join()
+    assert ptrs[0] == ptrs[1]
+
+    # A tensor created on one thread outlives it and is freed on another.
+    tensors = []
+    thread = threading.Thread(
+        target=lambda: tensors.append(
+            llaisys.Tensor(shape, dtype=llaisys.DataType.F32, device=llaisys_device(device_name))
+        )
+    )
+    thread.start()
+    thread.join()
+    del tensors
+
+    llaisys.set_shared_runtime(False)
+    print("     Passed")
+
+
+def test_memory_stats(device_name: str = "cpu"):
+    print("===Test memory stats===")
+    api = llaisys.RuntimeAPI(llaisys_device(device_name))
+    before = api.memory_stats()["categories"]["activations"]
+
+    llaisys.set_memory_category(llaisys.MemoryCategory.ACTIVATIONS)
+    tensor = llaisys.Tensor((1024, 16), dtype=llaisys.DataType.F32, device=llaisys_device(device_name))
+    llaisys.set_memory_category(llaisys.MemoryCategory.OTHER)
+
+    during = api.memory_stats()["categories"]["activations"]
+    assert during["live_bytes"] == before["live_bytes"] + 1024 * 16 * 4
+    assert during["allocations"] == before["allocations"] + 1
+    assert during["peak_bytes"] >= during["live_bytes"]
+
+    del tensor
+    after = api.memory_stats()["categories"]["activations"]
+    assert after["live_bytes"] == before["live_bytes"]
+    assert after["frees"] == before["frees"] + 1
+    print("     Passed")
+
+
+def test_cpu_memory_config():
+    print("===Test CPU memory config===")
+    defaults = llaisys.libllaisys.LlaisysCpuMemoryConfig()
+    llaisys.libllaisys.LIB_LLAISYS.llaisysGetCpuMemoryConfig(ctypes.byref(defaults))
+    assert defaults.huge_pages == 1 and defaults.huge_page_threshold == 2 << 20
+    assert defaults.lock == 0 and defaults.numa_policy == llaisys.CpuNumaPolicy.DEFAULT
+
+    try:
+        for huge_pages in (True, False):
+            llaisys.set_cpu_memory_config(huge_pages=huge_pages, huge_page_threshold=1 << 20)
+            config = llaisys.libllaisys.LlaisysCpuMemoryConfig()
+            llaisys.libllaisys.LIB_LLAISYS.llaisysGetCpuMemoryConfig(ctypes.byref(config))
+            assert config.huge_pages == int(huge_pages) and config.huge_page_threshold == 1 << 20
+            assert config.lock == defaults.lock and config.numa_policy == defaults.numa_policy
+
+            # Below and above the threshold.
+            for shape in [(3,), (17, 5), (1 << 18,), (3 << 18,)]:
+                tensor = llaisys.Tensor(shape, dtype=llaisys.DataType.F32, device=llaisys.DeviceType.CPU)
+                assert tensor.data_ptr() % 64 == 0, (huge_pages, shape)
+    finally:
+        llaisys.libllaisys.LIB_LLAISYS.llaisysSetCpuMemoryConfig(ctypes.byref(defaults))
+    print("     Passed")
+
+
+def test_op_trace(device_name: str = "cpu"):
+    print("===Test op trace===")
+    shape = (4, 256)
+    _, a = random_tensor(shape, "f32", device_name)
+    _, b = random_tensor(shape, "f32", device_name)
+    _, c = random_tensor(shape, "f32", device_name)
+
+    llaisys.Ops.clear_trace()
+    llaisys.Ops.add(c, a, b)  # not traced
+    llaisys.Ops.set_tracing(True)
+    for _ in range(3):
+        llaisys.Ops.add(c, a, b)
+    llaisys.Ops.set_tracing(False)
+
+    with tempfile.TemporaryDirectory() as tmp:
+        path = os.path.join(tmp, "trace.json")
+        assert llaisys.Ops.dump_trace(path) == 3
+        with open(path) as f:
+            events = json.load(f)["traceEvents"]
+    assert len(events) == 3
+    for event in events:
+        assert event["name"] == "add" and event["ph"] == "X" and event["dur"] >= 0
+        assert event["args"]["dtype"] == "float32"
+        assert event["args"]["tensors"] == "float32[4,256] float32[4,256] float32[4,256]"
+    llaisys.Ops.clear_trace()
+
+    # Threads that exit hand their buffer on instead of adding one each.
+    llaisys.Ops.set_tracing(True)
+    for _ in range(20):
+        thread = threading.Thread(target=llaisys.Ops.add, args=(c, a, b))
+        thread.start()
+        thread.join()
+    llaisys.Ops.set_tracing(False)
+
+    with tempfile.TemporaryDirectory() as tmp:
+        path = os.path.join(tmp, "trace.json")
+        assert llaisys.Ops.dump_trace(path) == 20
+        with open(path) as f:
+            events = json.load(f)["traceEvents"]
+    assert len(events) == 20
+    assert len({event["tid"] for event in events}) == 1
+    llaisys.Ops.clear_trace()
+    print("     Passed")
+
+
+def test_metrics(device_name: str = "cpu"):
+    print("===Test metrics===")
+    shape = (4, 256)
+    _, a = random_tensor(shape, "f32", device_name)
+    _, b = random_tensor(shape, "f32", device_name)
+    _, c = random_tensor(shape, "f32", device_name)
+
+    llaisys.reset_metrics()
+    assert llaisys.metrics()["ops"]["add"]["count"] == 0
+    for _ in range(5):
+        llaisys.Ops.add(c, a, b)
+    add = llaisys.metrics()["ops"]["add"]
+    assert add["count"] == 5 and sum(add["buckets"]) == 5 and add["sum_seconds"] > 0
+    assert len(add["buckets"]) == len(llaisys.LATENCY_BUCKET_BOUNDS)
+    assert llaisys.metrics()["ops"]["linear"]["count"] == 0
+    llaisys.reset_metrics()
+    print("     Passed")
+
+
 if __name__ == "__main__":
     parser = argparse.ArgumentParser()
     parser.add_argument("--device", default="cpu", choices=["cpu", "nvidia"], type=str)
     args = parser.parse_args()
     test_basic_runtime_api(args.device)
+    test_caching_allocator(args.device)
+    test_memory_stats(args.device)
+    test_cpu_memory_config()
+    test_shared_runtime(args.device)
+    test_op_trace(args.device)
+    test_metrics(args.device)
     
     print("\033[92mTest passed!\033[0m\n")
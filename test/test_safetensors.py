@@ -0,0 +1,99 @@
+import llaisys
+from test_utils import *
+from test_qwen2 import create_tiny_model, PROMPT
+import argparse
+import json
+import os
+import shutil
+import struct
+import subprocess
+import sys
+import tempfile
+
+
+def write_safetensors(path, header, data=b"", header_size=None):
+    """Write `header` (a dict, or raw bytes for malformed headers) followed by `data`."""
+    raw = header if isinstance(header, bytes) else json.dumps(header).encode()
+    size = len(raw) if header_size is None else header_size
+    with open(path, "wb") as f:
+        f.write(struct.pack("<Q", size) + raw + data)
+
+
+def load_error(path, device_name):
+    """Load the model at `path` in a child process, since library errors abort the
+    process; return the error message, or None if it loaded."""
+    code = f"import llaisys; llaisys.models.Qwen2({str(path)!r}, llaisys.DeviceType.{device_name.upper()})"
+    result = subprocess.run([sys.executable, "-c", code], capture_output=True, text=True)
+    return None if result.returncode == 0 else result.stderr
+
+
+def checkpoint_with(base, path, header, data=b"", header_size=None):
+    """A copy of the checkpoint `base` with one extra file holding `header`."""
+    shutil.copytree(base, path)
+    write_safetensors(os.path.join(path, "extra.safetensors"), header, data, header_size)
+    return path
+
+
+NORM = "model.norm.weight"  # 64 values used by the model
+
+
+def test_malformed_headers(device_name: str = "cpu"):
+    print("===Test malformed safetensors headers===")
+    norm = {"dtype": "F32", "shape": [64], "data_offsets": [0, 256]}
+    cases = [
+        ("not json", b"garbage", b"", None, "malformed header"),
+        ("truncated", json.dumps({NORM: norm}).encode()[:-5], bytes(256), None, "malformed header"),
+        ("header past the end", {NORM: norm}, b"", 1 << 20, "header exceeds file"),
+        ("no offsets", {NORM: {"dtype": "F32", "shape": [64]}}, bytes(256), None, "incomplete tensor entry"),
+        ("no dtype", {NORM: {"shape": [64], "data_offsets": [0, 256]}}, bytes(256), None, "incomplete tensor entry"),
+        ("data past the end", {NORM: norm}, bytes(128), None, "tensor data exceeds file"),
+        ("size and shape disagree", {NORM: dict(norm, shape=[32])}, bytes(256), None, "does not match shape"),
+    ]
+    with tempfile.TemporaryDirectory() as root:
+        base = os.path.join(root, "base")
+        create_tiny_model(base)
+        for i, (case, header, data, header_size, message) in enumerate(cases):
+            path = checkpoint_with(base, os.path.join(root, str(i)), header, data, header_size)
+            error = load_error(path, device_name)
+            assert error is not None and message in error, case
+    print("     Passed")
+
+
+def test_dtypes(device_name: str = "cpu"):
+    print("===Test safetensors dtypes===")
+    with tempfile.TemporaryDirectory() as root:
+        base = os.path.join(root, "base")
+        create_tiny_model(base)
+        model = llaisys.models.Qwen2(base, llaisys_device(device_name))
+        answer = model.generate(PROMPT, max_new_tokens=8, top_k=1)
+        del model
+
+        # Tensors the model does not use may have any dtype, known to LLAISYS or not.
+        unused = {
+            "__metadata__": {"format": "pt"},
+            "mask": {"dtype": "BOOL", "shape": [4], "data_offsets": [0, 4]},
+            "codes": {"dtype": "U8", "shape": [2, 2], "data_offsets": [4, 8]},
+            "scales": {"dtype": "F8_E4M3", "shape": [8], "data_offsets": [8, 16]},
+            "packed": {"dtype": "I4", "shape": [16], "data_offsets": [16, 24]},
+        }
+        path = checkpoint_with(base, os.path.join(root, "unused"), unused, bytes(24))
+        model = llaisys.models.Qwen2(path, llaisys_device(device_name))
+        assert model.generate(PROMPT, max_new_tokens=8, top_k=1) == answer
+        del model
+
+        # A weight in an unsupported dtype fails, naming the tensor.
+        header = {NORM: {"dtype": "F8_E4M3", "shape": [64], "data_offsets": [0, 64]}}
+        path = checkpoint_with(base, os.path.join(root, "used"), header, bytes(64))
+        error = load_error(path, device_name)
+        assert error is not None and "unsupported dtype F8_E4M3 of " + NORM in error
+    print("     Passed")
+
+
+if __name__ == "__main__":
+    parser = argparse.ArgumentParser()
+    parser.add_argument("--device", default="cpu", choices=["cpu", "nvidia"], type=str)
+    args = parser.parse_args()
+    test_malformed_headers(args.device)
+    test_dtypes(args.device)
+
+    print("\033[92mTest passed!\033[0m\n")
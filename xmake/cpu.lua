@@ -6,6 +6,12 @@ target("llaisys-device-cpu")
         add_cxflags("-fPIC", "-Wno-unknown-pragmas")
     end
 
+    if is_plat("windows") then
+        add_cxflags("/openmp")
+    else
+        add_cxflags("-fopenmp")
+    end
+
     add_files("../src/device/cpu/*.cpp")
 
     on_install(function (target) end)
@@ -20,6 +26,12 @@ target("llaisys-ops-cpu")
         add_cxflags("-fPIC", "-Wno-unknown-pragmas")
     end
 
+    if is_plat("windows") then
+        add_cxflags("/openmp")
+    else
+        add_cxflags("-fopenmp")
+    end
+
     add_files("../src/ops/*/cpu/*.cpp")
 
     on_install(function (target) end)